@@ -8,6 +8,9 @@
 #include <ranges>
 #include <algorithm>
 
+#include "distinct_aggregate.hpp"
+#include "merge_view.hpp"
+
 using namespace std::literals;
 
 int runtime_func(int x)
@@ -106,21 +109,49 @@ constexpr auto avg_for_unique(const TRng_&... rng)
 {
     using TElement = std::common_type_t<std::ranges::range_value_t<TRng_>...>;
 
-    std::vector<TElement> vec;                            // empty vector
-    vec.reserve((rng.size() + ...));                      // reserve a buffer - fold expression C++17
-    (vec.insert(vec.end(), rng.begin(), rng.end()), ...); // fold expression C++17
+    // sorted inputs - unique items of a lazy merge, nothing is copied or sorted
+    if constexpr ((std::ranges::forward_range<const TRng_> && ...))
+    {
+        if ((std::ranges::is_sorted(rng) && ...))
+        {
+            TElement sum{};
+            std::size_t count = 0;
+            for (const auto& item : Views::merge_unique(rng...))
+            {
+                sum += item;
+                ++count;
+            }
+
+            return sum / static_cast<double>(count);
+        }
+    }
 
-    // sort items
-    std::ranges::sort(vec); // std::sort(vec.begin(), vec.end());
+    // unsorted inputs - the distinct items in a hash set, nothing is copied or sorted
+    if constexpr (requires { typename Aggregates::ExactDistinct<TElement>; })
+    {
+        Aggregates::ExactDistinct<TElement> distinct;
+        (distinct.push_range(rng), ...); // fold expression C++17
 
-    // create span of unique_items
-    auto new_end = std::unique(vec.begin(), vec.end());
-    std::span unique_items{vec.begin(), new_end};
+        return distinct.mean();
+    }
+    else // other element types (e.g. long double) - copied, sorted & made unique
+    {
+        std::vector<TElement> vec;                            // empty vector
+        vec.reserve((rng.size() + ...));                      // reserve a buffer - fold expression C++17
+        (vec.insert(vec.end(), rng.begin(), rng.end()), ...); // fold expression C++17
 
-    // calculate sum of unique items
-    auto sum = std::accumulate(unique_items.begin(), unique_items.end(), TElement{});
+        // sort items
+        std::ranges::sort(vec); // std::sort(vec.begin(), vec.end());
 
-    return sum / static_cast<double>(unique_items.size());
+        // create span of unique_items
+        auto new_end = std::unique(vec.begin(), vec.end());
+        std::span unique_items{vec.begin(), new_end};
+
+        // calculate sum of unique items
+        auto sum = std::accumulate(unique_items.begin(), unique_items.end(), TElement{});
+
+        return sum / static_cast<double>(unique_items.size());
+    }
 }
 
 struct Base
@@ -171,9 +202,16 @@ TEST_CASE("avg for unique")
     constexpr std::array lst2 = {5, 6, 7, 8, 9};
 
     constexpr auto avg = avg_for_unique(lst1, lst2);
+    static_assert(avg == 5.0);
 
     std::cout << "AVG: " << avg << "\n";
 
+    constexpr std::array unsorted = {9, 1, 1, 4};
+    static_assert(avg_for_unique(unsorted, lst1) == avg_for_unique(std::array{1, 2, 3, 4, 5, 9}));
+
+    constexpr std::array<long double, 4> unsorted_reals = {9.0L, 1.0L, 1.0L, 4.0L};
+    static_assert(avg_for_unique(unsorted_reals, std::array{2.0L, 4.0L}) == 4.0L);
+
     constexpr auto result = with_dynamic_cast();
     static_assert(result == "Derived only"sv);
 }
@@ -0,0 +1,237 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "channel.hpp"
+#include "task_resumer.hpp"
+
+using Coro::Channel;
+
+TEST_CASE("channel - try_send & try_receive")
+{
+    Channel<int> ch{3};
+    REQUIRE(ch.capacity() == 4);
+
+    for (int i = 1; i <= 4; ++i)
+        CHECK(ch.try_send(i));
+    CHECK_FALSE(ch.try_send(5)); // full
+
+    for (int i = 1; i <= 4; ++i)
+        CHECK(ch.try_receive() == i); // FIFO
+    CHECK(ch.try_receive() == std::nullopt); // empty
+}
+
+TEST_CASE("channel - move-only items")
+{
+    Channel<std::unique_ptr<int>> ch{2};
+
+    auto ptr = std::make_unique<int>(42);
+    REQUIRE(ch.try_send(std::move(ptr)));
+    CHECK(ptr == nullptr);
+
+    auto full_ptr = std::make_unique<int>(665);
+    ch.try_send(std::make_unique<int>(1));
+    CHECK_FALSE(ch.try_send(std::move(full_ptr)));
+    CHECK(full_ptr != nullptr); // not moved when the channel is full
+
+    CHECK(*ch.try_receive().value() == 42);
+}
+
+namespace
+{
+    TaskResumer producer(Channel<int>& ch, int count)
+    {
+        for (int i = 1; i <= count; ++i)
+            co_await ch.send(i);
+    }
+
+    TaskResumer consumer(Channel<int>& ch, int count, std::vector<int>& received)
+    {
+        for (int i = 0; i < count; ++i)
+            received.push_back(co_await ch.receive());
+    }
+} // namespace
+
+TEST_CASE("channel - coroutines are parked when full or empty")
+{
+    Channel<int> ch{4};
+    std::vector<int> received;
+
+    SECTION("consumer starts first")
+    {
+        TaskResumer c = consumer(ch, 100, received);
+        TaskResumer p = producer(ch, 100);
+
+        CHECK(c.resume()); // parked on empty channel - resumed by the producer
+        CHECK(received.empty());
+
+        p.resume();
+    }
+
+    SECTION("producer starts first")
+    {
+        TaskResumer p = producer(ch, 100);
+        TaskResumer c = consumer(ch, 100, received);
+
+        CHECK(p.resume()); // parked on full channel - resumed by the consumer
+
+        c.resume();
+    }
+
+    std::vector<int> expected(100);
+    std::iota(expected.begin(), expected.end(), 1);
+    CHECK(received == expected);
+}
+
+TEST_CASE("channel - try_* callers wake parked coroutines")
+{
+    Channel<int> ch{2};
+    std::vector<int> received;
+
+    TaskResumer c = consumer(ch, 3, received);
+    c.resume();
+
+    for (int i = 1; i <= 3; ++i)
+        CHECK(ch.try_send(i * 10));
+
+    CHECK(received == std::vector{10, 20, 30});
+}
+
+namespace
+{
+    // spins on the lock-free path - returns sum of received items
+    long long run_mpmc(Channel<int>& ch, int producers, int consumers, int items_per_producer)
+    {
+        std::atomic<int> remaining{producers * items_per_producer};
+        std::atomic<long long> sum{0};
+
+        {
+            std::vector<std::jthread> threads;
+
+            for (int p = 0; p < producers; ++p)
+                threads.emplace_back([&] {
+                    for (int i = 1; i <= items_per_producer; ++i)
+                        while (!ch.try_send(i))
+                            std::this_thread::yield();
+                });
+
+            for (int c = 0; c < consumers; ++c)
+                threads.emplace_back([&] {
+                    long long local_sum = 0;
+                    while (remaining.load(std::memory_order_relaxed) > 0)
+                    {
+                        if (auto item = ch.try_receive())
+                        {
+                            local_sum += *item;
+                            remaining.fetch_sub(1, std::memory_order_relaxed);
+                        }
+                        else
+                            std::this_thread::yield();
+                    }
+                    sum += local_sum;
+                });
+        }
+
+        return sum;
+    }
+
+    long long expected_sum(int producers, int items_per_producer)
+    {
+        return producers * (static_cast<long long>(items_per_producer) * (items_per_producer + 1) / 2);
+    }
+} // namespace
+
+TEST_CASE("channel - MPMC with many threads")
+{
+    Channel<int> ch{64};
+
+    CHECK(run_mpmc(ch, 4, 4, 10'000) == expected_sum(4, 10'000));
+    CHECK(ch.try_receive() == std::nullopt);
+}
+
+TEST_CASE("channel - coroutines resumed across threads")
+{
+    Channel<int> ch{8};
+    std::vector<int> received;
+
+    TaskResumer c = consumer(ch, 10'000, received);
+    c.resume();
+
+    {
+        std::jthread producer_thread{[&] {
+            for (int i = 1; i <= 10'000; ++i)
+                while (!ch.try_send(i))
+                    std::this_thread::yield();
+        }};
+    }
+
+    REQUIRE(received.size() == 10'000);
+    CHECK(std::ranges::is_sorted(received));
+}
+
+TEST_CASE("channel - benchmarks", "[.][benchmark]")
+{
+    constexpr int items = 1'000'000;
+
+    Channel<int> ch{1024};
+
+    BENCHMARK("throughput 1:1")
+    {
+        return run_mpmc(ch, 1, 1, items);
+    };
+
+    BENCHMARK("throughput 4:1")
+    {
+        return run_mpmc(ch, 4, 1, items / 4);
+    };
+
+    BENCHMARK("throughput 4:4")
+    {
+        return run_mpmc(ch, 4, 4, items / 4);
+    };
+
+    BENCHMARK("coroutines 1:1 (single thread)")
+    {
+        std::vector<int> received;
+        received.reserve(items);
+
+        TaskResumer c = consumer(ch, items, received);
+        TaskResumer p = producer(ch, items);
+        c.resume();
+        p.resume();
+
+        return received.size();
+    };
+
+    Channel<int> pong{1};
+
+    BENCHMARK("latency - ping-pong round trip")
+    {
+        constexpr int round_trips = 10'000;
+
+        std::jthread echo{[&] {
+            for (int i = 0; i < round_trips; ++i)
+            {
+                std::optional<int> item;
+                while (!(item = ch.try_receive()))
+                    std::this_thread::yield();
+                while (!pong.try_send(*item))
+                    std::this_thread::yield();
+            }
+        }};
+
+        for (int i = 0; i < round_trips; ++i)
+        {
+            while (!ch.try_send(i))
+                std::this_thread::yield();
+            while (!pong.try_receive())
+                std::this_thread::yield();
+        }
+
+        return round_trips;
+    };
+}
@@ -0,0 +1,353 @@
+#ifndef CHANNEL_HPP
+#define CHANNEL_HPP
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace Coro
+{
+    inline constexpr std::size_t cache_line_size = 64;
+
+    // Bounded MPMC channel - Vyukov's sequence-numbered ring buffer
+    //  * try_send() / try_receive() - lock-free, never block, usable from any thread
+    //  * co_await send(v) / co_await receive() - park the coroutine when the channel is full/empty
+    //
+    // A parked coroutine is resumed by the thread that made progress possible (the one that freed
+    // a slot or delivered an item), so a coroutine may continue on a different thread than it started.
+    template <typename T>
+    class Channel
+    {
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            alignas(T) std::byte storage[sizeof(T)];
+
+            T* item() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        template <typename TWaiter>
+        struct WaitQueue // intrusive FIFO - nodes live in the frames of suspended coroutines
+        {
+            TWaiter* head = nullptr;
+            TWaiter* tail = nullptr;
+
+            bool empty() const noexcept { return head == nullptr; }
+
+            void push_back(TWaiter* waiter) noexcept
+            {
+                waiter->next_ = nullptr;
+                if (tail)
+                    tail->next_ = waiter;
+                else
+                    head = waiter;
+                tail = waiter;
+            }
+
+            void push_front(TWaiter* waiter) noexcept
+            {
+                waiter->next_ = head;
+                head = waiter;
+                if (!tail)
+                    tail = waiter;
+            }
+
+            TWaiter* pop_front() noexcept
+            {
+                TWaiter* waiter = head;
+                if (waiter)
+                {
+                    head = waiter->next_;
+                    if (!head)
+                        tail = nullptr;
+                }
+                return waiter;
+            }
+        };
+
+    public:
+        class SendAwaiter
+        {
+        public:
+            SendAwaiter(Channel& channel, T value)
+                : channel_{channel}
+                , value_{std::move(value)}
+            { }
+
+            bool await_ready() { return channel_.try_send(std::move(value_)); }
+
+            bool await_suspend(std::coroutine_handle<> coro_hndl)
+            {
+                coro_hndl_ = coro_hndl;
+                return channel_.park_sender(this);
+            }
+
+            void await_resume() const noexcept { }
+
+        private:
+            friend class Channel;
+
+            Channel& channel_;
+            T value_;
+            std::coroutine_handle<> coro_hndl_;
+            SendAwaiter* next_ = nullptr;
+            friend struct WaitQueue<SendAwaiter>;
+        };
+
+        class ReceiveAwaiter
+        {
+        public:
+            explicit ReceiveAwaiter(Channel& channel)
+                : channel_{channel}
+            { }
+
+            bool await_ready()
+            {
+                result_ = channel_.try_receive();
+                return result_.has_value();
+            }
+
+            bool await_suspend(std::coroutine_handle<> coro_hndl)
+            {
+                coro_hndl_ = coro_hndl;
+                return channel_.park_receiver(this);
+            }
+
+            T await_resume()
+            {
+                assert(result_.has_value());
+                return std::move(*result_);
+            }
+
+        private:
+            friend class Channel;
+
+            Channel& channel_;
+            std::optional<T> result_;
+            std::coroutine_handle<> coro_hndl_;
+            ReceiveAwaiter* next_ = nullptr;
+            friend struct WaitQueue<ReceiveAwaiter>;
+        };
+
+        // capacity is rounded up to the next power of two
+        explicit Channel(std::size_t capacity)
+            : mask_{std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1}
+            , cells_{std::make_unique<Cell[]>(mask_ + 1)}
+        {
+            for (std::size_t i = 0; i <= mask_; ++i)
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        Channel(const Channel&) = delete;
+        Channel& operator=(const Channel&) = delete;
+
+        ~Channel()
+        {
+            assert(senders_.empty() && receivers_.empty());
+
+            while (pop())
+                ;
+        }
+
+        std::size_t capacity() const noexcept { return mask_ + 1; }
+
+        // returns false (and leaves value untouched) when the channel is full
+        template <typename U>
+            requires std::constructible_from<T, U&&>
+        bool try_send(U&& value)
+        {
+            if (!push(std::forward<U>(value)))
+                return false;
+
+            wake_receiver();
+            return true;
+        }
+
+        std::optional<T> try_receive()
+        {
+            std::optional<T> result = pop();
+
+            if (result)
+                wake_sender();
+
+            return result;
+        }
+
+        [[nodiscard]] SendAwaiter send(T value) { return SendAwaiter{*this, std::move(value)}; }
+
+        [[nodiscard]] ReceiveAwaiter receive() { return ReceiveAwaiter{*this}; }
+
+    private:
+        template <typename U>
+        bool push(U&& value)
+        {
+            std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                Cell& cell = cells_[pos & mask_];
+                std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+                if (diff == 0)
+                {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        std::construct_at(cell.item(), std::forward<U>(value));
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false; // full
+                else
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::optional<T> pop()
+        {
+            std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                Cell& cell = cells_[pos & mask_];
+                std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+                if (diff == 0)
+                {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        std::optional<T> result{std::move(*cell.item())};
+                        std::destroy_at(cell.item());
+                        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                        return result;
+                    }
+                }
+                else if (diff < 0)
+                    return std::nullopt; // empty
+                else
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Parking protocol (Dekker-style): a waiter announces itself in waiting_* before its last attempt
+        // and the other side publishes its item/slot before checking waiting_* - with seq_cst fences on
+        // both sides at least one of them observes the other, so no wake-up is lost.
+
+        bool park_sender(SendAwaiter* waiter)
+        {
+            waiting_senders_.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            std::unique_lock lk{waiters_mtx_};
+
+            if (push(std::move(waiter->value_)))
+            {
+                waiting_senders_.fetch_sub(1, std::memory_order_relaxed);
+                lk.unlock();
+                wake_receiver();
+                return false;
+            }
+
+            senders_.push_back(waiter);
+            return true;
+        }
+
+        bool park_receiver(ReceiveAwaiter* waiter)
+        {
+            waiting_receivers_.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            std::unique_lock lk{waiters_mtx_};
+
+            if (auto item = pop())
+            {
+                waiting_receivers_.fetch_sub(1, std::memory_order_relaxed);
+                lk.unlock();
+                waiter->result_ = std::move(item);
+                wake_sender();
+                return false;
+            }
+
+            receivers_.push_back(waiter);
+            return true;
+        }
+
+        // called after a slot was freed - completes the send of the oldest parked sender
+        void wake_sender()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting_senders_.load(std::memory_order_relaxed) == 0)
+                return;
+
+            std::unique_lock lk{waiters_mtx_};
+
+            SendAwaiter* waiter = senders_.pop_front();
+            if (!waiter)
+                return;
+
+            if (!push(std::move(waiter->value_)))
+            {
+                senders_.push_front(waiter); // slot was taken by another producer - its consumer will retry
+                return;
+            }
+
+            waiting_senders_.fetch_sub(1, std::memory_order_relaxed);
+            lk.unlock();
+
+            wake_receiver();
+            waiter->coro_hndl_.resume();
+        }
+
+        // called after an item was published - hands it over to the oldest parked receiver
+        void wake_receiver()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting_receivers_.load(std::memory_order_relaxed) == 0)
+                return;
+
+            std::unique_lock lk{waiters_mtx_};
+
+            ReceiveAwaiter* waiter = receivers_.pop_front();
+            if (!waiter)
+                return;
+
+            waiter->result_ = pop();
+            if (!waiter->result_)
+            {
+                receivers_.push_front(waiter); // item was taken by another consumer
+                return;
+            }
+
+            waiting_receivers_.fetch_sub(1, std::memory_order_relaxed);
+            lk.unlock();
+
+            wake_sender();
+            waiter->coro_hndl_.resume();
+        }
+
+        const std::size_t mask_;
+        std::unique_ptr<Cell[]> cells_;
+
+        alignas(cache_line_size) std::atomic<std::size_t> enqueue_pos_{0};
+        alignas(cache_line_size) std::atomic<std::size_t> dequeue_pos_{0};
+
+        alignas(cache_line_size) std::atomic<std::size_t> waiting_senders_{0};
+        std::atomic<std::size_t> waiting_receivers_{0};
+        std::mutex waiters_mtx_;
+        WaitQueue<SendAwaiter> senders_;
+        WaitQueue<ReceiveAwaiter> receivers_;
+    };
+} // namespace Coro
+
+#endif
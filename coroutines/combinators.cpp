@@ -0,0 +1,273 @@
+#include <catch2/catch_test_macros.hpp>
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "combinators.hpp"
+#include "task.hpp"
+#include "task_resumer.hpp"
+
+using namespace std::literals;
+using Coro::Task;
+
+namespace
+{
+    // single-threaded ready queue - enough to interleave tasks in tests
+    class ManualLoop
+    {
+    public:
+        auto yield()
+        {
+            struct YieldAwaiter
+            {
+                ManualLoop& loop;
+
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> coro_hndl) { loop.ready_.push_back(coro_hndl); }
+                void await_resume() const noexcept { }
+            };
+
+            return YieldAwaiter{*this};
+        }
+
+        void run()
+        {
+            while (!ready_.empty())
+            {
+                auto coro_hndl = ready_.front();
+                ready_.pop_front();
+                coro_hndl.resume();
+            }
+        }
+
+    private:
+        std::deque<std::coroutine_handle<>> ready_;
+    };
+
+    template <typename T>
+    auto run_on(ManualLoop& loop, Task<T> task, std::stop_token token = {})
+    {
+        task.promise().set_stop_token(std::move(token));
+
+        auto driver = [](Task<T>& task) -> TaskResumer { co_await task.when_ready(); };
+        TaskResumer main_task = driver(task);
+        main_task.resume();
+        loop.run();
+
+        REQUIRE(task.is_ready());
+        return task.take_result();
+    }
+
+    Task<int> answer()
+    {
+        co_return 42;
+    }
+
+    Task<int> twice(Task<int> task)
+    {
+        co_return 2 * co_await std::move(task);
+    }
+
+    Task<void> fail()
+    {
+        throw std::runtime_error("fail");
+        co_return;
+    }
+
+    // counts its own steps - checks for cancellation before each of them
+    Task<int> worker(ManualLoop& loop, int steps, int& steps_done)
+    {
+        for (int i = 0; i < steps; ++i)
+        {
+            co_await Coro::cancellation_point();
+            ++steps_done;
+            co_await loop.yield();
+        }
+        co_return steps;
+    }
+
+    Task<void> failing_worker(ManualLoop& loop, int steps)
+    {
+        for (int i = 0; i < steps; ++i)
+            co_await loop.yield();
+        throw std::runtime_error("worker failed");
+    }
+} // namespace
+
+TEST_CASE("task - sync_wait")
+{
+    CHECK(Coro::sync_wait(answer()) == 42);
+    CHECK(Coro::sync_wait(twice(twice(answer()))) == 168);
+    CHECK_THROWS_AS(Coro::sync_wait(fail()), std::runtime_error);
+
+    SECTION("completed on another thread - notified before the waiter returns")
+    {
+        std::vector<std::jthread> threads;
+
+        struct ResumeOnNewThread
+        {
+            std::vector<std::jthread>& threads;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> coro_hndl) { threads.emplace_back([coro_hndl] { coro_hndl.resume(); }); }
+            void await_resume() const noexcept { }
+        };
+
+        auto resumed_elsewhere = [&]() -> Task<int> {
+            co_await ResumeOnNewThread{threads};
+            co_return 7;
+        };
+
+        for (int i = 0; i < 200; ++i)
+            CHECK(Coro::sync_wait(resumed_elsewhere()) == 7);
+    }
+}
+
+TEST_CASE("when_all - tasks with different result types")
+{
+    auto text = []() -> Task<std::string> { co_return "text"s; };
+
+    auto parent = [&]() -> Task<bool> {
+        auto [number, nothing, str] = co_await Coro::when_all(answer(), []() -> Task<void> { co_return; }(), text());
+        static_assert(std::is_same_v<decltype(nothing), std::monostate>);
+        co_return number == 42 && str == "text";
+    };
+
+    CHECK(Coro::sync_wait(parent()));
+}
+
+TEST_CASE("when_all - range of interleaved tasks")
+{
+    ManualLoop loop;
+    std::vector<int> steps_done(5);
+
+    auto parent = [&]() -> Task<std::vector<int>> {
+        std::vector<Task<int>> tasks;
+        for (int i = 0; i < 5; ++i)
+            tasks.push_back(worker(loop, i + 1, steps_done[i]));
+
+        co_return co_await Coro::when_all(std::move(tasks));
+    };
+
+    CHECK(run_on(loop, parent()) == std::vector{1, 2, 3, 4, 5});
+    CHECK(steps_done == std::vector{1, 2, 3, 4, 5});
+}
+
+TEST_CASE("when_all - first failure cancels siblings")
+{
+    ManualLoop loop;
+    int steps_done = 0;
+
+    auto parent = [&]() -> Task<void> {
+        co_await Coro::when_all(worker(loop, 1'000, steps_done), failing_worker(loop, 3));
+    };
+
+    CHECK_THROWS_AS(run_on(loop, parent()), std::runtime_error);
+    CHECK(steps_done <= 4);
+}
+
+TEST_CASE("when_any - losers are cancelled promptly")
+{
+    ManualLoop loop;
+    std::vector<int> steps_done(3);
+
+    auto parent = [&]() -> Task<Coro::WhenAnyResult<int>> {
+        co_return co_await Coro::when_any(worker(loop, 100, steps_done[0]), worker(loop, 5, steps_done[1]), worker(loop, 1'000, steps_done[2]));
+    };
+
+    auto [index, value] = run_on(loop, parent());
+
+    CHECK(index == 1);
+    CHECK(value == 5);
+    CHECK(steps_done[0] <= 6);
+    CHECK(steps_done[2] <= 6);
+}
+
+TEST_CASE("when_any - failures do not win")
+{
+    ManualLoop loop;
+    int steps_done = 0;
+
+    auto parent = [&]() -> Task<std::size_t> {
+        std::vector<Task<int>> tasks;
+        tasks.push_back([](ManualLoop& loop) -> Task<int> { co_await failing_worker(loop, 1); co_return 0; }(loop));
+        tasks.push_back(worker(loop, 10, steps_done));
+
+        auto result = co_await Coro::when_any(std::move(tasks));
+        co_return result.index;
+    };
+
+    CHECK(run_on(loop, parent()) == 1);
+    CHECK(steps_done == 10);
+}
+
+TEST_CASE("stop requested for the parent propagates into children")
+{
+    ManualLoop loop;
+    std::stop_source stop_source;
+    std::vector<int> steps_done(2);
+
+    auto requester = [&]() -> Task<int> {
+        for (int i = 0; i < 3; ++i)
+            co_await loop.yield();
+        stop_source.request_stop();
+        co_return 0;
+    };
+
+    auto parent = [&]() -> Task<void> {
+        auto token = co_await Coro::get_stop_token();
+        REQUIRE(token.stop_possible());
+
+        co_await Coro::when_all(worker(loop, 1'000, steps_done[0]), worker(loop, 1'000, steps_done[1]), requester());
+    };
+
+    CHECK_THROWS_AS(run_on(loop, parent(), stop_source.get_token()), Coro::OperationCancelled);
+    CHECK(steps_done[0] <= 4);
+    CHECK(steps_done[1] <= 4);
+}
+
+TEST_CASE("when_all - children completed on other threads")
+{
+    std::mutex mtx;
+    std::vector<std::jthread> threads;
+
+    auto resume_on_new_thread = [&] {
+        struct NewThreadAwaiter
+        {
+            std::mutex& mtx;
+            std::vector<std::jthread>& threads;
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> coro_hndl)
+            {
+                std::lock_guard lk{mtx};
+                threads.emplace_back([coro_hndl] { coro_hndl.resume(); });
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+        return NewThreadAwaiter{mtx, threads};
+    };
+
+    auto child = [&](int id) -> Task<int> {
+        co_await resume_on_new_thread();
+        co_return id * id;
+    };
+
+    auto parent = [&]() -> Task<int> {
+        std::vector<Task<int>> tasks;
+        for (int i = 1; i <= 8; ++i)
+            tasks.push_back(child(i));
+
+        auto results = co_await Coro::when_all(std::move(tasks));
+        co_return std::accumulate(results.begin(), results.end(), 0);
+    };
+
+    CHECK(Coro::sync_wait(parent()) == 204);
+}
@@ -0,0 +1,284 @@
+#ifndef COMBINATORS_HPP
+#define COMBINATORS_HPP
+
+#include <cassert>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "task.hpp"
+
+// Structured concurrency for Task<T>:
+//  * when_all(tasks...) / when_all(range_of_tasks) - waits for all children, the first failure requests stop for the rest
+//  * when_any(tasks...) / when_any(range_of_tasks) - the first successful child wins, the losers get a stop request
+// Children get a stop token linked with the token of the awaiting Task. No coroutine frames are allocated
+// besides the children themselves - they join through a counter stored in the awaiting frame.
+namespace Coro
+{
+    template <typename T>
+    struct WhenAnyResult
+    {
+        std::size_t index;
+        Detail::ResultOf<T> value;
+    };
+
+    namespace Detail
+    {
+        struct StopForwarder
+        {
+            std::stop_source* target;
+
+            void operator()() const noexcept { target->request_stop(); }
+        };
+
+        // forwards a stop request of the awaiting Task (if it has a stop token) to the children
+        class ParentStopLink
+        {
+        public:
+            ParentStopLink() = default;
+
+            ParentStopLink(ParentStopLink&& other) noexcept
+            {
+                assert(!other.callback_); // not linked yet
+            }
+
+            template <typename TPromise>
+            void link(std::coroutine_handle<TPromise> awaiting, std::stop_source& children)
+            {
+                if constexpr (requires { awaiting.promise().stop_token(); })
+                {
+                    const std::stop_token& token = awaiting.promise().stop_token();
+                    if (token.stop_possible())
+                        callback_.emplace(token, StopForwarder{&children});
+                }
+            }
+
+        private:
+            std::optional<std::stop_callback<StopForwarder>> callback_;
+        };
+
+        // a real failure is reported before a cancellation it may have caused
+        template <typename TTask>
+        void rethrow_first_failure(std::span<TTask> tasks)
+        {
+            TTask* cancelled = nullptr;
+
+            for (auto& task : tasks)
+            {
+                if (task.promise().failed())
+                {
+                    if (!task.promise().cancelled())
+                        task.take_result();
+                    else if (!cancelled)
+                        cancelled = &task;
+                }
+            }
+
+            if (cancelled)
+                cancelled->take_result();
+        }
+
+        template <typename... Ts>
+        class WhenAllAwaitable
+        {
+        public:
+            explicit WhenAllAwaitable(Task<Ts>... tasks)
+                : join_{sizeof...(Ts), false}
+                , tasks_{std::move(tasks)...}
+            { }
+
+            bool await_ready() const noexcept { return sizeof...(Ts) == 0; }
+
+            template <typename TPromise>
+            bool await_suspend(std::coroutine_handle<TPromise> awaiting)
+            {
+                stop_link_.link(awaiting, join_.stop_source());
+
+                std::apply([this](auto&... tasks) {
+                    std::size_t index = 0;
+                    (tasks.start_joined(join_, index++), ...);
+                }, tasks_);
+
+                return join_.awaiting_arrive(awaiting);
+            }
+
+            std::tuple<ResultOf<Ts>...> await_resume()
+            {
+                bool any_cancelled = false;
+
+                std::apply([&](auto&... tasks) {
+                    auto rethrow_failure = [&](auto& task) {
+                        if (task.promise().failed())
+                        {
+                            if (!task.promise().cancelled())
+                                task.take_result();
+                            any_cancelled = true;
+                        }
+                    };
+                    (rethrow_failure(tasks), ...);
+                }, tasks_);
+
+                if (any_cancelled)
+                    throw OperationCancelled{};
+
+                return std::apply([](auto&... tasks) { return std::tuple<ResultOf<Ts>...>{tasks.take_result()...}; }, tasks_);
+            }
+
+        private:
+            JoinCounter join_;
+            ParentStopLink stop_link_;
+            std::tuple<Task<Ts>...> tasks_;
+        };
+
+        template <typename T>
+        class WhenAllRangeAwaitable
+        {
+        public:
+            explicit WhenAllRangeAwaitable(std::vector<Task<T>> tasks)
+                : join_{tasks.size(), false}
+                , tasks_{std::move(tasks)}
+            { }
+
+            bool await_ready() const noexcept { return tasks_.empty(); }
+
+            template <typename TPromise>
+            bool await_suspend(std::coroutine_handle<TPromise> awaiting)
+            {
+                stop_link_.link(awaiting, join_.stop_source());
+
+                for (std::size_t index = 0; index < tasks_.size(); ++index)
+                    tasks_[index].start_joined(join_, index);
+
+                return join_.awaiting_arrive(awaiting);
+            }
+
+            auto await_resume()
+            {
+                rethrow_first_failure(std::span{tasks_});
+
+                if constexpr (std::is_void_v<T>)
+                    return;
+                else
+                {
+                    std::vector<T> results;
+                    results.reserve(tasks_.size());
+                    for (auto& task : tasks_)
+                        results.push_back(task.take_result());
+                    return results;
+                }
+            }
+
+        private:
+            JoinCounter join_;
+            ParentStopLink stop_link_;
+            std::vector<Task<T>> tasks_;
+        };
+
+        template <typename T>
+        class WhenAnyAwaitable
+        {
+        public:
+            explicit WhenAnyAwaitable(std::vector<Task<T>> tasks)
+                : join_{tasks.size(), true}
+                , tasks_{std::move(tasks)}
+            {
+                if (tasks_.empty())
+                    throw std::invalid_argument("when_any requires at least one task");
+            }
+
+            bool await_ready() const noexcept { return false; }
+
+            template <typename TPromise>
+            bool await_suspend(std::coroutine_handle<TPromise> awaiting)
+            {
+                stop_link_.link(awaiting, join_.stop_source());
+
+                for (std::size_t index = 0; index < tasks_.size(); ++index)
+                    tasks_[index].start_joined(join_, index);
+
+                return join_.awaiting_arrive(awaiting);
+            }
+
+            WhenAnyResult<T> await_resume()
+            {
+                const std::size_t winner = join_.winner();
+
+                if (winner != JoinCounter::no_winner)
+                    return WhenAnyResult<T>{winner, tasks_[winner].take_result()};
+
+                rethrow_first_failure(std::span{tasks_});
+                throw OperationCancelled{};
+            }
+
+        private:
+            JoinCounter join_;
+            ParentStopLink stop_link_;
+            std::vector<Task<T>> tasks_;
+        };
+
+        template <typename TRange>
+        using TaskValueOf = typename std::ranges::range_value_t<TRange>::value_type;
+
+        template <typename TRange>
+        auto to_task_vector(TRange&& tasks)
+        {
+            using TTask = std::ranges::range_value_t<TRange>;
+
+            std::vector<TTask> result;
+            if constexpr (std::ranges::sized_range<TRange>)
+                result.reserve(std::ranges::size(tasks));
+
+            for (auto&& task : tasks)
+                result.push_back(std::move(task));
+
+            return result;
+        }
+    } // namespace Detail
+
+    template <typename T>
+    concept TaskRange = std::ranges::input_range<T>
+        && std::same_as<std::ranges::range_value_t<T>, Task<typename std::ranges::range_value_t<T>::value_type>>;
+
+    // co_await when_all(t1, t2, ...) -> std::tuple of results (std::monostate for Task<void>)
+    template <typename... Ts>
+    [[nodiscard]] Detail::WhenAllAwaitable<Ts...> when_all(Task<Ts>... tasks)
+    {
+        return Detail::WhenAllAwaitable<Ts...>{std::move(tasks)...};
+    }
+
+    // co_await when_all(tasks) -> std::vector of results (void for Task<void>)
+    template <TaskRange TRange>
+    [[nodiscard]] auto when_all(TRange&& tasks)
+    {
+        return Detail::WhenAllRangeAwaitable<Detail::TaskValueOf<TRange>>{Detail::to_task_vector(std::forward<TRange>(tasks))};
+    }
+
+    // co_await when_any(t1, t2, ...) -> WhenAnyResult{index, value} of the first successful task
+    template <typename T, std::same_as<Task<T>>... TTasks>
+    [[nodiscard]] Detail::WhenAnyAwaitable<T> when_any(Task<T> first, TTasks... rest)
+    {
+        std::vector<Task<T>> tasks;
+        tasks.reserve(1 + sizeof...(rest));
+        tasks.push_back(std::move(first));
+        (tasks.push_back(std::move(rest)), ...);
+
+        return Detail::WhenAnyAwaitable<T>{std::move(tasks)};
+    }
+
+    template <TaskRange TRange>
+    [[nodiscard]] auto when_any(TRange&& tasks)
+    {
+        return Detail::WhenAnyAwaitable<Detail::TaskValueOf<TRange>>{Detail::to_task_vector(std::forward<TRange>(tasks))};
+    }
+} // namespace Coro
+
+#endif
@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "coro_instrumentation.hpp"
+#include "generator.hpp"
+#include "task_resumer.hpp"
+
+using Coro::Instrumentation::LatencyHistogram;
+
+TEST_CASE("instrumentation - latency histogram")
+{
+    LatencyHistogram histogram;
+
+    for (std::uint64_t value = 1; value <= 1000; ++value)
+        histogram.record(value);
+
+    CHECK(histogram.count() == 1000);
+    CHECK(histogram.min() == 1);
+    CHECK(histogram.max() == 1000);
+    CHECK(histogram.mean() == 500.5);
+
+    SECTION("small values are exact")
+    {
+        CHECK(histogram.value_at_percentile(1.0) == 10);
+        CHECK(histogram.value_at_percentile(0.0) == 1);
+    }
+
+    SECTION("large values within 1/16 relative error")
+    {
+        auto p50 = histogram.value_at_percentile(50.0);
+        CHECK(p50 >= 500);
+        CHECK(p50 <= 500 + 500 / 16);
+
+        auto p99 = histogram.value_at_percentile(99.0);
+        CHECK(p99 >= 990);
+        CHECK(p99 <= 1000);
+    }
+
+    SECTION("bucket boundaries")
+    {
+        const std::uint64_t values[] = {31, 32, 33, 1023, 1024, std::uint64_t{1} << 40, UINT64_MAX};
+
+        for (std::uint64_t value : values)
+        {
+            auto idx = LatencyHistogram::index_of(value);
+            CHECK(idx < LatencyHistogram::slot_count);
+            CHECK(LatencyHistogram::highest_equivalent_value(idx) >= value);
+        }
+    }
+}
+
+namespace
+{
+    TaskResumer counting_task(int max)
+    {
+        for (int i = 0; i < max; ++i)
+            co_await std::suspend_always{};
+    }
+} // namespace
+
+#ifdef CORO_INSTRUMENTATION
+
+namespace
+{
+    FutureStd::Generator<int> numbers(int n)
+    {
+        for (int i = 0; i < n; ++i)
+            co_yield i;
+    }
+
+    const Coro::Instrumentation::FunctionReport* find_report(const std::vector<Coro::Instrumentation::FunctionReport>& reports, std::string_view fragment)
+    {
+        for (const auto& r : reports)
+            if (r.name.find(fragment) != std::string_view::npos)
+                return &r;
+        return nullptr;
+    }
+} // namespace
+
+TEST_CASE("instrumentation - frames, resumes & suspensions per coroutine")
+{
+    auto& registry = Coro::Instrumentation::Registry::instance();
+    registry.reset();
+
+    {
+        TaskResumer task = counting_task(5);
+
+        auto reports = registry.snapshot();
+        auto* r = find_report(reports, "counting_task");
+        REQUIRE(r != nullptr);
+        CHECK(r->live_frames == 1);
+        CHECK(r->max_frame_size > 0);
+
+        while (task.resume())
+            ;
+    }
+
+    int sum = 0;
+    for (int value : numbers(10))
+        sum += value;
+    CHECK(sum == 45);
+
+    auto reports = registry.snapshot();
+
+    auto* task_report = find_report(reports, "counting_task");
+    REQUIRE(task_report != nullptr);
+    CHECK(task_report->live_frames == 0);
+    CHECK(task_report->resumes == 6);
+    CHECK(task_report->suspensions == 5);
+    CHECK(task_report->resume_p50_ns <= task_report->resume_max_ns);
+
+    auto* gen_report = find_report(reports, "numbers");
+    REQUIRE(gen_report != nullptr);
+    CHECK(gen_report->resumes == 11);
+    CHECK(gen_report->suspensions == 10);
+
+    std::ostringstream out;
+    Coro::Instrumentation::report(out);
+    CHECK(out.str().find("counting_task") != std::string::npos);
+
+    std::cout << out.str();
+}
+
+#else
+
+TEST_CASE("instrumentation - compiled out")
+{
+    static_assert(!Coro::Instrumentation::enabled);
+    static_assert(std::is_empty_v<Coro::Instrumentation::PromiseInstrumentation>);
+    static_assert(sizeof(TaskResumer::promise_type) == 1);
+
+    TaskResumer task = counting_task(3);
+    int resumes = 1;
+    while (task.resume())
+        ++resumes;
+    CHECK(resumes == 4);
+}
+
+#endif
@@ -0,0 +1,355 @@
+#ifndef CORO_INSTRUMENTATION_HPP
+#define CORO_INSTRUMENTATION_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef CORO_INSTRUMENTATION
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <source_location>
+#include <string_view>
+#include <utility>
+#include <vector>
+#endif
+
+// Opt-in instrumentation of coroutine promise types - enabled with -DCORO_INSTRUMENTATION
+// (cmake option CORO_INSTRUMENTATION). When disabled PromiseInstrumentation is an empty base
+// and instrumented_resume() is a plain resume() - nothing is left in the generated code.
+namespace Coro::Instrumentation
+{
+    // HDR-style log-linear histogram: 32 exact slots, then 16 linear sub-buckets per power of two
+    // (relative error <= 1/16); recording is a single relaxed atomic increment
+    class LatencyHistogram
+    {
+    public:
+        static constexpr unsigned sub_bucket_bits = 4;
+        static constexpr std::size_t sub_bucket_count = std::size_t{1} << sub_bucket_bits;
+        static constexpr std::size_t exact_count = 2 * sub_bucket_count;
+        static constexpr std::size_t slot_count = exact_count + (64 - sub_bucket_bits - 1) * sub_bucket_count;
+
+        void record(std::uint64_t value) noexcept
+        {
+            counts_[index_of(value)].fetch_add(1, std::memory_order_relaxed);
+            total_count_.fetch_add(1, std::memory_order_relaxed);
+            total_sum_.fetch_add(value, std::memory_order_relaxed);
+
+            std::uint64_t prev_max = max_.load(std::memory_order_relaxed);
+            while (value > prev_max && !max_.compare_exchange_weak(prev_max, value, std::memory_order_relaxed))
+                ;
+
+            std::uint64_t prev_min = min_.load(std::memory_order_relaxed);
+            while (value < prev_min && !min_.compare_exchange_weak(prev_min, value, std::memory_order_relaxed))
+                ;
+        }
+
+        std::uint64_t count() const noexcept { return total_count_.load(std::memory_order_relaxed); }
+
+        std::uint64_t min() const noexcept { return count() ? min_.load(std::memory_order_relaxed) : 0; }
+
+        std::uint64_t max() const noexcept { return max_.load(std::memory_order_relaxed); }
+
+        double mean() const noexcept
+        {
+            auto n = count();
+            return n ? static_cast<double>(total_sum_.load(std::memory_order_relaxed)) / n : 0.0;
+        }
+
+        // highest value equivalent to the bucket that contains the given percentile
+        std::uint64_t value_at_percentile(double percentile) const noexcept
+        {
+            const std::uint64_t n = count();
+            if (n == 0)
+                return 0;
+
+            auto rank = static_cast<std::uint64_t>(percentile / 100.0 * n + 0.5);
+            rank = std::clamp<std::uint64_t>(rank, 1, n);
+
+            std::uint64_t cumulative = 0;
+            for (std::size_t idx = 0; idx < slot_count; ++idx)
+            {
+                cumulative += counts_[idx].load(std::memory_order_relaxed);
+                if (cumulative >= rank)
+                    return std::min(highest_equivalent_value(idx), max());
+            }
+
+            return max();
+        }
+
+        void reset() noexcept
+        {
+            for (auto& c : counts_)
+                c.store(0, std::memory_order_relaxed);
+            total_count_ = 0;
+            total_sum_ = 0;
+            min_ = UINT64_MAX;
+            max_ = 0;
+        }
+
+        static constexpr std::size_t index_of(std::uint64_t value) noexcept
+        {
+            if (value < exact_count)
+                return static_cast<std::size_t>(value);
+
+            const unsigned shift = std::bit_width(value) - (sub_bucket_bits + 1);
+            const std::uint64_t sub_bucket = (value >> shift) - sub_bucket_count;
+            return exact_count + (shift - 1) * sub_bucket_count + static_cast<std::size_t>(sub_bucket);
+        }
+
+        static constexpr std::uint64_t highest_equivalent_value(std::size_t idx) noexcept
+        {
+            if (idx < exact_count)
+                return idx;
+
+            const unsigned shift = static_cast<unsigned>((idx - exact_count) / sub_bucket_count) + 1;
+            const std::uint64_t top = sub_bucket_count + (idx - exact_count) % sub_bucket_count;
+            return ((top + 1) << shift) - 1;
+        }
+
+    private:
+        std::array<std::atomic<std::uint64_t>, slot_count> counts_{};
+        std::atomic<std::uint64_t> total_count_{0};
+        std::atomic<std::uint64_t> total_sum_{0};
+        std::atomic<std::uint64_t> min_{UINT64_MAX};
+        std::atomic<std::uint64_t> max_{0};
+    };
+
+#ifdef CORO_INSTRUMENTATION
+
+    inline constexpr bool enabled = true;
+
+    // counters for a single coroutine function (identified by its signature)
+    struct FunctionStats
+    {
+        std::string_view name;
+        std::atomic<std::uint64_t> frames_allocated{0};
+        std::atomic<std::uint64_t> frames_freed{0};
+        std::atomic<std::uint64_t> frame_bytes{0};
+        std::atomic<std::uint64_t> max_frame_size{0};
+        std::atomic<std::uint64_t> peak_live_frames{0};
+        std::atomic<std::uint64_t> suspensions{0};
+        LatencyHistogram resume_ns; // resume-to-suspend time of a single resume() call
+
+        std::uint64_t live_frames() const noexcept { return frames_allocated - frames_freed; }
+
+        void on_allocate(std::size_t size) noexcept
+        {
+            frame_bytes.fetch_add(size, std::memory_order_relaxed);
+
+            std::uint64_t prev_size = max_frame_size.load(std::memory_order_relaxed);
+            while (size > prev_size && !max_frame_size.compare_exchange_weak(prev_size, size, std::memory_order_relaxed))
+                ;
+
+            const std::uint64_t live = frames_allocated.fetch_add(1, std::memory_order_relaxed) + 1 - frames_freed.load(std::memory_order_relaxed);
+            std::uint64_t prev_peak = peak_live_frames.load(std::memory_order_relaxed);
+            while (live > prev_peak && !peak_live_frames.compare_exchange_weak(prev_peak, live, std::memory_order_relaxed))
+                ;
+        }
+
+        void on_free() noexcept { frames_freed.fetch_add(1, std::memory_order_relaxed); }
+    };
+
+    // plain copy of FunctionStats for export
+    struct FunctionReport
+    {
+        std::string_view name;
+        std::uint64_t frames_allocated;
+        std::uint64_t live_frames;
+        std::uint64_t peak_live_frames;
+        std::uint64_t avg_frame_size;
+        std::uint64_t max_frame_size;
+        std::uint64_t resumes;
+        std::uint64_t suspensions;
+        std::uint64_t resume_p50_ns;
+        std::uint64_t resume_p99_ns;
+        std::uint64_t resume_max_ns;
+    };
+
+    class Registry
+    {
+    public:
+        static Registry& instance()
+        {
+            static Registry* registry = new Registry{}; // never destroyed - frames may outlive static destructors
+            return *registry;
+        }
+
+        FunctionStats& stats_for(std::string_view function_name)
+        {
+            std::lock_guard lk{mtx_};
+
+            auto& stats = stats_[function_name];
+            if (!stats)
+            {
+                stats = std::make_unique<FunctionStats>();
+                stats->name = function_name;
+            }
+            return *stats;
+        }
+
+        std::vector<FunctionReport> snapshot() const
+        {
+            std::lock_guard lk{mtx_};
+
+            std::vector<FunctionReport> reports;
+            reports.reserve(stats_.size());
+
+            for (const auto& [name, s] : stats_)
+            {
+                const std::uint64_t allocated = s->frames_allocated;
+                reports.push_back(FunctionReport{
+                    .name = name,
+                    .frames_allocated = allocated,
+                    .live_frames = s->live_frames(),
+                    .peak_live_frames = s->peak_live_frames,
+                    .avg_frame_size = allocated ? s->frame_bytes / allocated : 0,
+                    .max_frame_size = s->max_frame_size,
+                    .resumes = s->resume_ns.count(),
+                    .suspensions = s->suspensions,
+                    .resume_p50_ns = s->resume_ns.value_at_percentile(50.0),
+                    .resume_p99_ns = s->resume_ns.value_at_percentile(99.0),
+                    .resume_max_ns = s->resume_ns.max()});
+            }
+
+            return reports;
+        }
+
+        void report(std::ostream& out) const
+        {
+            out << std::left << std::setw(48) << "coroutine" << std::right
+                << std::setw(10) << "frames" << std::setw(8) << "live" << std::setw(8) << "peak"
+                << std::setw(10) << "avg B" << std::setw(8) << "max B"
+                << std::setw(10) << "resumes" << std::setw(10) << "suspends"
+                << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(10) << "max ns" << "\n";
+
+            for (const auto& r : snapshot())
+            {
+                out << std::left << std::setw(48) << r.name.substr(0, 47) << std::right
+                    << std::setw(10) << r.frames_allocated << std::setw(8) << r.live_frames << std::setw(8) << r.peak_live_frames
+                    << std::setw(10) << r.avg_frame_size << std::setw(8) << r.max_frame_size
+                    << std::setw(10) << r.resumes << std::setw(10) << r.suspensions
+                    << std::setw(10) << r.resume_p50_ns << std::setw(10) << r.resume_p99_ns << std::setw(10) << r.resume_max_ns << "\n";
+            }
+        }
+
+        // counters of live frames are kept - resetting them would break later deallocations
+        void reset()
+        {
+            std::lock_guard lk{mtx_};
+
+            for (auto& [name, s] : stats_)
+            {
+                s->suspensions = 0;
+                s->resume_ns.reset();
+            }
+        }
+
+    private:
+        Registry() = default;
+
+        mutable std::mutex mtx_;
+        std::map<std::string_view, std::unique_ptr<FunctionStats>, std::less<>> stats_;
+    };
+
+    namespace Detail
+    {
+        // handed over from the frame allocation to the promise constructor that follows it
+        inline thread_local FunctionStats* allocated_frame_stats = nullptr;
+
+        struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameHeader
+        {
+            FunctionStats* stats;
+        };
+
+        // not inlined - GCC would pair the ::operator new in the source_location operator new with the sized
+        // ::operator delete of the promise & report -Wmismatched-new-delete for every inlined coroutine
+        [[gnu::noinline]] inline void* allocate_frame(std::size_t size) { return ::operator new(size); }
+
+        [[gnu::noinline]] inline void deallocate_frame(void* ptr, std::size_t size) noexcept { ::operator delete(ptr, size); }
+    } // namespace Detail
+
+    // base class for promise types - hooks frame allocation and remembers per-function stats
+    class PromiseInstrumentation
+    {
+    public:
+        PromiseInstrumentation() noexcept
+            : stats_{std::exchange(Detail::allocated_frame_stats, nullptr)}
+        {
+            if (!stats_) // allocation elided by the compiler
+                stats_ = &Registry::instance().stats_for("<elided frame>");
+        }
+
+        // source_location defaults to the coroutine function whose frame is allocated
+        static void* operator new(std::size_t size, std::source_location location = std::source_location::current())
+        {
+            FunctionStats& stats = Registry::instance().stats_for(location.function_name());
+            stats.on_allocate(size);
+
+            void* raw_mem = Detail::allocate_frame(sizeof(Detail::FrameHeader) + size);
+            auto* header = ::new (raw_mem) Detail::FrameHeader{&stats};
+            Detail::allocated_frame_stats = &stats;
+
+            return header + 1;
+        }
+
+        static void operator delete(void* ptr, std::size_t size) noexcept
+        {
+            auto* header = static_cast<Detail::FrameHeader*>(ptr) - 1;
+            header->stats->on_free();
+            Detail::deallocate_frame(header, sizeof(Detail::FrameHeader) + size);
+        }
+
+        FunctionStats& stats() const noexcept { return *stats_; }
+
+    private:
+        FunctionStats* stats_;
+    };
+
+    // the promise type must suspend at final_suspend (frame still alive when resume() returns)
+    template <typename TPromise>
+    void instrumented_resume(std::coroutine_handle<TPromise> coro_hndl)
+    {
+        FunctionStats& stats = coro_hndl.promise().stats();
+
+        const auto start = std::chrono::steady_clock::now();
+        coro_hndl.resume();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        stats.resume_ns.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        if (!coro_hndl.done())
+            stats.suspensions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void report(std::ostream& out)
+    {
+        Registry::instance().report(out);
+    }
+
+#else
+
+    inline constexpr bool enabled = false;
+
+    class PromiseInstrumentation
+    {
+    };
+
+    template <typename TPromise>
+    void instrumented_resume(std::coroutine_handle<TPromise> coro_hndl)
+    {
+        coro_hndl.resume();
+    }
+
+#endif
+} // namespace Coro::Instrumentation
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef INTRUSIVE_FIFO_HPP
+#define INTRUSIVE_FIFO_HPP
+
+namespace Coro
+{
+    namespace Detail
+    {
+        // FIFO of suspended awaiters - the nodes live in the awaiting frames
+        template <typename TAwaiter>
+        class IntrusiveFifo
+        {
+        public:
+            bool empty() const noexcept { return head_ == nullptr; }
+
+            void push(TAwaiter& awaiter) noexcept
+            {
+                awaiter.next = nullptr;
+                if (tail_)
+                    tail_->next = &awaiter;
+                else
+                    head_ = &awaiter;
+                tail_ = &awaiter;
+            }
+
+            TAwaiter* pop() noexcept
+            {
+                TAwaiter* awaiter = head_;
+                if (awaiter)
+                {
+                    head_ = awaiter->next;
+                    if (!head_)
+                        tail_ = nullptr;
+                }
+                return awaiter;
+            }
+
+        private:
+            TAwaiter* head_ = nullptr;
+            TAwaiter* tail_ = nullptr;
+        };
+    } // namespace Detail
+} // namespace Coro
+
+#endif
@@ -0,0 +1,121 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "generator.hpp"
+#include "prefetch.hpp"
+
+using FutureStd::Generator;
+
+namespace
+{
+    Generator<int> numbers(int n)
+    {
+        for (int i = 0; i < n; ++i)
+            co_yield i;
+    }
+
+    Generator<std::string> words_then_failure()
+    {
+        co_yield "one";
+        co_yield "two";
+        throw std::runtime_error("decompression failed");
+    }
+
+    Generator<long long> infinite()
+    {
+        for (long long i = 0;; ++i)
+            co_yield i;
+    }
+
+    double burn(int work, double seed)
+    {
+        double x = seed;
+        for (int i = 0; i < work; ++i)
+            x = std::sqrt(x + i);
+        return x;
+    }
+
+    Generator<double> expensive(int n, int work)
+    {
+        for (int i = 0; i < n; ++i)
+            co_yield burn(work, i);
+    }
+} // namespace
+
+TEST_CASE("generator - exceptions are propagated to the consumer")
+{
+    std::vector<std::string> items;
+
+    auto consume = [&] {
+        for (const auto& item : words_then_failure())
+            items.push_back(item);
+    };
+
+    CHECK_THROWS_AS(consume(), std::runtime_error);
+    CHECK(items == std::vector<std::string>{"one", "two"});
+}
+
+TEST_CASE("prefetch - order is preserved")
+{
+    std::vector<int> items;
+
+    for (int item : Coro::prefetch(numbers(10'000), 16))
+        items.push_back(item);
+
+    REQUIRE(items.size() == 10'000);
+    for (int i = 0; i < 10'000; ++i)
+        CHECK(items[i] == i);
+}
+
+TEST_CASE("prefetch - exception thrown by the producer")
+{
+    std::vector<std::string> items;
+
+    auto consume = [&] {
+        for (const auto& item : Coro::prefetch(words_then_failure(), 4))
+            items.push_back(item);
+    };
+
+    CHECK_THROWS_AS(consume(), std::runtime_error);
+    CHECK(items == std::vector<std::string>{"one", "two"});
+}
+
+TEST_CASE("prefetch - consumer stops early")
+{
+    long long sum = 0;
+
+    for (long long item : Coro::prefetch(infinite(), 8))
+    {
+        if (item == 100)
+            break;
+        sum += item;
+    }
+
+    CHECK(sum == 4950); // producer blocked on a full buffer is released by the destructor
+}
+
+TEST_CASE("prefetch - benchmarks", "[.][benchmark]")
+{
+    constexpr int items = 20'000;
+    constexpr int work = 500; // balanced producer & consumer cost
+
+    BENCHMARK("serial")
+    {
+        double sum = 0;
+        for (double item : expensive(items, work))
+            sum += burn(work, item);
+        return sum;
+    };
+
+    BENCHMARK("prefetch(depth = 256)")
+    {
+        double sum = 0;
+        for (double item : Coro::prefetch(expensive(items, work), 256))
+            sum += burn(work, item);
+        return sum;
+    };
+}
@@ -0,0 +1,219 @@
+#ifndef PREFETCH_HPP
+#define PREFETCH_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include "channel.hpp"
+#include "generator.hpp"
+
+namespace Coro
+{
+    namespace Detail
+    {
+        // bounded SPSC ring - blocking is done with C++20 atomic wait/notify on the positions;
+        // the top bit of a position marks the end of its side (producer finished / consumer gone)
+        template <typename T>
+        class PrefetchBuffer
+        {
+        public:
+            static constexpr std::size_t closed_bit = std::size_t{1} << (sizeof(std::size_t) * 8 - 1);
+
+            explicit PrefetchBuffer(std::size_t depth)
+                : mask_{std::bit_ceil(depth < 1 ? std::size_t{1} : depth) - 1}
+                , slots_{std::make_unique<Slot[]>(mask_ + 1)}
+            { }
+
+            ~PrefetchBuffer()
+            {
+                const std::size_t tail = tail_.load(std::memory_order_acquire) & ~closed_bit;
+                for (std::size_t pos = head_.load(std::memory_order_relaxed) & ~closed_bit; pos != tail; ++pos)
+                    std::destroy_at(slots_[pos & mask_].item());
+            }
+
+            // producer side - returns false when the consumer is gone
+            template <typename U>
+            bool push(U&& value)
+            {
+                const std::size_t tail = tail_.load(std::memory_order_relaxed);
+
+                for (;;)
+                {
+                    const std::size_t head = head_.load(std::memory_order_acquire);
+                    if (head & closed_bit)
+                        return false;
+                    if (tail - head <= mask_)
+                        break;
+                    head_.wait(head, std::memory_order_acquire);
+                }
+
+                std::construct_at(slots_[tail & mask_].item(), std::forward<U>(value));
+                tail_.store(tail + 1, std::memory_order_release);
+                tail_.notify_one();
+                return true;
+            }
+
+            void close(std::exception_ptr error = nullptr)
+            {
+                error_ = std::move(error);
+                tail_.fetch_or(closed_bit, std::memory_order_release);
+                tail_.notify_one();
+            }
+
+            // consumer side - returns nullopt after the last item (rethrows the producer's exception)
+            std::optional<T> pop()
+            {
+                const std::size_t head = head_.load(std::memory_order_relaxed);
+
+                for (;;)
+                {
+                    const std::size_t tail = tail_.load(std::memory_order_acquire);
+                    if ((tail & ~closed_bit) != head)
+                        break;
+                    if (tail & closed_bit)
+                    {
+                        if (error_)
+                            std::rethrow_exception(std::exchange(error_, nullptr));
+                        return std::nullopt;
+                    }
+                    tail_.wait(tail, std::memory_order_acquire);
+                }
+
+                T* item = slots_[head & mask_].item();
+                std::optional<T> result{std::move(*item)};
+                std::destroy_at(item);
+
+                head_.store(head + 1, std::memory_order_release);
+                head_.notify_one();
+                return result;
+            }
+
+            void abandon()
+            {
+                head_.fetch_or(closed_bit, std::memory_order_release);
+                head_.notify_one();
+            }
+
+        private:
+            struct Slot
+            {
+                alignas(T) std::byte storage[sizeof(T)];
+
+                T* item() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+            };
+
+            const std::size_t mask_;
+            std::unique_ptr<Slot[]> slots_;
+            alignas(cache_line_size) std::atomic<std::size_t> head_{0};
+            alignas(cache_line_size) std::atomic<std::size_t> tail_{0};
+            std::exception_ptr error_; // written before tail_ is closed
+        };
+    } // namespace Detail
+
+    // input range produced by a Generator running ahead on a background thread
+    template <typename T>
+    class Prefetched
+    {
+    public:
+        struct sentinel
+        { };
+
+        class iterator
+        {
+        public:
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            explicit iterator(Prefetched* owner) noexcept
+                : owner_{owner}
+            { }
+
+            T& operator*() const { return *owner_->current_; }
+
+            T* operator->() const { return &*owner_->current_; }
+
+            iterator& operator++()
+            {
+                owner_->advance();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(sentinel) const noexcept { return !owner_->current_.has_value(); }
+
+        private:
+            Prefetched* owner_ = nullptr;
+        };
+
+        Prefetched(FutureStd::Generator<T> generator, std::size_t depth)
+            : buffer_{std::make_unique<Detail::PrefetchBuffer<T>>(depth)}
+        {
+            producer_ = std::jthread{[buffer = buffer_.get(), generator = std::move(generator)](std::stop_token stop_token) mutable {
+                try
+                {
+                    for (auto&& item : generator)
+                    {
+                        if (stop_token.stop_requested() || !buffer->push(std::move(item)))
+                            break;
+                    }
+                    buffer->close();
+                }
+                catch (...)
+                {
+                    buffer->close(std::current_exception());
+                }
+            }};
+        }
+
+        Prefetched(Prefetched&&) noexcept = default;
+        Prefetched& operator=(Prefetched&&) = delete;
+
+        ~Prefetched()
+        {
+            if (buffer_)
+            {
+                producer_.request_stop();
+                buffer_->abandon(); // wakes up the producer blocked on a full buffer
+                producer_.join();
+            }
+        }
+
+        // single pass - begin() may be called once
+        iterator begin()
+        {
+            advance();
+            return iterator{this};
+        }
+
+        sentinel end() const noexcept { return {}; }
+
+    private:
+        void advance() { current_ = buffer_->pop(); }
+
+        std::unique_ptr<Detail::PrefetchBuffer<T>> buffer_;
+        std::optional<T> current_;
+        std::jthread producer_; // declared last - joined before the buffer is released
+    };
+
+    // drives the generator on a background thread, up to `depth` items ahead of the consumer;
+    // items are delivered in order and an exception thrown by the generator is rethrown to the consumer
+    template <typename T>
+    [[nodiscard]] Prefetched<T> prefetch(FutureStd::Generator<T> generator, std::size_t depth = 64)
+    {
+        return Prefetched<T>{std::move(generator), depth};
+    }
+} // namespace Coro
+
+#endif
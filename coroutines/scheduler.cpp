@@ -0,0 +1,145 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "scheduler.hpp"
+
+using Coro::Agent;
+using Coro::Scheduler;
+
+namespace
+{
+    Agent logger(int id, int steps, std::vector<int>& log)
+    {
+        for (int i = 0; i < steps; ++i)
+        {
+            log.push_back(id);
+            co_await Coro::yield();
+        }
+    }
+
+    Agent spawner(int children, std::vector<int>& log)
+    {
+        for (int i = 0; i < children; ++i)
+            Scheduler::current().spawn(logger(100 + i, 1, log));
+        co_return;
+    }
+
+    Agent counter(long long& total, int steps)
+    {
+        for (int i = 0; i < steps; ++i)
+        {
+            ++total;
+            co_await Coro::yield();
+        }
+    }
+} // namespace
+
+TEST_CASE("scheduler - agents are interleaved round-robin")
+{
+    Scheduler scheduler;
+    std::vector<int> log;
+
+    for (int id = 1; id <= 3; ++id)
+        scheduler.spawn(logger(id, 3, log));
+
+    CHECK(scheduler.live() == 3);
+
+    scheduler.run();
+
+    CHECK(log == std::vector{1, 2, 3, 1, 2, 3, 1, 2, 3});
+    CHECK(scheduler.live() == 0);
+    CHECK(Coro::Detail::FramePool::local().live_frames() == 0);
+}
+
+TEST_CASE("scheduler - agents spawning agents")
+{
+    Scheduler scheduler;
+    std::vector<int> log;
+
+    scheduler.spawn(spawner(3, log));
+    scheduler.run();
+
+    CHECK(log == std::vector{100, 101, 102});
+    CHECK(scheduler.live() == 0);
+}
+
+TEST_CASE("scheduler - frames are recycled by the pool")
+{
+    auto& pool = Coro::Detail::FramePool::local();
+    long long total = 0;
+
+    {
+        Scheduler scheduler;
+        for (int i = 0; i < 1'000; ++i)
+            scheduler.spawn(counter(total, 2));
+        scheduler.run();
+    }
+
+    const auto reserved = pool.bytes_reserved();
+
+    {
+        Scheduler scheduler;
+        for (int i = 0; i < 1'000; ++i)
+            scheduler.spawn(counter(total, 2));
+        scheduler.run();
+    }
+
+    CHECK(total == 4'000);
+    CHECK(pool.bytes_reserved() == reserved);
+}
+
+TEST_CASE("scheduler - unfinished agents are destroyed with the scheduler")
+{
+    std::vector<int> log;
+
+    {
+        Scheduler scheduler;
+        scheduler.spawn(logger(1, 10, log));
+    }
+
+    CHECK(log.empty());
+    CHECK(Coro::Detail::FramePool::local().live_frames() == 0);
+}
+
+TEST_CASE("scheduler - benchmarks", "[.][benchmark]")
+{
+    for (int agents : {1'000'000, 10'000'000})
+    {
+        constexpr int steps = 10;
+        long long total = 0;
+
+        auto& pool = Coro::Detail::FramePool::local();
+        const auto reserved_before = pool.bytes_reserved();
+
+        Scheduler scheduler;
+        for (int i = 0; i < agents; ++i)
+            scheduler.spawn(counter(total, steps));
+
+        const double bytes_per_agent = static_cast<double>(pool.bytes_reserved() - reserved_before) / agents;
+
+        const auto start = std::chrono::steady_clock::now();
+        scheduler.run();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        const auto ns_per_switch = std::chrono::duration<double, std::nano>(elapsed).count() / scheduler.context_switches();
+
+        std::cout << agents << " agents: " << bytes_per_agent << " B/agent, "
+                  << ns_per_switch << " ns/context switch (" << scheduler.context_switches() << " switches)\n";
+
+        CHECK(total == static_cast<long long>(agents) * steps);
+    }
+
+    BENCHMARK("spawn & run 100'000 agents x 10 yields")
+    {
+        long long total = 0;
+        Scheduler scheduler;
+        for (int i = 0; i < 100'000; ++i)
+            scheduler.spawn(counter(total, 10));
+        scheduler.run();
+        return total;
+    };
+}
@@ -0,0 +1,369 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Coro
+{
+    namespace Detail
+    {
+        // thread-local size-class pool for coroutine frames - bump allocation from 1 MB chunks,
+        // freed frames go to a per-size free list (no malloc header, no locking)
+        class FramePool
+        {
+        public:
+            static constexpr std::size_t granularity = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+            static constexpr std::size_t max_pooled_size = 1024;
+            static constexpr std::size_t chunk_size = std::size_t{1} << 20;
+
+            static FramePool& local() noexcept
+            {
+                thread_local FramePool pool;
+                return pool;
+            }
+
+            void* allocate(std::size_t size)
+            {
+                if (size > max_pooled_size)
+                    return ::operator new(size);
+
+                ++live_frames_;
+
+                const std::size_t size_class = size_class_of(size);
+                if (FreeNode* node = free_lists_[size_class])
+                {
+                    free_lists_[size_class] = node->next;
+                    return node;
+                }
+
+                const std::size_t rounded_size = (size_class + 1) * granularity;
+                if (static_cast<std::size_t>(chunk_end_ - cursor_) < rounded_size)
+                {
+                    chunks_.push_back(std::make_unique_for_overwrite<std::byte[]>(chunk_size));
+                    cursor_ = chunks_.back().get();
+                    chunk_end_ = cursor_ + chunk_size;
+                }
+
+                return std::exchange(cursor_, cursor_ + rounded_size);
+            }
+
+            void deallocate(void* ptr, std::size_t size) noexcept
+            {
+                if (size > max_pooled_size)
+                {
+                    ::operator delete(ptr, size);
+                    return;
+                }
+
+                --live_frames_;
+
+                const std::size_t size_class = size_class_of(size);
+                free_lists_[size_class] = ::new (ptr) FreeNode{free_lists_[size_class]};
+            }
+
+            std::size_t live_frames() const noexcept { return live_frames_; }
+
+            std::size_t bytes_reserved() const noexcept { return chunks_.size() * chunk_size; }
+
+        private:
+            struct FreeNode
+            {
+                FreeNode* next;
+            };
+
+            static constexpr std::size_t size_class_of(std::size_t size) noexcept { return (size + granularity - 1) / granularity - 1; }
+
+            std::array<FreeNode*, max_pooled_size / granularity> free_lists_{};
+            std::vector<std::unique_ptr<std::byte[]>> chunks_;
+            std::byte* cursor_ = nullptr;
+            std::byte* chunk_end_ = nullptr;
+            std::size_t live_frames_ = 0;
+        };
+    } // namespace Detail
+
+    class Scheduler;
+
+    // fire-and-forget coroutine run by a Scheduler - the promise is just the run queue link,
+    // the frame comes from the thread-local FramePool and frees itself on completion
+    class [[nodiscard]] Agent
+    {
+    public:
+        struct promise_type
+        {
+            promise_type* next = nullptr; // intrusive run queue hook
+
+            Agent get_return_object() noexcept { return Agent{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+
+            auto final_suspend() const noexcept;
+
+            void return_void() const noexcept { }
+
+            void unhandled_exception() const noexcept { std::terminate(); }
+
+            static void* operator new(std::size_t size) { return Detail::FramePool::local().allocate(size); }
+
+            static void operator delete(void* ptr, std::size_t size) noexcept { Detail::FramePool::local().deallocate(ptr, size); }
+        };
+
+        using CoroutineHandle = std::coroutine_handle<promise_type>;
+
+        explicit Agent(CoroutineHandle coro_hndl) noexcept
+            : coro_hndl_{coro_hndl}
+        { }
+
+        Agent(Agent&& other) noexcept
+            : coro_hndl_{std::exchange(other.coro_hndl_, nullptr)}
+        { }
+
+        Agent& operator=(Agent&&) = delete;
+
+        ~Agent()
+        {
+            if (coro_hndl_)
+                coro_hndl_.destroy();
+        }
+
+    private:
+        friend class Scheduler;
+
+        CoroutineHandle release() noexcept { return std::exchange(coro_hndl_, nullptr); }
+
+        CoroutineHandle coro_hndl_;
+    };
+
+    // single-threaded cooperative scheduler with an intrusive FIFO run queue (one per thread);
+    // agents woken by other threads (wake()) are passed through a locked queue & moved to the run queue by run()
+    class Scheduler
+    {
+    public:
+        Scheduler() noexcept
+        {
+            assert(current_ == nullptr);
+            current_ = this;
+        }
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        ~Scheduler()
+        {
+            take_remote();
+            while (auto* promise = pop())
+                Agent::CoroutineHandle::from_promise(*promise).destroy();
+
+            current_ = nullptr;
+        }
+
+        static Scheduler& current() noexcept
+        {
+            assert(current_ != nullptr);
+            return *current_;
+        }
+
+        void spawn(Agent agent) noexcept
+        {
+            ++live_;
+            push(agent.release().promise());
+        }
+
+        // runs until no agent is ready
+        void run()
+        {
+            for (;;)
+            {
+                take_remote();
+                Agent::promise_type* promise = pop();
+                if (!promise)
+                    return;
+
+                ++context_switches_;
+                Agent::CoroutineHandle::from_promise(*promise).resume();
+            }
+        }
+
+        // runs until all the spawned agents are done - waits for the ones suspended until other threads wake them
+        void run_until_done()
+        {
+            for (run(); live_ > 0; run())
+            {
+                std::unique_lock lock{remote_mtx_};
+                remote_posted_.wait(lock, [this] { return remote_head_ != nullptr; });
+            }
+        }
+
+        std::size_t live() const noexcept { return live_; }
+
+        std::size_t context_switches() const noexcept { return context_switches_; }
+
+        // re-queues the agent and transfers control straight to the next ready one
+        std::coroutine_handle<> yield(Agent::promise_type& promise) noexcept
+        {
+            push(promise);
+            ++context_switches_;
+            return Agent::CoroutineHandle::from_promise(*pop());
+        }
+
+        // agents suspended on something else (e.g. a Channel) get back to the run queue with schedule()
+        void schedule(Agent::promise_type& promise) noexcept { push(promise); }
+
+        // schedule() callable from any thread - from the thread of the scheduler straight to the run queue
+        void wake(Agent::promise_type& promise)
+        {
+            if (current_ == this)
+            {
+                push(promise);
+                return;
+            }
+
+            {
+                std::lock_guard lock{remote_mtx_};
+                promise.next = nullptr;
+                if (remote_tail_)
+                    remote_tail_->next = &promise;
+                else
+                    remote_head_ = &promise;
+                remote_tail_ = &promise;
+                has_remote_.store(true, std::memory_order_release);
+            }
+            remote_posted_.notify_one();
+        }
+
+        void on_agent_done() noexcept { --live_; }
+
+    private:
+        // the agents woken by other threads appended to the run queue
+        void take_remote()
+        {
+            if (!has_remote_.load(std::memory_order_acquire))
+                return;
+
+            std::lock_guard lock{remote_mtx_};
+            if (tail_)
+                tail_->next = remote_head_;
+            else
+                head_ = remote_head_;
+            tail_ = remote_tail_;
+            remote_head_ = remote_tail_ = nullptr;
+            has_remote_.store(false, std::memory_order_relaxed);
+        }
+
+        void push(Agent::promise_type& promise) noexcept
+        {
+            promise.next = nullptr;
+            if (tail_)
+                tail_->next = &promise;
+            else
+                head_ = &promise;
+            tail_ = &promise;
+        }
+
+        Agent::promise_type* pop() noexcept
+        {
+            Agent::promise_type* promise = head_;
+            if (promise)
+            {
+                head_ = promise->next;
+                if (!head_)
+                    tail_ = nullptr;
+            }
+            return promise;
+        }
+
+        inline static thread_local Scheduler* current_ = nullptr;
+
+        Agent::promise_type* head_ = nullptr;
+        Agent::promise_type* tail_ = nullptr;
+        std::size_t live_ = 0;
+        std::size_t context_switches_ = 0;
+
+        std::mutex remote_mtx_;
+        std::condition_variable remote_posted_;
+        Agent::promise_type* remote_head_ = nullptr;
+        Agent::promise_type* remote_tail_ = nullptr;
+        std::atomic<bool> has_remote_ = false;
+    };
+
+    inline auto Agent::promise_type::final_suspend() const noexcept
+    {
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(CoroutineHandle coro_hndl) const noexcept
+            {
+                Scheduler::current().on_agent_done();
+                coro_hndl.destroy();
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+        return FinalAwaiter{};
+    }
+
+    namespace Detail
+    {
+        // wakes up a coroutine suspended on a synchronization primitive - an Agent goes back to the run queue
+        // of its Scheduler (captured when it suspends - it runs on it then; the waker keeps running, whatever
+        // its thread), any other coroutine is resumed inline
+        class Waker
+        {
+        public:
+            Waker() = default;
+
+            template <typename TPromise>
+            explicit Waker(std::coroutine_handle<TPromise> coro_hndl) noexcept
+                : coro_hndl_{coro_hndl}
+            {
+                if constexpr (std::is_same_v<TPromise, Agent::promise_type>)
+                    scheduler_ = &Scheduler::current();
+            }
+
+            void operator()() const
+            {
+                if (scheduler_)
+                    scheduler_->wake(Agent::CoroutineHandle::from_address(coro_hndl_.address()).promise());
+                else
+                    coro_hndl_.resume();
+            }
+
+        private:
+            std::coroutine_handle<> coro_hndl_;
+            Scheduler* scheduler_ = nullptr; // only for an Agent
+        };
+    } // namespace Detail
+
+    // co_await yield() - lets the other ready agents run
+    inline auto yield() noexcept
+    {
+        struct YieldAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(Agent::CoroutineHandle coro_hndl) const noexcept
+            {
+                return Scheduler::current().yield(coro_hndl.promise());
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+        return YieldAwaiter{};
+    }
+} // namespace Coro
+
+#endif
@@ -0,0 +1,238 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "simulation.hpp"
+
+using Coro::Process;
+using Coro::Resource;
+using Coro::SimTime;
+using Coro::Simulation;
+
+namespace
+{
+    Process ticker(Simulation& sim, std::string name, SimTime period, int ticks, std::vector<std::string>& log)
+    {
+        for (int i = 0; i < ticks; ++i)
+        {
+            co_await sim.delay(period);
+            log.push_back(name + "@" + std::to_string(static_cast<int>(sim.now())));
+        }
+    }
+
+    struct QueueStats
+    {
+        int served = 0;
+        double total_wait = 0;
+        std::size_t max_queue_length = 0;
+    };
+
+    Process customer(Simulation& sim, Resource& servers, double mean_service, QueueStats& stats)
+    {
+        const SimTime arrival = sim.now();
+        stats.max_queue_length = std::max(stats.max_queue_length, servers.queue_length());
+
+        co_await servers.acquire();
+        stats.total_wait += sim.now() - arrival;
+
+        co_await sim.delay(sim.exponential(mean_service));
+        servers.release();
+        ++stats.served;
+    }
+
+    Process arrivals(Simulation& sim, Resource& servers, int customers, double mean_interarrival, double mean_service, QueueStats& stats)
+    {
+        for (int i = 0; i < customers; ++i)
+        {
+            co_await sim.delay(sim.exponential(mean_interarrival));
+            sim.spawn(customer(sim, servers, mean_service, stats));
+        }
+    }
+
+    // M/M/c queue
+    QueueStats simulate_queue(std::uint64_t seed, std::size_t servers_count, int customers)
+    {
+        Simulation sim{seed};
+        Resource servers{sim, servers_count};
+        QueueStats stats;
+
+        sim.spawn(arrivals(sim, servers, customers, 1.0, 0.8 * servers_count, stats));
+        sim.run();
+
+        CHECK(sim.live() == 0);
+        CHECK(servers.available() == servers_count);
+        return stats;
+    }
+
+    Process bouncer(Simulation& sim, int steps)
+    {
+        for (int i = 0; i < steps; ++i)
+            co_await sim.delay(sim.exponential(100.0));
+    }
+} // namespace
+
+TEST_CASE("simulation - events are processed in virtual time order")
+{
+    Simulation sim;
+    std::vector<std::string> log;
+
+    sim.spawn(ticker(sim, "a", 3, 3, log));
+    sim.spawn(ticker(sim, "b", 2, 3, log));
+    sim.spawn(ticker(sim, "c", 5, 1, log), 1);
+    sim.run();
+
+    // ties (a@6 & b@6) are resumed in the order they were scheduled
+    CHECK(log == std::vector<std::string>{"b@2", "a@3", "b@4", "c@6", "a@6", "b@6", "a@9"});
+    CHECK(sim.now() == 9);
+    CHECK(sim.live() == 0);
+}
+
+TEST_CASE("simulation - run_until")
+{
+    Simulation sim;
+    std::vector<std::string> log;
+
+    sim.spawn(ticker(sim, "a", 10, 5, log));
+
+    sim.run_until(25);
+    CHECK(log == std::vector<std::string>{"a@10", "a@20"});
+    CHECK(sim.now() == 25);
+
+    sim.spawn(ticker(sim, "b", 1, 1, log)); // scheduled before the already inspected a@30
+    sim.run_until(30);
+    CHECK(log == std::vector<std::string>{"a@10", "a@20", "b@26", "a@30"});
+}
+
+TEST_CASE("simulation - resource grants units in FIFO order")
+{
+    Simulation sim;
+    Resource machine{sim, 1};
+    std::vector<int> order;
+
+    auto job = [](Simulation& sim, Resource& machine, int id, std::vector<int>& order) -> Process {
+        co_await machine.acquire();
+        order.push_back(id);
+        co_await sim.delay(10);
+        machine.release();
+    };
+
+    for (int id = 0; id < 4; ++id)
+        sim.spawn(job(sim, machine, id, order), id);
+
+    sim.run_until(5);
+    CHECK(machine.queue_length() == 3);
+
+    sim.run();
+
+    CHECK(order == std::vector{0, 1, 2, 3});
+    CHECK(sim.now() == 40);
+    CHECK(machine.available() == 1);
+}
+
+TEST_CASE("simulation - event wakes up all the waiters")
+{
+    Simulation sim;
+    Coro::Event start{sim};
+    std::vector<SimTime> started;
+
+    auto runner = [](Coro::Event& start, Simulation& sim, std::vector<SimTime>& started) -> Process {
+        co_await start;
+        started.push_back(sim.now());
+    };
+
+    auto starter = [](Coro::Event& start, Simulation& sim) -> Process {
+        co_await sim.delay(7);
+        start.trigger();
+    };
+
+    for (int i = 0; i < 3; ++i)
+        sim.spawn(runner(start, sim, started));
+    sim.spawn(starter(start, sim));
+    sim.spawn(runner(start, sim, started), 10); // the event is already triggered
+
+    sim.run();
+
+    CHECK(started == std::vector<SimTime>{7, 7, 7, 10});
+}
+
+TEST_CASE("simulation - results are reproducible for a seed")
+{
+    const QueueStats first = simulate_queue(42, 2, 1'000);
+    const QueueStats second = simulate_queue(42, 2, 1'000);
+    const QueueStats other_seed = simulate_queue(7, 2, 1'000);
+
+    CHECK(first.served == 1'000);
+    CHECK(first.total_wait == second.total_wait);
+    CHECK(first.max_queue_length == second.max_queue_length);
+    CHECK(first.total_wait != other_seed.total_wait);
+}
+
+TEST_CASE("simulation - unfinished processes are destroyed with the simulation")
+{
+    std::vector<std::string> log;
+
+    {
+        Simulation sim;
+        Resource resource{sim, 1};
+        Coro::Event never{sim};
+
+        auto holder = [](Resource& resource) -> Process { co_await resource.acquire(); };
+        auto waiter = [](Resource& resource) -> Process { co_await resource.acquire(); };
+        auto listener = [](Coro::Event& event) -> Process { co_await event; };
+
+        sim.spawn(holder(resource));
+        sim.spawn(waiter(resource));
+        sim.spawn(listener(never));
+        sim.spawn(ticker(sim, "a", 1, 100, log));
+        sim.run_until(3);
+
+        CHECK(sim.live() == 3);
+    }
+
+    CHECK(log.size() == 3);
+    CHECK(Coro::Detail::FramePool::local().live_frames() == 0);
+}
+
+TEST_CASE("simulation - exception thrown by a process")
+{
+    Simulation sim;
+
+    auto faulty = [](Simulation& sim) -> Process {
+        co_await sim.delay(5);
+        throw std::runtime_error("breakdown");
+    };
+
+    sim.spawn(faulty(sim));
+
+    CHECK_THROWS_AS(sim.run(), std::runtime_error);
+    CHECK(sim.now() == 5);
+    CHECK(sim.live() == 0);
+}
+
+TEST_CASE("simulation - benchmarks", "[.][benchmark]")
+{
+    for (int processes : {1'000, 100'000})
+    {
+        constexpr int events = 20'000'000;
+
+        Simulation sim{1};
+        for (int i = 0; i < processes; ++i)
+            sim.spawn(bouncer(sim, events / processes));
+
+        const auto start = std::chrono::steady_clock::now();
+        sim.run();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        const double events_per_second = sim.events_processed() / std::chrono::duration<double>(elapsed).count();
+        std::cout << processes << " processes: " << events_per_second / 1e6 << " M events/s\n";
+    }
+
+    BENCHMARK("M/M/2 queue - 100'000 customers")
+    {
+        return simulate_queue(1, 2, 100'000).total_wait;
+    };
+}
@@ -0,0 +1,464 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "intrusive_fifo.hpp"
+#include "random.hpp"
+#include "scheduler.hpp"
+
+// Deterministic discrete-event simulation - processes are coroutines stepped in virtual time:
+//  * co_await sim.delay(t)        - resumes the process t time units later
+//  * co_await resource.acquire()  - waits (FIFO) for one of the units of a Resource
+//  * co_await event               - waits until the Event is triggered
+// Simultaneous events are resumed in the order they were scheduled, so a run depends only on the seed.
+namespace Coro
+{
+    using SimTime = double;
+
+    class Simulation;
+
+    namespace Detail
+    {
+        // radix heap over virtual time - keys are never smaller than the last popped one, so a key is kept
+        // in the bucket of the highest bit in which it differs from that minimum; push is O(1), pop scans
+        // and redistributes a bucket only when the bucket of the minimum runs empty (amortized O(log range)).
+        // Buckets are appended & redistributed in order, so simultaneous events come out FIFO.
+        class EventQueue
+        {
+        public:
+            struct Entry
+            {
+                std::uint64_t key;
+                std::coroutine_handle<> handle;
+            };
+
+            static std::uint64_t key_of(SimTime time) noexcept
+            {
+                assert(time >= 0);
+                return time == 0 ? 0 : std::bit_cast<std::uint64_t>(time); // the bits of a non-negative double are ordered
+            }
+
+            static SimTime time_of(std::uint64_t key) noexcept { return std::bit_cast<SimTime>(key); }
+
+            bool empty() const noexcept { return size_ == 0; }
+
+            std::size_t size() const noexcept { return size_; }
+
+            void push(SimTime time, std::coroutine_handle<> handle)
+            {
+                const std::uint64_t key = key_of(time);
+                if (key < last_) [[unlikely]]
+                    rebase(key);
+                buckets_[bucket_of(key)].push_back({key, handle});
+                ++size_;
+            }
+
+            // the time of the next event (the queue must not be empty)
+            SimTime next_time()
+            {
+                assert(!empty());
+
+                if (front_ == buckets_[0].size())
+                    refill();
+
+                return time_of(last_);
+            }
+
+            Entry pop()
+            {
+                assert(!empty());
+
+                if (front_ == buckets_[0].size())
+                    refill();
+
+                --size_;
+                return buckets_[0][front_++];
+            }
+
+            void clear() noexcept
+            {
+                for (auto& bucket : buckets_)
+                    bucket.clear();
+                front_ = 0;
+                size_ = 0;
+            }
+
+        private:
+            std::size_t bucket_of(std::uint64_t key) const noexcept { return std::bit_width(key ^ last_); }
+
+            // moves the bucket holding the new minimum into the lower buckets
+            void refill()
+            {
+                buckets_[0].clear();
+                front_ = 0;
+
+                std::size_t index = 1;
+                while (buckets_[index].empty())
+                    ++index;
+                auto& bucket = buckets_[index];
+
+                std::uint64_t min_key = bucket.front().key;
+                for (const Entry& entry : bucket)
+                    min_key = std::min(min_key, entry.key);
+
+                last_ = min_key;
+                for (const Entry& entry : bucket)
+                    buckets_[bucket_of(entry.key)].push_back(entry);
+                bucket.clear();
+            }
+
+            // next_time() may have moved the minimum past the current time (run_until() stops before it)
+            // and an event can still be scheduled in between - rare, so all the entries are redistributed
+            void rebase(std::uint64_t key)
+            {
+                std::vector<Entry> entries;
+                entries.reserve(size_);
+                entries.insert(entries.end(), buckets_[0].begin() + front_, buckets_[0].end());
+                for (std::size_t index = 1; index < buckets_.size(); ++index)
+                    entries.insert(entries.end(), buckets_[index].begin(), buckets_[index].end());
+
+                clear();
+                last_ = key;
+                for (const Entry& entry : entries)
+                    buckets_[bucket_of(entry.key)].push_back(entry);
+                size_ = entries.size();
+            }
+
+            std::array<std::vector<Entry>, 65> buckets_;
+            std::size_t front_ = 0; // bucket 0 (keys equal to last_) is consumed from the front
+            std::uint64_t last_ = 0;
+            std::size_t size_ = 0;
+        };
+    } // namespace Detail
+
+    // simulated process - the frame is owned by the Simulation it was spawned into
+    class [[nodiscard]] Process
+    {
+    public:
+        struct promise_type
+        {
+            Simulation* sim = nullptr;
+            promise_type* prev = nullptr; // intrusive list of live processes
+            promise_type* next = nullptr;
+
+            Process get_return_object() noexcept { return Process{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+
+            auto final_suspend() const noexcept;
+
+            void return_void() const noexcept { }
+
+            void unhandled_exception() noexcept;
+
+            static void* operator new(std::size_t size) { return Detail::FramePool::local().allocate(size); }
+
+            static void operator delete(void* ptr, std::size_t size) noexcept { Detail::FramePool::local().deallocate(ptr, size); }
+        };
+
+        using CoroutineHandle = std::coroutine_handle<promise_type>;
+
+        explicit Process(CoroutineHandle coro_hndl) noexcept
+            : coro_hndl_{coro_hndl}
+        { }
+
+        Process(Process&& other) noexcept
+            : coro_hndl_{std::exchange(other.coro_hndl_, nullptr)}
+        { }
+
+        Process& operator=(Process&&) = delete;
+
+        ~Process()
+        {
+            if (coro_hndl_)
+                coro_hndl_.destroy();
+        }
+
+    private:
+        friend class Simulation;
+
+        CoroutineHandle release() noexcept { return std::exchange(coro_hndl_, nullptr); }
+
+        CoroutineHandle coro_hndl_;
+    };
+
+    class Simulation
+    {
+    public:
+        explicit Simulation(std::uint64_t seed = 0) noexcept
+            : random_{seed}
+        { }
+
+        Simulation(const Simulation&) = delete;
+        Simulation& operator=(const Simulation&) = delete;
+
+        // processes still waiting (on a delay, a resource or an event) are destroyed
+        ~Simulation()
+        {
+            queue_.clear();
+            while (live_list_)
+                Process::CoroutineHandle::from_promise(*unlink(*live_list_)).destroy();
+        }
+
+        // the process starts after `start_delay`
+        void spawn(Process process, SimTime start_delay = 0)
+        {
+            Process::CoroutineHandle coro_hndl = process.release();
+            link(coro_hndl.promise());
+            schedule(coro_hndl, now_ + start_delay);
+        }
+
+        // runs until no event is pending; an exception escaping a process is rethrown here
+        void run()
+        {
+            while (!queue_.empty())
+                step();
+        }
+
+        // runs the events up to (and including) time `end`
+        void run_until(SimTime end)
+        {
+            while (!queue_.empty() && queue_.next_time() <= end)
+                step();
+
+            if (now_ < end)
+                now_ = end;
+        }
+
+        SimTime now() const noexcept { return now_; }
+
+        std::size_t live() const noexcept { return live_; }
+
+        std::uint64_t events_processed() const noexcept { return events_processed_; }
+
+        std::size_t pending_events() const noexcept { return queue_.size(); }
+
+        helpers::random::PCG& random() noexcept { return random_; }
+
+        // uniform in [0, 1)
+        double uniform() noexcept { return random_() * 0x1p-32; }
+
+        double exponential(double mean) noexcept { return -mean * std::log1p(-uniform()); }
+
+        // co_await sim.delay(t)
+        auto delay(SimTime time) noexcept
+        {
+            struct DelayAwaiter
+            {
+                Simulation& sim;
+                SimTime time;
+
+                bool await_ready() const noexcept { return false; }
+
+                void await_suspend(std::coroutine_handle<> coro_hndl) const { sim.schedule(coro_hndl, sim.now_ + time); }
+
+                void await_resume() const noexcept { }
+            };
+
+            return DelayAwaiter{*this, time};
+        }
+
+        // wakes up a suspended coroutine at virtual time `time` (used by Resource & Event)
+        void schedule(std::coroutine_handle<> coro_hndl, SimTime time)
+        {
+            assert(time >= now_);
+            queue_.push(time, coro_hndl);
+        }
+
+    private:
+        friend struct Process::promise_type;
+
+        void step()
+        {
+            const Detail::EventQueue::Entry entry = queue_.pop();
+            now_ = Detail::EventQueue::time_of(entry.key);
+            ++events_processed_;
+            entry.handle.resume();
+
+            if (error_)
+                std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+
+        void link(Process::promise_type& promise) noexcept
+        {
+            promise.sim = this;
+            promise.prev = nullptr;
+            promise.next = live_list_;
+            if (live_list_)
+                live_list_->prev = &promise;
+            live_list_ = &promise;
+            ++live_;
+        }
+
+        Process::promise_type* unlink(Process::promise_type& promise) noexcept
+        {
+            if (promise.prev)
+                promise.prev->next = promise.next;
+            else
+                live_list_ = promise.next;
+            if (promise.next)
+                promise.next->prev = promise.prev;
+            --live_;
+            return &promise;
+        }
+
+        Detail::EventQueue queue_;
+        SimTime now_ = 0;
+        std::uint64_t events_processed_ = 0;
+        Process::promise_type* live_list_ = nullptr;
+        std::size_t live_ = 0;
+        std::exception_ptr error_;
+        helpers::random::PCG random_;
+    };
+
+    inline auto Process::promise_type::final_suspend() const noexcept
+    {
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(CoroutineHandle coro_hndl) const noexcept
+            {
+                coro_hndl.promise().sim->unlink(coro_hndl.promise());
+                coro_hndl.destroy();
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+        return FinalAwaiter{};
+    }
+
+    inline void Process::promise_type::unhandled_exception() noexcept
+    {
+        sim->error_ = std::current_exception();
+    }
+
+    // `capacity` identical units (servers, machines, ...) - granted to the waiting processes in FIFO order
+    class Resource
+    {
+        struct AcquireAwaiter
+        {
+            Resource& resource;
+            std::coroutine_handle<> coro_hndl{};
+            AcquireAwaiter* next = nullptr;
+
+            bool await_ready() const noexcept
+            {
+                if (resource.available_ == 0)
+                    return false;
+                --resource.available_;
+                return true;
+            }
+
+            void await_suspend(std::coroutine_handle<> coro_hndl) noexcept
+            {
+                this->coro_hndl = coro_hndl;
+                resource.waiters_.push(*this);
+                ++resource.queue_length_;
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+    public:
+        Resource(Simulation& sim, std::size_t capacity) noexcept
+            : sim_{sim}
+            , capacity_{capacity}
+            , available_{capacity}
+        { }
+
+        Resource(const Resource&) = delete;
+        Resource& operator=(const Resource&) = delete;
+
+        [[nodiscard]] AcquireAwaiter acquire() noexcept { return AcquireAwaiter{*this}; }
+
+        // the unit goes straight to the first waiter, which is resumed at the current time
+        void release()
+        {
+            if (AcquireAwaiter* waiter = waiters_.pop())
+            {
+                --queue_length_;
+                sim_.schedule(waiter->coro_hndl, sim_.now());
+                return;
+            }
+
+            assert(available_ < capacity_);
+            ++available_;
+        }
+
+        std::size_t capacity() const noexcept { return capacity_; }
+
+        std::size_t available() const noexcept { return available_; }
+
+        std::size_t queue_length() const noexcept { return queue_length_; }
+
+    private:
+        Simulation& sim_;
+        const std::size_t capacity_;
+        std::size_t available_;
+        std::size_t queue_length_ = 0;
+        Detail::IntrusiveFifo<AcquireAwaiter> waiters_;
+    };
+
+    // one-shot event - co_await suspends until trigger(), afterwards it completes immediately (until reset())
+    class Event
+    {
+        struct EventAwaiter
+        {
+            Event& event;
+            std::coroutine_handle<> coro_hndl{};
+            EventAwaiter* next = nullptr;
+
+            bool await_ready() const noexcept { return event.triggered_; }
+
+            void await_suspend(std::coroutine_handle<> coro_hndl) noexcept
+            {
+                this->coro_hndl = coro_hndl;
+                event.waiters_.push(*this);
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+    public:
+        explicit Event(Simulation& sim) noexcept
+            : sim_{sim}
+        { }
+
+        Event(const Event&) = delete;
+        Event& operator=(const Event&) = delete;
+
+        EventAwaiter operator co_await() noexcept { return EventAwaiter{*this}; }
+
+        // all waiters are resumed at the current time, in the order they started waiting
+        void trigger()
+        {
+            triggered_ = true;
+            while (EventAwaiter* waiter = waiters_.pop())
+                sim_.schedule(waiter->coro_hndl, sim_.now());
+        }
+
+        void reset() noexcept { triggered_ = false; }
+
+        bool is_triggered() const noexcept { return triggered_; }
+
+    private:
+        Simulation& sim_;
+        bool triggered_ = false;
+        Detail::IntrusiveFifo<EventAwaiter> waiters_;
+    };
+} // namespace Coro
+
+#endif
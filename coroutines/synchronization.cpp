@@ -0,0 +1,354 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "scheduler.hpp"
+#include "synchronization.hpp"
+#include "task.hpp"
+#include "task_resumer.hpp"
+
+using Coro::Agent;
+using Coro::AsyncLatch;
+using Coro::AsyncMutex;
+using Coro::AsyncSemaphore;
+using Coro::Scheduler;
+using Coro::Task;
+
+namespace
+{
+    // holds the lock across a yield, so the other agents pile up on the mutex
+    Agent contender(AsyncMutex& mutex, int id, int rounds, std::vector<int>& owners)
+    {
+        for (int i = 0; i < rounds; ++i)
+        {
+            auto lock = co_await mutex.scoped_lock_async();
+            owners.push_back(id);
+            co_await Coro::yield();
+        }
+    }
+
+    Agent limited_worker(AsyncSemaphore& semaphore, int& inside, int& max_inside)
+    {
+        co_await semaphore.acquire();
+        max_inside = std::max(max_inside, ++inside);
+        co_await Coro::yield();
+        co_await Coro::yield();
+        --inside;
+        semaphore.release();
+    }
+
+    Task<void> increment(AsyncMutex& mutex, long long& counter, int iterations)
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto lock = co_await mutex.scoped_lock_async();
+            ++counter;
+        }
+    }
+
+    Task<void> increment(AsyncSemaphore& semaphore, long long& counter, int iterations)
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            co_await semaphore.acquire();
+            ++counter;
+            semaphore.release();
+        }
+    }
+
+    template <typename TPrimitive>
+    long long run_on_threads(TPrimitive& primitive, int threads_count, int iterations)
+    {
+        long long counter = 0;
+        {
+            std::vector<std::jthread> threads;
+            for (int i = 0; i < threads_count; ++i)
+                threads.emplace_back([&] { Coro::sync_wait(increment(primitive, counter, iterations)); });
+        }
+        return counter;
+    }
+
+    // 1.0 - all the workers got the same share
+    double jain_fairness(const std::vector<long long>& shares)
+    {
+        const double sum = std::accumulate(shares.begin(), shares.end(), 0.0);
+        const double sum_of_squares = std::inner_product(shares.begin(), shares.end(), shares.begin(), 0.0);
+        return sum * sum / (shares.size() * sum_of_squares);
+    }
+} // namespace
+
+TEST_CASE("async mutex - uncontended")
+{
+    AsyncMutex mutex;
+
+    REQUIRE(mutex.try_lock());
+    CHECK_FALSE(mutex.try_lock());
+    mutex.unlock();
+
+    auto locker = [](AsyncMutex& mutex, int& value) -> TaskResumer {
+        co_await mutex.lock_async();
+        value = 1;
+        mutex.unlock();
+
+        {
+            auto lock = co_await mutex.scoped_lock_async();
+            value = 2;
+        }
+    };
+
+    int value = 0;
+    TaskResumer task = locker(mutex, value);
+    CHECK_FALSE(task.resume()); // never suspended
+    CHECK(value == 2);
+    CHECK(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST_CASE("async mutex - lock is handed over in FIFO order")
+{
+    Scheduler scheduler;
+    AsyncMutex mutex;
+    std::vector<int> owners;
+
+    for (int id = 0; id < 3; ++id)
+        scheduler.spawn(contender(mutex, id, 3, owners));
+    scheduler.run();
+
+    CHECK(owners == std::vector{0, 1, 2, 0, 1, 2, 0, 1, 2});
+    CHECK(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST_CASE("async mutex - coroutines resumed on many threads")
+{
+    AsyncMutex mutex;
+
+    CHECK(run_on_threads(mutex, 4, 20'000) == 80'000);
+}
+
+TEST_CASE("async semaphore - limits the number of holders")
+{
+    Scheduler scheduler;
+    AsyncSemaphore semaphore{2};
+    int inside = 0;
+    int max_inside = 0;
+
+    for (int i = 0; i < 10; ++i)
+        scheduler.spawn(limited_worker(semaphore, inside, max_inside));
+    scheduler.run();
+
+    CHECK(max_inside == 2);
+    CHECK(semaphore.count() == 2);
+    CHECK(scheduler.live() == 0);
+}
+
+TEST_CASE("async semaphore - release wakes up waiters in FIFO order")
+{
+    AsyncSemaphore semaphore{0};
+    std::vector<int> order;
+
+    auto waiter = [](AsyncSemaphore& semaphore, int id, std::vector<int>& order) -> TaskResumer {
+        co_await semaphore.acquire();
+        order.push_back(id);
+    };
+
+    TaskResumer first = waiter(semaphore, 0, order);
+    TaskResumer second = waiter(semaphore, 1, order);
+    TaskResumer third = waiter(semaphore, 2, order);
+    CHECK(first.resume());
+    CHECK(second.resume());
+    CHECK(third.resume());
+    CHECK(semaphore.count() == -3);
+
+    semaphore.release(2);
+    CHECK(order == std::vector{0, 1});
+
+    semaphore.release(2);
+    CHECK(order == std::vector{0, 1, 2});
+    CHECK(semaphore.count() == 1);
+    CHECK(semaphore.try_acquire());
+    CHECK_FALSE(semaphore.try_acquire());
+}
+
+TEST_CASE("async semaphore - coroutines resumed on many threads")
+{
+    AsyncSemaphore semaphore{1};
+
+    CHECK(run_on_threads(semaphore, 4, 20'000) == 80'000);
+    CHECK(semaphore.count() == 1);
+}
+
+TEST_CASE("synchronization - agents woken from outside of their scheduler")
+{
+    Scheduler scheduler;
+    AsyncMutex mutex;
+    AsyncSemaphore semaphore{0};
+    int acquired = 0;
+
+    auto locker = [](AsyncMutex& mutex, int& acquired) -> Agent {
+        auto lock = co_await mutex.scoped_lock_async();
+        ++acquired;
+    };
+
+    auto acquirer = [](AsyncSemaphore& semaphore, int& acquired) -> Agent {
+        co_await semaphore.acquire();
+        ++acquired;
+    };
+
+    REQUIRE(mutex.try_lock());
+    for (int i = 0; i < 3; ++i)
+        scheduler.spawn(locker(mutex, acquired));
+    scheduler.spawn(acquirer(semaphore, acquired));
+    scheduler.spawn(acquirer(semaphore, acquired));
+    scheduler.run();
+    CHECK(scheduler.live() == 5);
+
+    SECTION("by plain threads")
+    {
+        std::jthread unlocker{[&] { mutex.unlock(); }};
+        std::jthread releaser{[&] { semaphore.release(2); }};
+        scheduler.run_until_done();
+    }
+
+    SECTION("by an agent of a scheduler on another thread")
+    {
+        std::size_t other_live = 1;
+        std::jthread other_thread{[&] {
+            Scheduler other;
+            other.spawn([](AsyncMutex& mutex, AsyncSemaphore& semaphore) -> Agent {
+                mutex.unlock();
+                semaphore.release(2);
+                co_return;
+            }(mutex, semaphore));
+            other.run();
+            other_live = other.live();
+        }};
+        scheduler.run_until_done();
+        other_thread.join();
+        CHECK(other_live == 0);
+    }
+
+    CHECK(acquired == 5);
+    CHECK(scheduler.live() == 0);
+    CHECK(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST_CASE("async latch")
+{
+    AsyncLatch latch{3};
+    std::vector<int> order;
+
+    auto waiter = [](AsyncLatch& latch, int id, std::vector<int>& order) -> TaskResumer {
+        co_await latch;
+        order.push_back(id);
+    };
+
+    TaskResumer first = waiter(latch, 1, order);
+    TaskResumer second = waiter(latch, 2, order);
+    CHECK(first.resume());
+    CHECK(second.resume());
+
+    latch.count_down(2);
+    CHECK(order.empty());
+    CHECK_FALSE(latch.try_wait());
+
+    latch.count_down();
+    CHECK(order == std::vector{1, 2});
+    CHECK(latch.try_wait());
+
+    TaskResumer late = waiter(latch, 3, order);
+    CHECK_FALSE(late.resume()); // the latch is already open
+    CHECK(order == std::vector{1, 2, 3});
+}
+
+TEST_CASE("async latch - counted down on other threads")
+{
+    constexpr int workers = 8;
+    AsyncLatch latch{workers};
+    std::atomic<int> done = 0;
+
+    auto waiter = [&]() -> Task<int> {
+        co_await latch;
+        co_return done.load();
+    };
+
+    std::vector<std::jthread> threads;
+    for (int i = 0; i < workers; ++i)
+        threads.emplace_back([&] {
+            ++done;
+            latch.count_down();
+        });
+
+    CHECK(Coro::sync_wait(waiter()) == workers);
+}
+
+TEST_CASE("synchronization - benchmarks", "[.][benchmark]")
+{
+    constexpr int iterations = 200'000;
+
+    for (int threads_count : {1, 2, 4, 8})
+    {
+        BENCHMARK("AsyncMutex - " + std::to_string(threads_count) + " threads")
+        {
+            AsyncMutex mutex;
+            return run_on_threads(mutex, threads_count, iterations / threads_count);
+        };
+
+        BENCHMARK("AsyncSemaphore{1} - " + std::to_string(threads_count) + " threads")
+        {
+            AsyncSemaphore semaphore{1};
+            return run_on_threads(semaphore, threads_count, iterations / threads_count);
+        };
+
+        BENCHMARK("std::mutex - " + std::to_string(threads_count) + " threads")
+        {
+            std::mutex mtx;
+            long long counter = 0;
+            {
+                std::vector<std::jthread> threads;
+                for (int i = 0; i < threads_count; ++i)
+                    threads.emplace_back([&] {
+                        for (int j = 0; j < iterations / threads_count; ++j)
+                        {
+                            std::lock_guard lk{mtx};
+                            ++counter;
+                        }
+                    });
+            }
+            return counter;
+        };
+    }
+
+    // fairness - share of the first half of all acquisitions taken by each of the contending agents
+    {
+        constexpr int agents = 1'000;
+        constexpr int rounds = 100;
+
+        Scheduler scheduler;
+        AsyncMutex mutex;
+        std::vector<int> owners;
+        owners.reserve(agents * rounds);
+
+        for (int id = 0; id < agents; ++id)
+            scheduler.spawn(contender(mutex, id, rounds, owners));
+
+        const auto start = std::chrono::steady_clock::now();
+        scheduler.run();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        std::vector<long long> shares(agents);
+        for (std::size_t i = 0; i < owners.size() / 2; ++i)
+            ++shares[owners[i]];
+
+        std::cout << agents << " agents contending on AsyncMutex: "
+                  << std::chrono::duration<double, std::nano>(elapsed).count() / owners.size() << " ns/handover, "
+                  << "Jain's fairness index: " << jain_fairness(shares) << "\n";
+    }
+}
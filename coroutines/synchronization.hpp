@@ -0,0 +1,361 @@
+#ifndef SYNCHRONIZATION_HPP
+#define SYNCHRONIZATION_HPP
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+#include "intrusive_fifo.hpp"
+#include "scheduler.hpp"
+
+// Synchronization primitives for coroutines - a waiter suspends instead of blocking its thread:
+//  * AsyncMutex     - co_await mutex.scoped_lock_async() / lock_async() + unlock()
+//  * AsyncSemaphore - co_await semaphore.acquire() + release()
+//  * AsyncLatch     - co_await latch, count_down()
+// The uncontended paths are a single atomic RMW, waiters are kept in intrusive FIFOs (the nodes live in the
+// awaiting frames - no allocation per wait). A released waiter is resumed inline by the thread releasing it,
+// an Agent is put back on the run queue of its Scheduler instead (Scheduler::wake() - from any thread; agents released
+// by other threads are awaited with Scheduler::run_until_done()).
+namespace Coro
+{
+    class AsyncMutex;
+
+    class [[nodiscard]] AsyncLockGuard
+    {
+    public:
+        explicit AsyncLockGuard(AsyncMutex& mutex, std::adopt_lock_t) noexcept
+            : mutex_{&mutex}
+        { }
+
+        AsyncLockGuard(AsyncLockGuard&& other) noexcept
+            : mutex_{std::exchange(other.mutex_, nullptr)}
+        { }
+
+        AsyncLockGuard& operator=(AsyncLockGuard&&) = delete;
+
+        inline ~AsyncLockGuard();
+
+    private:
+        AsyncMutex* mutex_;
+    };
+
+    // FIFO-fair mutex (lock handed over directly to the longest waiting coroutine)
+    class AsyncMutex
+    {
+        // state_: not_locked, locked_no_waiters or a pointer to the LIFO stack of newly arrived waiters
+        static constexpr std::uintptr_t not_locked = 1;
+        static constexpr std::uintptr_t locked_no_waiters = 0;
+
+    public:
+        class LockAwaiter
+        {
+        public:
+            explicit LockAwaiter(AsyncMutex& mutex) noexcept
+                : mutex_{mutex}
+            { }
+
+            bool await_ready() noexcept { return mutex_.try_lock(); }
+
+            template <typename TPromise>
+            bool await_suspend(std::coroutine_handle<TPromise> coro_hndl) noexcept
+            {
+                waker_ = Detail::Waker{coro_hndl};
+
+                std::uintptr_t old_state = mutex_.state_.load(std::memory_order_acquire);
+                for (;;)
+                {
+                    if (old_state == not_locked)
+                    {
+                        if (mutex_.state_.compare_exchange_weak(old_state, locked_no_waiters, std::memory_order_acquire, std::memory_order_acquire))
+                            return false; // unlocked in the meantime - the lock is ours
+                    }
+                    else
+                    {
+                        next_ = reinterpret_cast<LockAwaiter*>(old_state);
+                        if (mutex_.state_.compare_exchange_weak(old_state, reinterpret_cast<std::uintptr_t>(this), std::memory_order_release, std::memory_order_acquire))
+                            return true;
+                    }
+                }
+            }
+
+            void await_resume() const noexcept { }
+
+        protected:
+            AsyncMutex& mutex_;
+
+        private:
+            friend class AsyncMutex;
+
+            Detail::Waker waker_;
+            LockAwaiter* next_ = nullptr;
+        };
+
+        class ScopedLockAwaiter : public LockAwaiter
+        {
+        public:
+            using LockAwaiter::LockAwaiter;
+
+            AsyncLockGuard await_resume() const noexcept { return AsyncLockGuard{mutex_, std::adopt_lock}; }
+        };
+
+        AsyncMutex() noexcept = default;
+
+        AsyncMutex(const AsyncMutex&) = delete;
+        AsyncMutex& operator=(const AsyncMutex&) = delete;
+
+        ~AsyncMutex()
+        {
+            assert(state_.load(std::memory_order_relaxed) == not_locked || state_.load(std::memory_order_relaxed) == locked_no_waiters);
+            assert(waiters_ == nullptr);
+        }
+
+        bool try_lock() noexcept
+        {
+            std::uintptr_t expected = not_locked;
+            return state_.compare_exchange_strong(expected, locked_no_waiters, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        // co_await mutex.lock_async(); ... mutex.unlock();
+        [[nodiscard]] LockAwaiter lock_async() noexcept { return LockAwaiter{*this}; }
+
+        // auto lock = co_await mutex.scoped_lock_async();
+        [[nodiscard]] ScopedLockAwaiter scoped_lock_async() noexcept { return ScopedLockAwaiter{*this}; }
+
+        // hands the lock over to the next waiter and wakes it up
+        void unlock()
+        {
+            assert(state_.load(std::memory_order_relaxed) != not_locked);
+
+            LockAwaiter* head = waiters_;
+            if (head == nullptr)
+            {
+                std::uintptr_t old_state = locked_no_waiters;
+                if (state_.compare_exchange_strong(old_state, not_locked, std::memory_order_release, std::memory_order_relaxed))
+                    return;
+
+                // the waiters arrived as a LIFO stack - reverse it to get them in arrival order
+                old_state = state_.exchange(locked_no_waiters, std::memory_order_acquire);
+                auto* waiter = reinterpret_cast<LockAwaiter*>(old_state);
+                do
+                {
+                    LockAwaiter* next = waiter->next_;
+                    waiter->next_ = head;
+                    head = waiter;
+                    waiter = next;
+                } while (waiter);
+            }
+
+            waiters_ = head->next_; // touched only by the owner of the lock
+            head->waker_();
+        }
+
+    private:
+        std::atomic<std::uintptr_t> state_{not_locked};
+        LockAwaiter* waiters_ = nullptr;
+    };
+
+    inline AsyncLockGuard::~AsyncLockGuard()
+    {
+        if (mutex_)
+            mutex_->unlock();
+    }
+
+    // counting semaphore - count_ below zero is the number of waiters (queued or about to be queued);
+    // a release() that gets to the queue before the waiter it owes leaves a pending wake-up for it
+    class AsyncSemaphore
+    {
+    public:
+        class AcquireAwaiter
+        {
+        public:
+            explicit AcquireAwaiter(AsyncSemaphore& semaphore) noexcept
+                : semaphore_{semaphore}
+            { }
+
+            bool await_ready() noexcept { return semaphore_.try_acquire(); }
+
+            template <typename TPromise>
+            bool await_suspend(std::coroutine_handle<TPromise> coro_hndl)
+            {
+                waker_ = Detail::Waker{coro_hndl};
+                return semaphore_.enqueue(*this);
+            }
+
+            void await_resume() const noexcept { }
+
+        private:
+            friend class AsyncSemaphore;
+            friend class Detail::IntrusiveFifo<AcquireAwaiter>;
+
+            AsyncSemaphore& semaphore_;
+            Detail::Waker waker_;
+            AcquireAwaiter* next = nullptr;
+        };
+
+        explicit AsyncSemaphore(std::ptrdiff_t initial_count) noexcept
+            : count_{initial_count}
+        {
+            assert(initial_count >= 0);
+        }
+
+        AsyncSemaphore(const AsyncSemaphore&) = delete;
+        AsyncSemaphore& operator=(const AsyncSemaphore&) = delete;
+
+        bool try_acquire() noexcept
+        {
+            std::ptrdiff_t count = count_.load(std::memory_order_relaxed);
+            while (count > 0)
+            {
+                if (count_.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] AcquireAwaiter acquire() noexcept { return AcquireAwaiter{*this}; }
+
+        // waiters are resumed on the calling thread, in FIFO order
+        void release(std::ptrdiff_t update = 1)
+        {
+            assert(update >= 0);
+
+            Detail::IntrusiveFifo<AcquireAwaiter> woken;
+
+            for (; update > 0; --update)
+            {
+                if (count_.fetch_add(1, std::memory_order_acq_rel) >= 0)
+                    continue;
+
+                std::lock_guard lk{mtx_waiters_};
+                if (AcquireAwaiter* waiter = waiters_.pop())
+                    woken.push(*waiter);
+                else
+                    ++pending_wakeups_;
+            }
+
+            // the semaphore may be gone once a waiter is resumed
+            while (AcquireAwaiter* waiter = woken.pop())
+                waiter->waker_();
+        }
+
+        // may be negative - minus the number of waiters
+        std::ptrdiff_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    private:
+        bool enqueue(AcquireAwaiter& awaiter)
+        {
+            if (count_.fetch_sub(1, std::memory_order_acquire) > 0)
+                return false;
+
+            std::lock_guard lk{mtx_waiters_};
+            if (pending_wakeups_ > 0)
+            {
+                --pending_wakeups_;
+                return false;
+            }
+
+            waiters_.push(awaiter);
+            return true;
+        }
+
+        std::atomic<std::ptrdiff_t> count_;
+        std::mutex mtx_waiters_;
+        Detail::IntrusiveFifo<AcquireAwaiter> waiters_;
+        std::size_t pending_wakeups_ = 0;
+    };
+
+    // single-use latch - co_await completes once the counter has been counted down to zero
+    class AsyncLatch
+    {
+        static constexpr std::uintptr_t released = 1; // otherwise waiters_ is the LIFO stack of waiters
+
+    public:
+        class WaitAwaiter
+        {
+        public:
+            explicit WaitAwaiter(AsyncLatch& latch) noexcept
+                : latch_{latch}
+            { }
+
+            bool await_ready() const noexcept { return latch_.try_wait(); }
+
+            template <typename TPromise>
+            bool await_suspend(std::coroutine_handle<TPromise> coro_hndl) noexcept
+            {
+                waker_ = Detail::Waker{coro_hndl};
+
+                std::uintptr_t old_state = latch_.waiters_.load(std::memory_order_acquire);
+                do
+                {
+                    if (old_state == released)
+                        return false;
+                    next_ = reinterpret_cast<WaitAwaiter*>(old_state);
+                } while (!latch_.waiters_.compare_exchange_weak(old_state, reinterpret_cast<std::uintptr_t>(this), std::memory_order_release, std::memory_order_acquire));
+
+                return true;
+            }
+
+            void await_resume() const noexcept { }
+
+        private:
+            friend class AsyncLatch;
+
+            AsyncLatch& latch_;
+            Detail::Waker waker_;
+            WaitAwaiter* next_ = nullptr;
+        };
+
+        explicit AsyncLatch(std::ptrdiff_t expected) noexcept
+            : count_{expected}
+        {
+            assert(expected >= 0);
+            if (expected == 0)
+                waiters_.store(released, std::memory_order_relaxed);
+        }
+
+        AsyncLatch(const AsyncLatch&) = delete;
+        AsyncLatch& operator=(const AsyncLatch&) = delete;
+
+        // the call that gets the counter to zero resumes all the waiters (in the order they arrived)
+        void count_down(std::ptrdiff_t update = 1)
+        {
+            const std::ptrdiff_t old_count = count_.fetch_sub(update, std::memory_order_acq_rel);
+            assert(old_count >= update);
+
+            if (old_count == update)
+            {
+                auto* waiter = reinterpret_cast<WaitAwaiter*>(waiters_.exchange(released, std::memory_order_acq_rel));
+
+                WaitAwaiter* head = nullptr;
+                while (waiter)
+                {
+                    WaitAwaiter* next = waiter->next_;
+                    waiter->next_ = head;
+                    head = waiter;
+                    waiter = next;
+                }
+
+                while (head)
+                {
+                    WaitAwaiter* next = head->next_; // the awaiter is gone once its coroutine is resumed
+                    head->waker_();
+                    head = next;
+                }
+            }
+        }
+
+        bool try_wait() const noexcept { return count_.load(std::memory_order_acquire) == 0; }
+
+        WaitAwaiter operator co_await() noexcept { return WaitAwaiter{*this}; }
+
+    private:
+        std::atomic<std::ptrdiff_t> count_;
+        std::atomic<std::uintptr_t> waiters_{0};
+    };
+} // namespace Coro
+
+#endif
@@ -0,0 +1,483 @@
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace Coro
+{
+    class OperationCancelled : public std::exception
+    {
+    public:
+        const char* what() const noexcept override { return "operation cancelled"; }
+    };
+
+    // co_await get_stop_token() - returns the stop token of the current Task
+    struct GetStopToken
+    { };
+
+    inline GetStopToken get_stop_token() noexcept { return {}; }
+
+    // co_await cancellation_point() - throws OperationCancelled when stop was requested
+    struct CancellationPoint
+    { };
+
+    inline CancellationPoint cancellation_point() noexcept { return {}; }
+
+    template <typename T = void>
+    class Task;
+
+    namespace Detail
+    {
+        // join counter shared by children of when_all/when_any - lives in the awaiting frame
+        // count = children + 1 (the awaiting coroutine arrives after all children have been started)
+        class JoinCounter
+        {
+        public:
+            static constexpr std::size_t no_winner = static_cast<std::size_t>(-1);
+
+            JoinCounter(std::size_t children, bool stop_on_success) noexcept
+                : count_{children + 1}
+                , stop_on_success_{stop_on_success}
+            { }
+
+            // awaitables are moved around by the compiler before they are awaited - never after
+            JoinCounter(JoinCounter&& other) noexcept
+                : count_{other.count_.load(std::memory_order_relaxed)}
+                , stop_on_success_{other.stop_on_success_}
+                , stop_source_{std::move(other.stop_source_)}
+            { }
+
+            std::stop_token child_token() const noexcept { return stop_source_.get_token(); }
+
+            std::stop_source& stop_source() noexcept { return stop_source_; }
+
+            std::size_t winner() const noexcept { return winner_.load(std::memory_order_acquire); }
+
+            void child_done(std::size_t index, bool failed) noexcept
+            {
+                if (stop_on_success_ && !failed)
+                {
+                    std::size_t expected = no_winner;
+                    if (winner_.compare_exchange_strong(expected, index, std::memory_order_acq_rel))
+                        stop_source_.request_stop();
+                }
+                else if (!stop_on_success_ && failed)
+                    stop_source_.request_stop(); // fail fast
+            }
+
+            // returns the coroutine to continue with - the awaiting one when the last child arrives
+            std::coroutine_handle<> arrive() noexcept
+            {
+                if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    return awaiting_;
+                return std::noop_coroutine();
+            }
+
+            // returns true when the awaiting coroutine must suspend (some children are still running)
+            bool awaiting_arrive(std::coroutine_handle<> awaiting) noexcept
+            {
+                awaiting_ = awaiting;
+                return count_.fetch_sub(1, std::memory_order_acq_rel) > 1;
+            }
+
+        private:
+            std::atomic<std::size_t> count_;
+            std::atomic<std::size_t> winner_{no_winner};
+            bool stop_on_success_;
+            std::stop_source stop_source_;
+            std::coroutine_handle<> awaiting_;
+        };
+
+        class TaskPromiseBase
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template <typename TPromise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> coro_hndl) noexcept
+                {
+                    return coro_hndl.promise().on_final_suspend();
+                }
+
+                void await_resume() const noexcept { }
+            };
+
+        public:
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+
+            void unhandled_exception() noexcept
+            {
+                exception_ = std::current_exception();
+
+                try
+                {
+                    throw;
+                }
+                catch (const OperationCancelled&)
+                {
+                    cancelled_ = true;
+                }
+                catch (...)
+                { }
+            }
+
+            const std::stop_token& stop_token() const noexcept { return stop_token_; }
+
+            void set_stop_token(std::stop_token token) noexcept { stop_token_ = std::move(token); }
+
+            void set_continuation(std::coroutine_handle<> continuation) noexcept { continuation_ = continuation; }
+
+            void set_join(JoinCounter& join, std::size_t index) noexcept
+            {
+                join_ = &join;
+                join_index_ = index;
+            }
+
+            bool failed() const noexcept { return exception_ != nullptr; }
+
+            bool cancelled() const noexcept { return cancelled_; }
+
+            template <typename TAwaitable>
+            TAwaitable&& await_transform(TAwaitable&& awaitable) noexcept
+            {
+                return std::forward<TAwaitable>(awaitable);
+            }
+
+            template <typename U>
+            Task<U>&& await_transform(Task<U>&& task)
+            {
+                if (stop_token_.stop_requested())
+                    throw OperationCancelled{};
+                return std::move(task);
+            }
+
+            auto await_transform(GetStopToken) noexcept
+            {
+                struct StopTokenAwaiter
+                {
+                    std::stop_token token;
+
+                    bool await_ready() const noexcept { return true; }
+                    void await_suspend(std::coroutine_handle<>) const noexcept { }
+                    std::stop_token await_resume() const noexcept { return token; }
+                };
+
+                return StopTokenAwaiter{stop_token_};
+            }
+
+            auto await_transform(CancellationPoint) noexcept
+            {
+                struct CancellationAwaiter
+                {
+                    const std::stop_token& token;
+
+                    bool await_ready() const noexcept { return true; }
+                    void await_suspend(std::coroutine_handle<>) const noexcept { }
+
+                    void await_resume() const
+                    {
+                        if (token.stop_requested())
+                            throw OperationCancelled{};
+                    }
+                };
+
+                return CancellationAwaiter{stop_token_};
+            }
+
+        protected:
+            void rethrow_if_failed() const
+            {
+                if (exception_)
+                    std::rethrow_exception(exception_);
+            }
+
+        private:
+            std::coroutine_handle<> on_final_suspend() noexcept
+            {
+                if (join_)
+                {
+                    join_->child_done(join_index_, failed());
+                    return join_->arrive();
+                }
+
+                return continuation_ ? continuation_ : std::noop_coroutine();
+            }
+
+            std::coroutine_handle<> continuation_;
+            JoinCounter* join_ = nullptr;
+            std::size_t join_index_ = 0;
+            std::stop_token stop_token_;
+            std::exception_ptr exception_;
+            bool cancelled_ = false;
+        };
+
+        template <typename T>
+        class TaskPromise : public TaskPromiseBase
+        {
+        public:
+            Task<T> get_return_object() noexcept;
+
+            template <typename U>
+                requires std::convertible_to<U&&, T>
+            void return_value(U&& value)
+            {
+                value_.template emplace<T>(std::forward<U>(value));
+            }
+
+            T result() &&
+            {
+                rethrow_if_failed();
+                return std::move(std::get<T>(value_));
+            }
+
+        private:
+            std::variant<std::monostate, T> value_;
+        };
+
+        template <>
+        class TaskPromise<void> : public TaskPromiseBase
+        {
+        public:
+            Task<void> get_return_object() noexcept;
+
+            void return_void() noexcept { }
+
+            void result() && { rethrow_if_failed(); }
+        };
+
+        template <typename T>
+        using ResultOf = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+    } // namespace Detail
+
+    // lazy coroutine task: starts when awaited, resumes the awaiting coroutine when done (symmetric transfer),
+    // inherits the stop token of the awaiting Task unless it already has one
+    template <typename T>
+    class [[nodiscard]] Task
+    {
+    public:
+        using promise_type = Detail::TaskPromise<T>;
+        using CoroutineHandle = std::coroutine_handle<promise_type>;
+        using value_type = T;
+
+        explicit Task(CoroutineHandle coro_hndl) noexcept
+            : coro_hndl_{coro_hndl}
+        { }
+
+        Task(Task&& other) noexcept
+            : coro_hndl_{std::exchange(other.coro_hndl_, nullptr)}
+        { }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (coro_hndl_)
+                    coro_hndl_.destroy();
+                coro_hndl_ = std::exchange(other.coro_hndl_, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            if (coro_hndl_)
+                coro_hndl_.destroy();
+        }
+
+        bool is_ready() const noexcept { return !coro_hndl_ || coro_hndl_.done(); }
+
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter : ChildAwaiter
+            {
+                T await_resume() { return std::move(this->coro_hndl_.promise()).result(); }
+            };
+
+            return Awaiter{{coro_hndl_}};
+        }
+
+        // waits for completion without retrieving the result
+        auto when_ready() noexcept
+        {
+            struct Awaiter : ChildAwaiter
+            {
+                void await_resume() const noexcept { }
+            };
+
+            return Awaiter{{coro_hndl_}};
+        }
+
+        // starts the task as a child of when_all/when_any
+        void start_joined(Detail::JoinCounter& join, std::size_t index)
+        {
+            auto& promise = coro_hndl_.promise();
+            promise.set_join(join, index);
+            promise.set_stop_token(join.child_token());
+            coro_hndl_.resume();
+        }
+
+        promise_type& promise() const noexcept { return coro_hndl_.promise(); }
+
+        Detail::ResultOf<T> take_result()
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                std::move(promise()).result();
+                return {};
+            }
+            else
+                return std::move(promise()).result();
+        }
+
+    private:
+        struct ChildAwaiter
+        {
+            CoroutineHandle coro_hndl_;
+
+            bool await_ready() const noexcept { return !coro_hndl_ || coro_hndl_.done(); }
+
+            template <typename TPromise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> awaiting) noexcept
+            {
+                auto& promise = coro_hndl_.promise();
+                promise.set_continuation(awaiting);
+
+                if constexpr (requires { awaiting.promise().stop_token(); })
+                {
+                    if (!promise.stop_token().stop_possible())
+                        promise.set_stop_token(awaiting.promise().stop_token());
+                }
+
+                return coro_hndl_;
+            }
+        };
+
+        CoroutineHandle coro_hndl_;
+    };
+
+    namespace Detail
+    {
+        template <typename T>
+        Task<T> TaskPromise<T>::get_return_object() noexcept
+        {
+            return Task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object() noexcept
+        {
+            return Task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+        }
+
+        // set() notifies while holding the lock - the waiter cannot return (& destroy the event) before set() is done
+        // with it (an atomic_flag would be accessed by notify_one() after the waiter may have seen it set)
+        class SyncWaitEvent
+        {
+        public:
+            void set()
+            {
+                std::lock_guard lock{mtx_};
+                done_ = true;
+                cv_done_.notify_one();
+            }
+
+            void wait()
+            {
+                std::unique_lock lock{mtx_};
+                cv_done_.wait(lock, [this] { return done_; });
+            }
+
+        private:
+            std::mutex mtx_;
+            std::condition_variable cv_done_;
+            bool done_ = false;
+        };
+
+        class SyncWaitTask
+        {
+        public:
+            struct promise_type
+            {
+                SyncWaitEvent* done = nullptr;
+
+                SyncWaitTask get_return_object() noexcept { return SyncWaitTask{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+                std::suspend_always initial_suspend() const noexcept { return {}; }
+
+                auto final_suspend() const noexcept
+                {
+                    struct Notifier
+                    {
+                        bool await_ready() const noexcept { return false; }
+
+                        void await_suspend(std::coroutine_handle<promise_type> coro_hndl) const noexcept
+                        {
+                            coro_hndl.promise().done->set(); // the last access to the frame & the event
+                        }
+
+                        void await_resume() const noexcept { }
+                    };
+
+                    return Notifier{};
+                }
+
+                void return_void() noexcept { }
+
+                void unhandled_exception() noexcept { std::terminate(); }
+            };
+
+            explicit SyncWaitTask(std::coroutine_handle<promise_type> coro_hndl) noexcept
+                : coro_hndl_{coro_hndl}
+            { }
+
+            SyncWaitTask(const SyncWaitTask&) = delete;
+            SyncWaitTask& operator=(const SyncWaitTask&) = delete;
+
+            ~SyncWaitTask() { coro_hndl_.destroy(); }
+
+            void run_and_wait()
+            {
+                SyncWaitEvent done;
+                coro_hndl_.promise().done = &done;
+                coro_hndl_.resume();
+                done.wait();
+            }
+
+        private:
+            std::coroutine_handle<promise_type> coro_hndl_;
+        };
+
+        template <typename T>
+        SyncWaitTask make_sync_wait_task(Task<T>& task)
+        {
+            co_await task.when_ready();
+        }
+    } // namespace Detail
+
+    // blocks the calling thread until the task completes (it may be resumed on other threads)
+    template <typename T>
+    T sync_wait(Task<T> task, std::stop_token token = {})
+    {
+        task.promise().set_stop_token(std::move(token));
+
+        Detail::SyncWaitTask waiter = Detail::make_sync_wait_task(task);
+        waiter.run_and_wait();
+
+        return std::move(task.promise()).result();
+    }
+} // namespace Coro
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef TASK_RESUMER_HPP
+#define TASK_RESUMER_HPP
+
+#include <coroutine>
+#include <exception>
+
+#include "coro_instrumentation.hpp"
+
+class TaskResumer
+{
+public:
+    struct promise_type;
+
+    using CoroutineHandle = std::coroutine_handle<promise_type>;
+
+    struct promise_type : Coro::Instrumentation::PromiseInstrumentation
+    {
+        TaskResumer get_return_object()
+        {
+            return TaskResumer{CoroutineHandle::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        void return_void()
+        { }
+
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+
+    TaskResumer(CoroutineHandle coro_hndl) : coro_hndl_{coro_hndl}
+    {
+    }
+
+    TaskResumer(const TaskResumer&) = delete;
+    TaskResumer& operator=(const TaskResumer&) = delete;
+    TaskResumer(TaskResumer&&) = delete;
+    TaskResumer& operator=(TaskResumer&&) = delete;
+
+    ~TaskResumer() noexcept
+    {
+        if (coro_hndl_)
+            coro_hndl_.destroy();
+    }
+
+    bool resume() const
+    {
+        if (!coro_hndl_ || coro_hndl_.done())
+            return false;
+
+        Coro::Instrumentation::instrumented_resume(coro_hndl_); // resuming suspended coroutine
+
+        return !coro_hndl_.done();
+    }
+private:
+    CoroutineHandle coro_hndl_;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <vector>
+
+#include "batch_view.hpp"
+
+namespace
+{
+    template <typename TBatches>
+    std::vector<std::vector<int>> to_vectors(TBatches&& batches)
+    {
+        std::vector<std::vector<int>> result;
+        for (std::span<const int> batch : batches)
+            result.emplace_back(batch.begin(), batch.end());
+        return result;
+    }
+
+    // the work done per element in the benchmarks - a polynomial approximation of exp(x)
+    float kernel(float x)
+    {
+        return 1.0f + x * (1.0f + x * (0.5f + x * (1.0f / 6 + x * (1.0f / 24 + x * (1.0f / 120 + x * (1.0f / 720 + x * (1.0f / 5040)))))));
+    }
+
+    // a fixed-size loop - vectorized by the compiler
+    template <std::size_t N>
+    float sum_kernel(std::span<const float, N> batch)
+    {
+        std::array<float, N> partial{};
+        for (std::size_t i = 0; i < N; ++i)
+            partial[i] = kernel(batch[i]);
+        return std::accumulate(partial.begin(), partial.end(), 0.0f);
+    }
+
+    template <std::size_t N>
+    float sum_batches(auto&& batches)
+    {
+        float sum = 0.0f;
+        for (std::span<const float> batch : batches)
+        {
+            if (batch.size() == N)
+                sum += sum_kernel(batch.template first<N>());
+            else
+                for (float x : batch)
+                    sum += kernel(x);
+        }
+        return sum;
+    }
+} // namespace
+
+TEST_CASE("batch - contiguous source is split in place")
+{
+    const std::vector<int> data = {1, 2, 3, 4, 5, 6, 7};
+
+    auto batches = data | Views::batch<3>;
+    static_assert(std::ranges::forward_range<decltype(batches)>);
+    static_assert(std::ranges::sized_range<decltype(batches)>);
+
+    CHECK(batches.size() == 3);
+    CHECK(to_vectors(batches) == std::vector<std::vector<int>>{{1, 2, 3}, {4, 5, 6}, {7}});
+    CHECK((*batches.begin()).data() == data.data());
+
+    CHECK(std::ranges::empty(std::vector<int>{} | Views::batch<4>));
+    CHECK(to_vectors(std::vector{1, 2, 3, 4} | Views::batch<2>) == std::vector<std::vector<int>>{{1, 2}, {3, 4}});
+}
+
+TEST_CASE("batch - other sources are staged through a buffer")
+{
+    SECTION("pipeline of views")
+    {
+        auto data = std::views::iota(1)
+            | std::views::take(20)
+            | std::views::filter([](int x) { return x % 2 == 0; })
+            | std::views::transform([](int x) { return x * x; })
+            | std::views::reverse;
+
+        auto batches = data | Views::batch<4>;
+        static_assert(std::ranges::input_range<decltype(batches)>);
+        static_assert(!std::ranges::forward_range<decltype(batches)>);
+
+        CHECK(to_vectors(batches) == std::vector<std::vector<int>>{{400, 324, 256, 196}, {144, 100, 64, 36}, {16, 4}});
+    }
+
+    SECTION("list")
+    {
+        const std::list<int> lst = {1, 2, 3, 4, 5};
+        CHECK(to_vectors(Views::batch<2>(lst)) == std::vector<std::vector<int>>{{1, 2}, {3, 4}, {5}});
+    }
+
+    SECTION("input stream")
+    {
+        std::istringstream in{"1 2 3 4 5 6"};
+        CHECK(to_vectors(std::views::istream<int>(in) | Views::batch<3>) == std::vector<std::vector<int>>{{1, 2, 3}, {4, 5, 6}});
+    }
+}
+
+TEST_CASE("batch - benchmarks", "[.][benchmark]")
+{
+    constexpr int size = 1'000'000;
+    std::vector<float> data(size);
+    std::iota(data.begin(), data.end(), 0.0f);
+    for (float& x : data)
+        x = std::sin(x);
+
+    auto pipeline = [&] {
+        return data | std::views::filter([](float x) { return x > -0.9f; }) | std::views::transform([](float x) { return x * 2.0f; });
+    };
+
+    BENCHMARK("pipeline - element-wise")
+    {
+        float sum = 0.0f;
+        for (float x : pipeline())
+            sum += kernel(x);
+        return sum;
+    };
+
+    BENCHMARK("pipeline - batch<16>")
+    {
+        return sum_batches<16>(pipeline() | Views::batch<16>);
+    };
+
+    auto generated = [&] {
+        return std::views::iota(0, size) | std::views::transform([](int i) { return static_cast<float>(i % 1000) * 0.001f; });
+    };
+
+    BENCHMARK("iota | transform - element-wise")
+    {
+        float sum = 0.0f;
+        for (float x : generated())
+            sum += kernel(x);
+        return sum;
+    };
+
+    BENCHMARK("iota | transform - batch<16>")
+    {
+        return sum_batches<16>(generated() | Views::batch<16>);
+    };
+
+    BENCHMARK("vector - element-wise")
+    {
+        float sum = 0.0f;
+        for (float x : data)
+            sum += kernel(x);
+        return sum;
+    };
+
+    BENCHMARK("vector - batch<16>")
+    {
+        return sum_batches<16>(data | Views::batch<16>);
+    };
+}
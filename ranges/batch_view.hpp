@@ -0,0 +1,224 @@
+#ifndef BATCH_VIEW_HPP
+#define BATCH_VIEW_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <utility>
+
+// rng | Views::batch<N> - the elements of any input range in batches of N (the last one may be shorter)
+// handed out as std::span<const T>, so a consumer can process a whole batch with a fixed-size (vectorizable) loop:
+//
+//   for (std::span<const float> batch : rng | Views::batch<16>)
+//   {
+//       if (batch.size() == 16)
+//           simd_kernel(batch.first<16>()); // std::span<const float, 16>
+//       else
+//           scalar_tail(batch);
+//   }
+//
+// A contiguous sized range is split in place (forward range of spans into it); the elements of any other
+// range are staged through a buffer of N elements inside of the view (input range - a span is valid until ++).
+namespace Views
+{
+    namespace Detail
+    {
+        template <typename V>
+        concept Batchable = std::ranges::view<V> && std::ranges::input_range<V> && std::default_initializable<std::ranges::range_value_t<V>>;
+
+        template <typename V>
+        concept ContiguousSource = Batchable<V> && std::ranges::contiguous_range<const V> && std::ranges::sized_range<const V>;
+    } // namespace Detail
+
+    // staging through the internal buffer
+    template <Detail::Batchable V, std::size_t N>
+    class BatchView : public std::ranges::view_interface<BatchView<V, N>>
+    {
+        static_assert(N > 0);
+
+        using T = std::ranges::range_value_t<V>;
+
+    public:
+        class iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::span<const T>;
+            using difference_type = std::ptrdiff_t;
+
+            explicit iterator(BatchView& parent) noexcept
+                : parent_{&parent}
+            { }
+
+            iterator(iterator&&) = default;
+            iterator& operator=(iterator&&) = default;
+
+            std::span<const T> operator*() const noexcept { return {parent_->buffer_.data(), parent_->size_}; }
+
+            iterator& operator++()
+            {
+                parent_->fill();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept { return it.at_end(); }
+
+        private:
+            bool at_end() const noexcept { return parent_->size_ == 0; }
+
+            BatchView* parent_;
+        };
+
+        BatchView() = default;
+
+        explicit BatchView(V base)
+            : base_{std::move(base)}
+        { }
+
+        V base() const& requires std::copy_constructible<V> { return base_; }
+
+        iterator begin()
+        {
+            current_.emplace(std::ranges::begin(base_));
+            fill();
+            return iterator{*this};
+        }
+
+        std::default_sentinel_t end() const noexcept { return {}; }
+
+    private:
+        void fill()
+        {
+            // the source iterator & the count in locals - kept in registers while the buffer is written
+            auto current = std::move(*current_);
+            const auto last = std::ranges::end(base_);
+
+            if constexpr (std::ranges::random_access_range<V> && std::sized_sentinel_for<std::ranges::sentinel_t<V>, std::ranges::iterator_t<V>>)
+            {
+                if (last - current >= static_cast<std::ptrdiff_t>(N)) // a whole batch - a fixed-size loop the compiler can vectorize
+                {
+                    for (std::size_t i = 0; i < N; ++i)
+                        buffer_[i] = current[i];
+                    *current_ = current + N;
+                    size_ = N;
+                    return;
+                }
+            }
+
+            std::size_t size = 0;
+            while (current != last)
+            {
+                buffer_[size++] = *current;
+                ++current;
+                if (size == N)
+                    break;
+            }
+
+            *current_ = std::move(current);
+            size_ = size;
+        }
+
+        V base_ = V();
+        std::optional<std::ranges::iterator_t<V>> current_; // set by begin() - an input range is iterated once
+        std::array<T, N> buffer_{};
+        std::size_t size_ = 0;
+    };
+
+    // a contiguous source - batches are spans into it, no copies
+    template <Detail::ContiguousSource V, std::size_t N>
+    class BatchView<V, N> : public std::ranges::view_interface<BatchView<V, N>>
+    {
+        static_assert(N > 0);
+
+        using T = std::ranges::range_value_t<V>;
+
+    public:
+        class iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag; // operator* returns a prvalue
+            using value_type = std::span<const T>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(const T* pos, const T* end) noexcept
+                : pos_{pos}
+                , end_{end}
+            { }
+
+            std::span<const T> operator*() const noexcept { return {pos_, batch_size()}; }
+
+            iterator& operator++() noexcept
+            {
+                pos_ += batch_size();
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                iterator prev = *this;
+                ++*this;
+                return prev;
+            }
+
+            bool operator==(const iterator& other) const noexcept { return pos_ == other.pos_; }
+
+        private:
+            std::size_t batch_size() const noexcept { return std::min<std::size_t>(N, end_ - pos_); }
+
+            const T* pos_ = nullptr;
+            const T* end_ = nullptr;
+        };
+
+        BatchView() = default;
+
+        explicit BatchView(V base)
+            : base_{std::move(base)}
+        { }
+
+        V base() const& requires std::copy_constructible<V> { return base_; }
+
+        iterator begin() const noexcept { return iterator{std::ranges::data(base_), data_end()}; }
+
+        iterator end() const noexcept { return iterator{data_end(), data_end()}; }
+
+        std::size_t size() const noexcept { return (std::ranges::size(base_) + N - 1) / N; }
+
+    private:
+        const T* data_end() const noexcept { return std::ranges::data(base_) + std::ranges::size(base_); }
+
+        V base_ = V();
+    };
+
+    template <std::size_t N>
+    struct BatchAdaptor
+    {
+        template <std::ranges::viewable_range R>
+            requires std::ranges::input_range<R>
+        auto operator()(R&& rng) const
+        {
+            return BatchView<std::views::all_t<R>, N>{std::views::all(std::forward<R>(rng))};
+        }
+
+        template <std::ranges::viewable_range R>
+            requires std::ranges::input_range<R>
+        friend auto operator|(R&& rng, const BatchAdaptor& adaptor)
+        {
+            return adaptor(std::forward<R>(rng));
+        }
+    };
+
+    template <std::size_t N>
+    inline constexpr BatchAdaptor<N> batch{};
+} // namespace Views
+
+#endif
@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random.hpp>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bplus_tree_map.hpp"
+
+using namespace std::literals;
+
+namespace
+{
+    // small nodes - a few hundred elements make a tree of several levels
+    template <typename TKey, typename TValue>
+    using SmallNodeMap = Containers::BPlusTreeMap<TKey, TValue, std::less<TKey>, 8>;
+
+    template <typename TMap, typename TKey, typename TValue>
+    void check_same(const TMap& map, const std::map<TKey, TValue>& expected)
+    {
+        REQUIRE(map.size() == expected.size());
+        CHECK(std::ranges::equal(map.keys(), expected | std::views::keys));
+        CHECK(std::ranges::equal(map.values(), expected | std::views::values));
+        CHECK(std::ranges::equal(map | std::views::reverse | std::views::keys, expected | std::views::reverse | std::views::keys));
+    }
+
+    // the elements in random order with a duplicate of every 4th
+    template <typename TKey>
+    std::vector<TKey> shuffled_keys(std::size_t count, std::uint32_t seed)
+    {
+        std::vector<TKey> keys(count);
+        std::iota(keys.begin(), keys.end(), TKey{});
+        for (std::size_t i = 0; i < count; i += 4)
+            keys.push_back(keys[i]);
+
+        helpers::random::PCG rnd{seed};
+        for (std::size_t i = keys.size() - 1; i > 0; --i)
+            std::swap(keys[i], keys[rnd() % (i + 1)]);
+        return keys;
+    }
+} // namespace
+
+TEST_CASE("BPlusTreeMap - the API of std::map")
+{
+    Containers::BPlusTreeMap<int, std::string> dict = {{3, "three"}, {1, "one"}, {2, "two"}};
+
+    static_assert(std::ranges::bidirectional_range<decltype(dict)>);
+    static_assert(std::ranges::bidirectional_range<const decltype(dict)>);
+
+    SECTION("lookup")
+    {
+        CHECK(dict.size() == 3);
+        CHECK(dict.find(2)->second == "two");
+        CHECK(dict.find(4) == dict.end());
+        CHECK(dict.contains(1));
+        CHECK(dict.count(5) == 0);
+        CHECK(dict.at(3) == "three");
+        CHECK_THROWS_AS(dict.at(0), std::out_of_range);
+        CHECK(dict.lower_bound(2).key() == 2);
+        CHECK(dict.upper_bound(2).key() == 3);
+        CHECK(dict.upper_bound(3) == dict.end());
+    }
+
+    SECTION("insertion")
+    {
+        auto [it, inserted] = dict.insert({0, "zero"});
+        CHECK(inserted);
+        CHECK(it->first == 0);
+        CHECK(dict.begin() == it);
+
+        CHECK_FALSE(dict.try_emplace(1, "ONE").second);
+        CHECK(dict[1] == "one");
+        CHECK_FALSE(dict.insert_or_assign(1, "ONE").second);
+        CHECK(dict[1] == "ONE");
+
+        dict[5] = "five";
+        CHECK(std::ranges::equal(dict.keys(), std::vector{0, 1, 2, 3, 5}));
+    }
+
+    SECTION("structured bindings & views of std::map")
+    {
+        for (auto [key, value] : dict)
+            value += std::to_string(key);
+
+        CHECK(std::ranges::equal(dict | std::views::values, std::vector{"one1"s, "two2"s, "three3"s}));
+        CHECK(std::ranges::equal(std::as_const(dict) | std::views::elements<0>, std::vector{1, 2, 3}));
+        CHECK(std::vector<std::pair<int, std::string>>(dict.begin(), dict.end()).back() == std::pair{3, "three3"s});
+    }
+
+    SECTION("erasure")
+    {
+        CHECK(dict.erase(2) == 1);
+        CHECK(dict.erase(2) == 0);
+        CHECK(dict.erase(dict.begin())->first == 3);
+        CHECK(dict.erase(3) == 1);
+        CHECK(dict.empty());
+        CHECK(dict.begin() == dict.end());
+    }
+
+    SECTION("copy, move & comparison")
+    {
+        auto copy = dict;
+        CHECK(copy == dict);
+        copy[2] = "TWO";
+        CHECK(copy != dict);
+
+        auto moved = std::move(copy);
+        CHECK(moved.at(2) == "TWO");
+        CHECK(copy.empty());
+    }
+}
+
+TEST_CASE("BPlusTreeMap - many levels against std::map")
+{
+    SmallNodeMap<int, int> map;
+    std::map<int, int> expected;
+
+    const std::vector<int> keys = shuffled_keys<int>(5000, 42);
+    for (int key : keys)
+    {
+        const bool inserted = map.try_emplace(key, -key).second;
+        CHECK(inserted == expected.try_emplace(key, -key).second);
+    }
+
+    CHECK(map.height() >= 4);
+    check_same(map, expected);
+
+    for (int key : {-1, 0, 17, 2500, 4999, 5000})
+    {
+        CHECK(map.contains(key) == expected.contains(key));
+        CHECK((map.lower_bound(key) == map.end()) == (expected.lower_bound(key) == expected.end()));
+        if (map.lower_bound(key) != map.end())
+            CHECK(map.lower_bound(key).key() == expected.lower_bound(key)->first);
+    }
+
+    SECTION("erasure - borrowing from & merging with the siblings")
+    {
+        helpers::random::PCG rnd{7};
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            const int key = static_cast<int>(rnd() % 5200);
+            CHECK(map.erase(key) == expected.erase(key));
+
+            if (i % 500 == 0)
+                check_same(map, expected);
+        }
+        check_same(map, expected);
+
+        for (int key : keys)
+            map.erase(key);
+        CHECK(map.empty());
+        CHECK(map.height() == 0);
+    }
+}
+
+TEST_CASE("BPlusTreeMap - keys of all kinds")
+{
+    SECTION("unsigned, 64-bit & floating-point keys - the SIMD search")
+    {
+        Containers::BPlusTreeMap<std::uint32_t, int> unsigned_keys;
+        Containers::BPlusTreeMap<std::int64_t, int> wide_keys;
+        Containers::BPlusTreeMap<double, int> real_keys;
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            unsigned_keys[std::uint32_t{0xFFFF'FFF0u} - 3 * i] = i;
+            unsigned_keys[3 * i] = i;
+            wide_keys[(std::int64_t{i} - 500) << 40] = i;
+            real_keys[(i - 500) / 8.0] = i;
+        }
+
+        CHECK(std::ranges::is_sorted(unsigned_keys.keys()));
+        CHECK(unsigned_keys.lower_bound(0x8000'0000u).key() == 0xFFFF'FFF0u - 3 * 999);
+        CHECK(std::ranges::is_sorted(wide_keys.keys()));
+        CHECK(wide_keys.at(-(std::int64_t{500} << 40)) == 0);
+        CHECK(real_keys.at(-62.5) == 0);
+        CHECK(real_keys.upper_bound(0.0).key() == 0.125);
+    }
+
+    SECTION("strings & a comparator")
+    {
+        Containers::BPlusTreeMap<std::string, int, std::greater<>> words;
+        for (int i = 0; i < 300; ++i)
+            words.try_emplace("word" + std::to_string(i), i);
+
+        CHECK(words.begin()->first == "word99");
+        CHECK(words.at("word150") == 150);
+        CHECK(std::ranges::is_sorted(words.keys(), std::greater<>{}));
+    }
+}
+
+TEST_CASE("BPlusTreeMap - ascending keys fill the leaves")
+{
+    SmallNodeMap<int, int> map;
+    for (int i = 0; i < 8 * 64; ++i)
+        map.try_emplace(map.end(), i, i);
+
+    // 64 full leaves of 8 elements
+    CHECK(map.height() == 2);
+    CHECK(std::ranges::equal(map.keys(), std::views::iota(0, 8 * 64)));
+}
+
+TEST_CASE("BPlusTreeMap - benchmarks", "[.][benchmark]")
+{
+    constexpr int count = 10'000'000;
+    const std::vector<int> keys = shuffled_keys<int>(count, 1);
+
+    std::map<int, int> std_map;
+    Containers::BPlusTreeMap<int, int> tree_map;
+
+    auto time = [](const char* name, auto action) {
+        const auto start = std::chrono::steady_clock::now();
+        action();
+        std::cout << name << ": " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms\n";
+    };
+
+    time("std::map - insert 10M in random order", [&] {
+        for (int key : keys)
+            std_map.try_emplace(key, key);
+    });
+
+    time("BPlusTreeMap - insert 10M in random order", [&] {
+        for (int key : keys)
+            tree_map.try_emplace(key, key);
+    });
+
+    BENCHMARK("std::map - find 1M")
+    {
+        long long sum = 0;
+        for (int i = 0; i < 1'000'000; ++i)
+            sum += std_map.find(keys[i])->second;
+        return sum;
+    };
+
+    BENCHMARK("BPlusTreeMap - find 1M")
+    {
+        long long sum = 0;
+        for (int i = 0; i < 1'000'000; ++i)
+            sum += tree_map.find(keys[i]).value();
+        return sum;
+    };
+
+    BENCHMARK("std::map - sum of views::values")
+    {
+        long long sum = 0;
+        for (int value : std_map | std::views::values)
+            sum += value;
+        return sum;
+    };
+
+    BENCHMARK("BPlusTreeMap - sum of values()")
+    {
+        long long sum = 0;
+        for (int value : tree_map.values())
+            sum += value;
+        return sum;
+    };
+}
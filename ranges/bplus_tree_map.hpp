@@ -0,0 +1,971 @@
+#ifndef BPLUS_TREE_MAP_HPP
+#define BPLUS_TREE_MAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BPLUS_TREE_MAP_X86 1
+#endif
+
+// Containers::BPlusTreeMap<Key, Value> - an ordered map with the core API of std::map (find, lower_bound,
+// upper_bound, insert, try_emplace, operator[], at, erase, ordered iteration) stored in a B+tree:
+//  * wide nodes - the keys of a node are contiguous (256 bytes of keys per node by default); a node is
+//    searched with one linear SIMD pass (32/64-bit integral & floating-point keys ordered with std::less)
+//    instead of a binary search with unpredictable branches
+//  * the elements are in the leaves only - keys & values in separate arrays, the leaves are linked,
+//    so iteration (map.keys(), map.values(), std::views::keys/values) walks arrays leaf by leaf
+//  * a few pointers per node instead of three pointers & a color per element
+//  * appending in ascending order fills the leaves completely
+// As in std::flat_map the elements are not stored as pairs: value_type is std::pair<Key, Value>, an iterator
+// yields a pair of references (std::pair<const Key&, Value&>). Unlike std::map, insert & erase invalidate
+// the iterators and the references to the elements.
+namespace Containers
+{
+    namespace Detail
+    {
+        // a pair of references to the key & the value of an element (a proxy - the element is not a pair);
+        // converts from & to std::pair<Key, Value>, so the iterators are std::bidirectional_iterator
+        template <typename TKey, typename TValue, bool Const>
+        struct ElementRef : std::pair<const TKey&, std::conditional_t<Const, const TValue&, TValue&>>
+        {
+            using Base = std::pair<const TKey&, std::conditional_t<Const, const TValue&, TValue&>>;
+            using Base::Base;
+
+            ElementRef(const ElementRef<TKey, TValue, !Const>& other) requires Const
+                : Base{other.first, other.second}
+            { }
+
+            ElementRef(std::pair<TKey, TValue>& element)
+                : Base{element.first, element.second}
+            { }
+
+            ElementRef(const std::pair<TKey, TValue>& element) requires Const
+                : Base{element.first, element.second}
+            { }
+
+            operator std::pair<TKey, TValue>() const { return {this->first, this->second}; }
+        };
+
+        // uninitialized room for N objects
+        template <typename T, std::size_t N>
+        struct Slots
+        {
+            alignas(T) std::byte bytes[N * sizeof(T)];
+
+            T* data() noexcept { return std::launder(reinterpret_cast<T*>(bytes)); }
+
+            const T* data() const noexcept { return std::launder(reinterpret_cast<const T*>(bytes)); }
+
+            T& operator[](std::size_t index) noexcept { return data()[index]; }
+
+            const T& operator[](std::size_t index) const noexcept { return data()[index]; }
+        };
+
+        // items [0, size) are alive - the item at pos is inserted, the ones after it are moved to the right
+        template <typename T>
+        void insert_at(T* items, std::size_t size, std::size_t pos, T&& item)
+        {
+            if (pos == size)
+            {
+                std::construct_at(items + size, std::move(item));
+                return;
+            }
+
+            std::construct_at(items + size, std::move(items[size - 1]));
+            std::move_backward(items + pos, items + size - 1, items + size);
+            items[pos] = std::move(item);
+        }
+
+        template <typename T>
+        void erase_at(T* items, std::size_t size, std::size_t pos)
+        {
+            std::move(items + pos + 1, items + size, items + pos);
+            std::destroy_at(items + size - 1);
+        }
+
+        // count items moved to uninitialized room (the room after the alive items of a node)
+        template <typename T>
+        void relocate(T* from, std::size_t count, T* to)
+        {
+            std::uninitialized_move_n(from, count, to);
+            std::destroy_n(from, count);
+        }
+
+        // 256 bytes of keys - a multiple of 8 keys
+        template <typename TKey>
+        inline constexpr std::size_t default_node_capacity = std::max<std::size_t>(8, 256 / sizeof(TKey) / 8 * 8);
+
+        template <typename TKey, typename TCompare>
+        concept SimdSearchable = (std::same_as<TCompare, std::less<TKey>> || std::same_as<TCompare, std::less<>> || std::same_as<TCompare, std::ranges::less>)
+            && ((std::integral<TKey> && !std::same_as<TKey, bool> && (sizeof(TKey) == 4 || sizeof(TKey) == 8))
+                || std::same_as<TKey, float> || std::same_as<TKey, double>);
+
+        // the position of key in the sorted keys [0, size): the number of keys less than (less or equal to) it
+        template <typename TKey>
+        using KeyRank = std::size_t (*)(const TKey* keys, std::size_t size, TKey key) noexcept;
+
+        template <typename TKey, bool OrEqual>
+        std::size_t rank_scalar(const TKey* keys, std::size_t size, TKey key) noexcept
+        {
+            if constexpr (OrEqual)
+                return std::upper_bound(keys, keys + size, key) - keys;
+            else
+                return std::lower_bound(keys, keys + size, key) - keys;
+        }
+
+#ifdef BPLUS_TREE_MAP_X86
+        // all the keys of a node compared at once: the comparison masks of whole vectors are counted, the bits
+        // past size masked off - the room after the keys must be readable up to a whole vector (the capacity
+        // of a node is a multiple of the vector width; the nodes are zero-initialized)
+        template <typename TKey, bool OrEqual>
+        __attribute__((target("avx2,popcnt"))) std::size_t rank_avx2(const TKey* keys, std::size_t size, TKey key) noexcept
+        {
+            constexpr std::size_t lanes = 32 / sizeof(TKey);
+
+            std::size_t rank = 0;
+            for (std::size_t offset = 0; offset < size; offset += lanes)
+            {
+                unsigned mask;
+                if constexpr (std::same_as<TKey, float>)
+                {
+                    const __m256 items = _mm256_loadu_ps(keys + offset);
+                    const __m256 needle = _mm256_set1_ps(key);
+                    mask = _mm256_movemask_ps(_mm256_cmp_ps(items, needle, OrEqual ? _CMP_LE_OQ : _CMP_LT_OQ));
+                }
+                else if constexpr (std::same_as<TKey, double>)
+                {
+                    const __m256d items = _mm256_loadu_pd(keys + offset);
+                    const __m256d needle = _mm256_set1_pd(key);
+                    mask = _mm256_movemask_pd(_mm256_cmp_pd(items, needle, OrEqual ? _CMP_LE_OQ : _CMP_LT_OQ));
+                }
+                else
+                {
+                    // unsigned keys compared as signed ones with the sign bits flipped
+                    __m256i items = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + offset));
+                    __m256i needle;
+                    if constexpr (sizeof(TKey) == 4)
+                    {
+                        needle = _mm256_set1_epi32(static_cast<std::int32_t>(key));
+                        if constexpr (std::is_unsigned_v<TKey>)
+                        {
+                            const __m256i sign = _mm256_set1_epi32(std::numeric_limits<std::int32_t>::min());
+                            items = _mm256_xor_si256(items, sign);
+                            needle = _mm256_xor_si256(needle, sign);
+                        }
+                        // item < key, or !(item > key)
+                        const __m256i result = OrEqual ? _mm256_cmpgt_epi32(items, needle) : _mm256_cmpgt_epi32(needle, items);
+                        mask = _mm256_movemask_ps(_mm256_castsi256_ps(result));
+                    }
+                    else
+                    {
+                        needle = _mm256_set1_epi64x(static_cast<std::int64_t>(key));
+                        if constexpr (std::is_unsigned_v<TKey>)
+                        {
+                            const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+                            items = _mm256_xor_si256(items, sign);
+                            needle = _mm256_xor_si256(needle, sign);
+                        }
+                        const __m256i result = OrEqual ? _mm256_cmpgt_epi64(items, needle) : _mm256_cmpgt_epi64(needle, items);
+                        mask = _mm256_movemask_pd(_mm256_castsi256_pd(result));
+                    }
+
+                    if constexpr (OrEqual)
+                        mask = ~mask & ((1u << lanes) - 1);
+                }
+
+                const std::size_t valid = std::min(size - offset, lanes);
+                rank += std::popcount(mask & ((1u << valid) - 1));
+            }
+
+            return rank;
+        }
+
+        template <typename TKey, bool OrEqual>
+        inline const KeyRank<TKey> rank_simd = [] {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") ? &rank_avx2<TKey, OrEqual> : &rank_scalar<TKey, OrEqual>;
+        }();
+#endif
+    } // namespace Detail
+
+    template <typename TKey, typename TValue, typename TCompare = std::less<TKey>, std::size_t Capacity = Detail::default_node_capacity<TKey>>
+    class BPlusTreeMap
+    {
+        static_assert(Capacity >= 4 && Capacity % 2 == 0);
+        static_assert(!Detail::SimdSearchable<TKey, TCompare> || Capacity % (32 / sizeof(TKey)) == 0, "the SIMD search reads whole vectors of keys");
+
+        static constexpr std::size_t min_size = Capacity / 2; // fewer items in a node (except the root) - a rebalance
+        static constexpr std::size_t max_height = 64;
+
+        // zero-initialized ( new Leaf() ) - the room after the keys is readable by the SIMD search
+        struct Leaf
+        {
+            std::size_t size;
+            Leaf* prev;
+            Leaf* next;
+            Detail::Slots<TKey, Capacity> keys;
+            Detail::Slots<TValue, Capacity> values;
+        };
+
+        // keys[i] - the smallest key of children[i + 1] when it was created: children[i] < keys[i] <= children[i + 1];
+        // the children are Inner nodes above level 1, Leaf nodes on level 1
+        struct Inner
+        {
+            std::size_t size; // of the keys
+            Detail::Slots<TKey, Capacity> keys;
+            std::array<void*, Capacity + 1> children;
+        };
+
+        struct PathStep
+        {
+            Inner* node;
+            std::size_t child;
+        };
+
+        using Path = std::array<PathStep, max_height>;
+
+        template <bool Const>
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::bidirectional_iterator_tag;
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = std::pair<TKey, TValue>;
+            using reference = Detail::ElementRef<TKey, TValue, Const>;
+            using difference_type = std::ptrdiff_t;
+
+            struct pointer
+            {
+                reference element;
+
+                const reference* operator->() const noexcept { return &element; }
+            };
+
+            Iterator() = default;
+
+            Iterator(Leaf* leaf, std::size_t index) noexcept
+                : leaf_{leaf}
+                , index_{index}
+            { }
+
+            Iterator(const Iterator<!Const>& other) noexcept requires Const
+                : leaf_{other.leaf_}
+                , index_{other.index_}
+            { }
+
+            reference operator*() const noexcept { return {leaf_->keys[index_], leaf_->values[index_]}; }
+
+            pointer operator->() const noexcept { return {**this}; }
+
+            const TKey& key() const noexcept { return leaf_->keys[index_]; }
+
+            std::conditional_t<Const, const TValue&, TValue&> value() const noexcept { return leaf_->values[index_]; }
+
+            // past the last element of a leaf - the first one of the next leaf; past the last element of the map - end()
+            Iterator& operator++() noexcept
+            {
+                if (++index_ == leaf_->size && leaf_->next)
+                {
+                    leaf_ = leaf_->next;
+                    index_ = 0;
+                }
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept
+            {
+                Iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            Iterator& operator--() noexcept
+            {
+                if (index_ == 0)
+                {
+                    leaf_ = leaf_->prev;
+                    index_ = leaf_->size;
+                }
+                --index_;
+                return *this;
+            }
+
+            Iterator operator--(int) noexcept
+            {
+                Iterator it = *this;
+                --*this;
+                return it;
+            }
+
+            bool operator==(const Iterator&) const = default;
+
+        private:
+            friend BPlusTreeMap;
+            friend Iterator<!Const>;
+
+            Leaf* leaf_ = nullptr;
+            std::size_t index_ = 0;
+        };
+
+    public:
+        using key_type = TKey;
+        using mapped_type = TValue;
+        using value_type = std::pair<TKey, TValue>;
+        using key_compare = TCompare;
+        using reference = Detail::ElementRef<TKey, TValue, false>;
+        using const_reference = Detail::ElementRef<TKey, TValue, true>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        static constexpr std::size_t node_capacity = Capacity;
+
+        BPlusTreeMap() = default;
+
+        explicit BPlusTreeMap(const TCompare& compare)
+            : compare_{compare}
+        { }
+
+        BPlusTreeMap(std::initializer_list<value_type> items, const TCompare& compare = TCompare{})
+            : compare_{compare}
+        {
+            for (const value_type& item : items)
+                insert(item);
+        }
+
+        BPlusTreeMap(const BPlusTreeMap& other)
+            : compare_{other.compare_}
+        {
+            // in order - every element appended to the last leaf
+            for (const auto& [key, value] : other)
+                try_emplace(end(), key, value);
+        }
+
+        BPlusTreeMap(BPlusTreeMap&& other) noexcept
+            : compare_{std::move(other.compare_)}
+            , root_{std::exchange(other.root_, nullptr)}
+            , first_{std::exchange(other.first_, nullptr)}
+            , last_{std::exchange(other.last_, nullptr)}
+            , height_{std::exchange(other.height_, 0)}
+            , size_{std::exchange(other.size_, 0)}
+        { }
+
+        BPlusTreeMap& operator=(const BPlusTreeMap& other)
+        {
+            if (this != &other)
+            {
+                BPlusTreeMap temp{other};
+                swap(temp);
+            }
+            return *this;
+        }
+
+        BPlusTreeMap& operator=(BPlusTreeMap&& other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                swap(other);
+            }
+            return *this;
+        }
+
+        ~BPlusTreeMap() { clear(); }
+
+        void swap(BPlusTreeMap& other) noexcept
+        {
+            using std::swap;
+            swap(compare_, other.compare_);
+            swap(root_, other.root_);
+            swap(first_, other.first_);
+            swap(last_, other.last_);
+            swap(height_, other.height_);
+            swap(size_, other.size_);
+        }
+
+        friend void swap(BPlusTreeMap& lhs, BPlusTreeMap& rhs) noexcept { lhs.swap(rhs); }
+
+        size_type size() const noexcept { return size_; }
+
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+        key_compare key_comp() const { return compare_; }
+
+        // the number of levels of inner nodes above the leaves
+        std::size_t height() const noexcept { return height_; }
+
+        iterator begin() noexcept { return {first_, 0}; }
+
+        iterator end() noexcept { return last_ ? iterator{last_, last_->size} : iterator{}; }
+
+        const_iterator begin() const noexcept { return {first_, 0}; }
+
+        const_iterator end() const noexcept { return last_ ? const_iterator{last_, last_->size} : const_iterator{}; }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        auto keys() const
+        {
+            return std::ranges::subrange{begin(), end()} | std::views::transform([](const_reference element) -> const TKey& { return element.first; });
+        }
+
+        auto values()
+        {
+            return std::ranges::subrange{begin(), end()} | std::views::transform([](reference element) -> TValue& { return element.second; });
+        }
+
+        auto values() const
+        {
+            return std::ranges::subrange{begin(), end()} | std::views::transform([](const_reference element) -> const TValue& { return element.second; });
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // lookup
+
+        iterator find(const TKey& key) { return mutable_iterator(std::as_const(*this).find(key)); }
+
+        const_iterator find(const TKey& key) const
+        {
+            if (!root_)
+                return end();
+
+            Leaf* leaf = find_leaf(key);
+            const std::size_t index = rank<false>(leaf->keys.data(), leaf->size, key);
+            if (index < leaf->size && !compare_(key, leaf->keys[index]))
+                return {leaf, index};
+            return end();
+        }
+
+        bool contains(const TKey& key) const { return find(key) != end(); }
+
+        size_type count(const TKey& key) const { return contains(key); }
+
+        iterator lower_bound(const TKey& key) { return mutable_iterator(std::as_const(*this).lower_bound(key)); }
+
+        const_iterator lower_bound(const TKey& key) const { return bound<false>(key); }
+
+        iterator upper_bound(const TKey& key) { return mutable_iterator(std::as_const(*this).upper_bound(key)); }
+
+        const_iterator upper_bound(const TKey& key) const { return bound<true>(key); }
+
+        std::pair<iterator, iterator> equal_range(const TKey& key) { return {lower_bound(key), upper_bound(key)}; }
+
+        std::pair<const_iterator, const_iterator> equal_range(const TKey& key) const { return {lower_bound(key), upper_bound(key)}; }
+
+        TValue& at(const TKey& key) { return const_cast<TValue&>(std::as_const(*this).at(key)); }
+
+        const TValue& at(const TKey& key) const
+        {
+            const const_iterator it = find(key);
+            if (it == end())
+                throw std::out_of_range{"BPlusTreeMap::at - no such key"};
+            return it.value();
+        }
+
+        TValue& operator[](const TKey& key) requires std::default_initializable<TValue> { return try_emplace(key).first.value(); }
+
+        TValue& operator[](TKey&& key) requires std::default_initializable<TValue> { return try_emplace(std::move(key)).first.value(); }
+
+        //////////////////////////////////////////////////////////////////////
+        // modifiers
+
+        template <typename... TArgs>
+        std::pair<iterator, bool> try_emplace(const TKey& key, TArgs&&... args)
+        {
+            return emplace_key(TKey{key}, std::forward<TArgs>(args)...);
+        }
+
+        template <typename... TArgs>
+        std::pair<iterator, bool> try_emplace(TKey&& key, TArgs&&... args)
+        {
+            return emplace_key(std::move(key), std::forward<TArgs>(args)...);
+        }
+
+        // the hint is used when it is end() & the key is greater than all the others - a sorted sequence is appended
+        template <typename... TArgs>
+        iterator try_emplace(const_iterator hint, const TKey& key, TArgs&&... args)
+        {
+            if (hint == end() && last_ && compare_(last_->keys[last_->size - 1], key))
+                return append(TKey{key}, std::forward<TArgs>(args)...);
+            return try_emplace(key, std::forward<TArgs>(args)...).first;
+        }
+
+        std::pair<iterator, bool> insert(const value_type& item) { return try_emplace(item.first, item.second); }
+
+        std::pair<iterator, bool> insert(value_type&& item) { return try_emplace(std::move(item.first), std::move(item.second)); }
+
+        template <std::input_iterator TIterator, std::sentinel_for<TIterator> TSentinel>
+        void insert(TIterator first, TSentinel last)
+        {
+            for (; first != last; ++first)
+            {
+                const auto& [key, value] = *first;
+                try_emplace(end(), key, value);
+            }
+        }
+
+        template <typename... TArgs>
+        std::pair<iterator, bool> emplace(TArgs&&... args)
+        {
+            value_type item(std::forward<TArgs>(args)...);
+            return try_emplace(std::move(item.first), std::move(item.second));
+        }
+
+        template <typename TArg>
+        std::pair<iterator, bool> insert_or_assign(const TKey& key, TArg&& value)
+        {
+            auto [it, inserted] = try_emplace(key, std::forward<TArg>(value));
+            if (!inserted)
+                it.value() = std::forward<TArg>(value);
+            return {it, inserted};
+        }
+
+        size_type erase(const TKey& key)
+        {
+            if (!root_)
+                return 0;
+
+            Path path;
+            Leaf* leaf = find_leaf(key, path);
+            const std::size_t index = rank<false>(leaf->keys.data(), leaf->size, key);
+            if (index == leaf->size || compare_(key, leaf->keys[index]))
+                return 0;
+
+            erase_from(leaf, index, path);
+            return 1;
+        }
+
+        // the iterator following the erased element
+        iterator erase(const_iterator pos)
+        {
+            const TKey key = pos.key();
+            erase(key);
+            return lower_bound(key);
+        }
+
+        void clear() noexcept
+        {
+            if (root_)
+                destroy(root_, height_);
+
+            root_ = nullptr;
+            first_ = last_ = nullptr;
+            height_ = 0;
+            size_ = 0;
+        }
+
+        friend bool operator==(const BPlusTreeMap& lhs, const BPlusTreeMap& rhs)
+        {
+            return lhs.size() == rhs.size() && std::ranges::equal(lhs, rhs, [](const_reference a, const_reference b) { return a.first == b.first && a.second == b.second; });
+        }
+
+    private:
+        static iterator mutable_iterator(const_iterator it) noexcept { return {it.leaf_, it.index_}; }
+
+        //////////////////////////////////////////////////////////////////////
+        // search
+
+        template <bool OrEqual>
+        std::size_t rank(const TKey* keys, std::size_t size, const TKey& key) const noexcept
+        {
+#ifdef BPLUS_TREE_MAP_X86
+            if constexpr (Detail::SimdSearchable<TKey, TCompare>)
+                return Detail::rank_simd<TKey, OrEqual>(keys, size, key);
+#endif
+            if constexpr (OrEqual)
+                return std::upper_bound(keys, keys + size, key, std::ref(compare_)) - keys;
+            else
+                return std::lower_bound(keys, keys + size, key, std::ref(compare_)) - keys;
+        }
+
+        Leaf* find_leaf(const TKey& key) const noexcept
+        {
+            void* node = root_;
+            for (std::size_t level = height_; level > 0; --level)
+            {
+                Inner* inner = static_cast<Inner*>(node);
+                node = inner->children[rank<true>(inner->keys.data(), inner->size, key)];
+            }
+            return static_cast<Leaf*>(node);
+        }
+
+        Leaf* find_leaf(const TKey& key, Path& path) const noexcept
+        {
+            void* node = root_;
+            for (std::size_t level = height_; level > 0; --level)
+            {
+                Inner* inner = static_cast<Inner*>(node);
+                const std::size_t child = rank<true>(inner->keys.data(), inner->size, key);
+                path[height_ - level] = {inner, child};
+                node = inner->children[child];
+            }
+            return static_cast<Leaf*>(node);
+        }
+
+        template <bool OrEqual>
+        const_iterator bound(const TKey& key) const
+        {
+            if (!root_)
+                return end();
+
+            Leaf* leaf = find_leaf(key);
+            const std::size_t index = rank<OrEqual>(leaf->keys.data(), leaf->size, key);
+            if (index == leaf->size && leaf->next)
+                return {leaf->next, 0};
+            return {leaf, index};
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // insertion
+
+        template <typename... TArgs>
+        std::pair<iterator, bool> emplace_key(TKey&& key, TArgs&&... args)
+        {
+            if (!root_)
+            {
+                root_ = first_ = last_ = new Leaf();
+                return {insert_into_leaf(last_, 0, std::move(key), std::forward<TArgs>(args)...), true};
+            }
+
+            Path path;
+            Leaf* leaf = find_leaf(key, path);
+            const std::size_t index = rank<false>(leaf->keys.data(), leaf->size, key);
+            if (index < leaf->size && !compare_(key, leaf->keys[index]))
+                return {iterator{leaf, index}, false};
+
+            return {insert_at(leaf, index, path, std::move(key), std::forward<TArgs>(args)...), true};
+        }
+
+        // key is greater than all the keys - the path to the last leaf is the rightmost one
+        template <typename... TArgs>
+        iterator append(TKey&& key, TArgs&&... args)
+        {
+            Path path;
+            void* node = root_;
+            for (std::size_t level = 0; level < height_; ++level)
+            {
+                Inner* inner = static_cast<Inner*>(node);
+                path[level] = {inner, inner->size};
+                node = inner->children[inner->size];
+            }
+
+            return insert_at(last_, last_->size, path, std::move(key), std::forward<TArgs>(args)...);
+        }
+
+        template <typename... TArgs>
+        iterator insert_into_leaf(Leaf* leaf, std::size_t index, TKey&& key, TArgs&&... args)
+        {
+            TValue value(std::forward<TArgs>(args)...);
+            Detail::insert_at(leaf->keys.data(), leaf->size, index, std::move(key));
+            Detail::insert_at(leaf->values.data(), leaf->size, index, std::move(value));
+            ++leaf->size;
+            ++size_;
+            return {leaf, index};
+        }
+
+        // a full leaf is split in halves - or, when the element is appended to the last leaf, a new leaf is started
+        // (keys inserted in ascending order fill the leaves completely); the split goes up the path
+        template <typename... TArgs>
+        iterator insert_at(Leaf* leaf, std::size_t index, const Path& path, TKey&& key, TArgs&&... args)
+        {
+            if (leaf->size < Capacity)
+                return insert_into_leaf(leaf, index, std::move(key), std::forward<TArgs>(args)...);
+
+            const bool appending = leaf == last_ && index == Capacity;
+            const std::size_t middle = appending ? Capacity : Capacity / 2;
+
+            Leaf* right = new Leaf();
+            Detail::relocate(leaf->keys.data() + middle, Capacity - middle, right->keys.data());
+            Detail::relocate(leaf->values.data() + middle, Capacity - middle, right->values.data());
+            right->size = Capacity - middle;
+            leaf->size = middle;
+
+            right->prev = leaf;
+            right->next = leaf->next;
+            (leaf->next ? leaf->next->prev : last_) = right;
+            leaf->next = right;
+
+            const iterator inserted = index < middle
+                ? insert_into_leaf(leaf, index, std::move(key), std::forward<TArgs>(args)...)
+                : insert_into_leaf(right, index - middle, std::move(key), std::forward<TArgs>(args)...);
+
+            insert_into_parent(path, height_, TKey{right->keys[0]}, right, appending);
+            return inserted;
+        }
+
+        // separator & the new right sibling of path[level - 1].node->children[child] inserted into that node
+        void insert_into_parent(const Path& path, std::size_t level, TKey&& separator, void* right, bool appending)
+        {
+            if (level == 0)
+            {
+                Inner* root = new Inner();
+                std::construct_at(root->keys.data(), std::move(separator));
+                root->children[0] = root_;
+                root->children[1] = right;
+                root->size = 1;
+                root_ = root;
+                ++height_;
+                return;
+            }
+
+            auto [node, child] = path[level - 1];
+            if (node->size < Capacity)
+            {
+                insert_into_inner(node, child, std::move(separator), right);
+                return;
+            }
+
+            // keys [0, middle) stay, keys (middle, Capacity) move to the sibling, the key at middle goes up
+            appending = appending && child == node->size;
+            const std::size_t middle = appending ? Capacity - 1 : Capacity / 2;
+
+            Inner* sibling = new Inner();
+            const std::size_t moved = Capacity - middle - 1;
+            Detail::relocate(node->keys.data() + middle + 1, moved, sibling->keys.data());
+            std::copy_n(node->children.begin() + middle + 1, moved + 1, sibling->children.begin());
+            sibling->size = moved;
+
+            TKey up = std::move(node->keys[middle]);
+            std::destroy_at(node->keys.data() + middle);
+            node->size = middle;
+
+            if (child <= middle)
+                insert_into_inner(node, child, std::move(separator), right);
+            else
+                insert_into_inner(sibling, child - middle - 1, std::move(separator), right);
+
+            insert_into_parent(path, level - 1, std::move(up), sibling, appending);
+        }
+
+        static void insert_into_inner(Inner* node, std::size_t child, TKey&& separator, void* right)
+        {
+            Detail::insert_at(node->keys.data(), node->size, child, std::move(separator));
+            std::copy_backward(node->children.begin() + child + 1, node->children.begin() + node->size + 1, node->children.begin() + node->size + 2);
+            node->children[child + 1] = right;
+            ++node->size;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // erasure
+
+        void erase_from(Leaf* leaf, std::size_t index, const Path& path)
+        {
+            Detail::erase_at(leaf->keys.data(), leaf->size, index);
+            Detail::erase_at(leaf->values.data(), leaf->size, index);
+            --leaf->size;
+            --size_;
+
+            if (height_ == 0)
+            {
+                if (leaf->size == 0)
+                    clear();
+                return;
+            }
+
+            if (leaf->size < min_size)
+                rebalance_leaf(leaf, path);
+        }
+
+        // an item borrowed from a sibling with more than min_size of them, or the leaf merged with a sibling
+        void rebalance_leaf(Leaf* leaf, const Path& path)
+        {
+            auto [parent, child] = path[height_ - 1];
+
+            if (child > 0)
+            {
+                Leaf* left = static_cast<Leaf*>(parent->children[child - 1]);
+                if (left->size > min_size)
+                {
+                    --left->size;
+                    Detail::insert_at(leaf->keys.data(), leaf->size, 0, std::move(left->keys[left->size]));
+                    Detail::insert_at(leaf->values.data(), leaf->size, 0, std::move(left->values[left->size]));
+                    std::destroy_at(left->keys.data() + left->size);
+                    std::destroy_at(left->values.data() + left->size);
+                    ++leaf->size;
+                    parent->keys[child - 1] = leaf->keys[0];
+                    return;
+                }
+            }
+
+            if (child < parent->size)
+            {
+                Leaf* right = static_cast<Leaf*>(parent->children[child + 1]);
+                if (right->size > min_size)
+                {
+                    std::construct_at(leaf->keys.data() + leaf->size, std::move(right->keys[0]));
+                    std::construct_at(leaf->values.data() + leaf->size, std::move(right->values[0]));
+                    ++leaf->size;
+                    Detail::erase_at(right->keys.data(), right->size, 0);
+                    Detail::erase_at(right->values.data(), right->size, 0);
+                    --right->size;
+                    parent->keys[child] = right->keys[0];
+                    return;
+                }
+            }
+
+            // merged into the left one of the two leaves, the right one removed
+            const std::size_t left_child = child > 0 ? child - 1 : child;
+            Leaf* left = static_cast<Leaf*>(parent->children[left_child]);
+            Leaf* right = static_cast<Leaf*>(parent->children[left_child + 1]);
+
+            Detail::relocate(right->keys.data(), right->size, left->keys.data() + left->size);
+            Detail::relocate(right->values.data(), right->size, left->values.data() + left->size);
+            left->size += right->size;
+
+            left->next = right->next;
+            (right->next ? right->next->prev : last_) = left;
+            delete right;
+
+            remove_from_inner(parent, left_child);
+            rebalance_inner(path, height_ - 1);
+        }
+
+        // keys[index] & children[index + 1] removed
+        static void remove_from_inner(Inner* node, std::size_t index)
+        {
+            Detail::erase_at(node->keys.data(), node->size, index);
+            std::copy(node->children.begin() + index + 2, node->children.begin() + node->size + 1, node->children.begin() + index + 1);
+            --node->size;
+        }
+
+        // path[level].node after one of its children was removed
+        void rebalance_inner(const Path& path, std::size_t level)
+        {
+            Inner* node = path[level].node;
+
+            if (level == 0)
+            {
+                if (node->size == 0) // the root with one child
+                {
+                    root_ = node->children[0];
+                    --height_;
+                    delete node;
+                }
+                return;
+            }
+
+            if (node->size >= min_size)
+                return;
+
+            auto [parent, child] = path[level - 1];
+
+            if (child > 0)
+            {
+                Inner* left = static_cast<Inner*>(parent->children[child - 1]);
+                if (left->size > min_size)
+                {
+                    // rotation through the parent: its key comes down, the last key of the left sibling goes up
+                    Detail::insert_at(node->keys.data(), node->size, 0, std::move(parent->keys[child - 1]));
+                    std::copy_backward(node->children.begin(), node->children.begin() + node->size + 1, node->children.begin() + node->size + 2);
+                    node->children[0] = left->children[left->size];
+                    ++node->size;
+
+                    --left->size;
+                    parent->keys[child - 1] = std::move(left->keys[left->size]);
+                    std::destroy_at(left->keys.data() + left->size);
+                    return;
+                }
+            }
+
+            if (child < parent->size)
+            {
+                Inner* right = static_cast<Inner*>(parent->children[child + 1]);
+                if (right->size > min_size)
+                {
+                    std::construct_at(node->keys.data() + node->size, std::move(parent->keys[child]));
+                    node->children[node->size + 1] = right->children[0];
+                    ++node->size;
+
+                    parent->keys[child] = std::move(right->keys[0]);
+                    Detail::erase_at(right->keys.data(), right->size, 0);
+                    std::copy(right->children.begin() + 1, right->children.begin() + right->size + 1, right->children.begin());
+                    --right->size;
+                    return;
+                }
+            }
+
+            // merged into the left one with the separator of the parent between them
+            const std::size_t left_child = child > 0 ? child - 1 : child;
+            Inner* left = static_cast<Inner*>(parent->children[left_child]);
+            Inner* right = static_cast<Inner*>(parent->children[left_child + 1]);
+
+            std::construct_at(left->keys.data() + left->size, std::move(parent->keys[left_child]));
+            Detail::relocate(right->keys.data(), right->size, left->keys.data() + left->size + 1);
+            std::copy_n(right->children.begin(), right->size + 1, left->children.begin() + left->size + 1);
+            left->size += right->size + 1;
+            delete right;
+
+            remove_from_inner(parent, left_child);
+            rebalance_inner(path, level - 1);
+        }
+
+        void destroy(void* node, std::size_t level) noexcept
+        {
+            if (level == 0)
+            {
+                Leaf* leaf = static_cast<Leaf*>(node);
+                std::destroy_n(leaf->keys.data(), leaf->size);
+                std::destroy_n(leaf->values.data(), leaf->size);
+                delete leaf;
+                return;
+            }
+
+            Inner* inner = static_cast<Inner*>(node);
+            for (std::size_t i = 0; i <= inner->size; ++i)
+                destroy(inner->children[i], level - 1);
+            std::destroy_n(inner->keys.data(), inner->size);
+            delete inner;
+        }
+
+        [[no_unique_address]] TCompare compare_{};
+        void* root_ = nullptr;
+        Leaf* first_ = nullptr;
+        Leaf* last_ = nullptr;
+        std::size_t height_ = 0;
+        std::size_t size_ = 0;
+    };
+} // namespace Containers
+
+template <typename TKey, typename TValue, bool Const>
+struct std::tuple_size<Containers::Detail::ElementRef<TKey, TValue, Const>> : std::integral_constant<std::size_t, 2>
+{ };
+
+template <std::size_t I, typename TKey, typename TValue, bool Const>
+struct std::tuple_element<I, Containers::Detail::ElementRef<TKey, TValue, Const>>
+    : std::tuple_element<I, typename Containers::Detail::ElementRef<TKey, TValue, Const>::Base>
+{ };
+
+// the common reference of an element & a pair - a reference to a const value if either of them is const
+template <typename TKey, typename TValue, bool Const, template <typename> typename TQual, template <typename> typename UQual>
+struct std::basic_common_reference<Containers::Detail::ElementRef<TKey, TValue, Const>, std::pair<TKey, TValue>, TQual, UQual>
+{
+    using type = Containers::Detail::ElementRef<TKey, TValue, Const || std::is_const_v<std::remove_reference_t<UQual<std::pair<TKey, TValue>>>>>;
+};
+
+template <typename TKey, typename TValue, bool Const, template <typename> typename TQual, template <typename> typename UQual>
+struct std::basic_common_reference<std::pair<TKey, TValue>, Containers::Detail::ElementRef<TKey, TValue, Const>, TQual, UQual>
+{
+    using type = Containers::Detail::ElementRef<TKey, TValue, Const || std::is_const_v<std::remove_reference_t<TQual<std::pair<TKey, TValue>>>>>;
+};
+
+#endif
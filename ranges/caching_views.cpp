@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <numeric>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "caching_views.hpp"
+
+namespace
+{
+    // the elements of a range iterated as const - not possible for std::views::filter
+    template <typename TRange>
+    std::vector<int> to_vector(const TRange& rng)
+    {
+        std::vector<int> result;
+        for (int item : rng)
+            result.push_back(item);
+        return result;
+    }
+
+    // the work done per element in the benchmarks
+    double expensive(int x)
+    {
+        double result = x;
+        for (int i = 0; i < 100; ++i)
+            result = std::sqrt(result * result + 1.0); // sqrt(x^2 + 100)
+        return result;
+    }
+} // namespace
+
+TEST_CASE("cache_latest - the current element is computed once")
+{
+    std::vector<int> vec = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    int calls = 0;
+    auto square = [&calls](int x) {
+        ++calls;
+        return x * x;
+    };
+    auto is_even = [](int x) { return x % 2 == 0; };
+
+    SECTION("transform | filter - the transform is called again for every selected element")
+    {
+        std::vector<int> result;
+        for (int item : vec | std::views::transform(square) | std::views::filter(is_even))
+            result.push_back(item);
+
+        CHECK(result == std::vector{4, 16, 36, 64, 100});
+        CHECK(calls == 15);
+    }
+
+    SECTION("transform | cache_latest | filter")
+    {
+        std::vector<int> result;
+        for (int item : vec | std::views::transform(square) | Views::cache_latest | std::views::filter(is_even))
+            result.push_back(item);
+
+        CHECK(result == std::vector{4, 16, 36, 64, 100});
+        CHECK(calls == 10);
+    }
+
+    SECTION("lvalues are cached as references")
+    {
+        auto cached = vec | Views::cache_latest;
+        static_assert(std::ranges::input_range<decltype(cached)>);
+        static_assert(std::ranges::sized_range<decltype(cached)>);
+        CHECK(cached.size() == 10);
+
+        auto it = cached.begin();
+        *it = 42;
+        CHECK(&*it == &vec[0]);
+        CHECK(vec[0] == 42);
+    }
+
+    SECTION("input source")
+    {
+        std::istringstream input{"1 2 3 4"};
+        std::vector<int> result;
+        for (int item : std::views::istream<int>(input) | std::views::transform(square) | Views::cache_latest)
+            result.push_back(item);
+
+        CHECK(result == std::vector{1, 4, 9, 16});
+    }
+}
+
+TEST_CASE("materialize - the elements are computed on the first traversal")
+{
+    std::vector<int> vec = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    int calls = 0;
+    auto square = [&calls](int x) {
+        ++calls;
+        return x * x;
+    };
+
+    SECTION("later traversals compute nothing")
+    {
+        auto squares = vec | std::views::transform(square) | Views::materialize;
+        CHECK(calls == 0); // lazy
+
+        CHECK(std::accumulate(squares.begin(), squares.end(), 0) == 385);
+        CHECK(std::accumulate(squares.begin(), squares.end(), 0) == 385);
+        CHECK(calls == 10);
+
+        auto copy = squares; // the copies share the buffer
+        CHECK(copy[9] == 100);
+        CHECK(calls == 10);
+    }
+
+    SECTION("filter | materialize is const-iterable, random-access & sized")
+    {
+        const auto evens = vec | std::views::filter([](int x) { return x % 2 == 0; }) | Views::materialize;
+        static_assert(std::ranges::contiguous_range<decltype(evens)>);
+        static_assert(std::ranges::sized_range<decltype(evens)>);
+
+        CHECK(to_vector(evens) == std::vector{2, 4, 6, 8, 10});
+        CHECK(evens.size() == 5);
+        CHECK(evens[2] == 6);
+        CHECK(std::ranges::binary_search(evens, 8));
+    }
+
+    SECTION("input source becomes a multi-pass range")
+    {
+        std::istringstream input{"3 1 2"};
+        auto numbers = std::views::istream<int>(input) | Views::materialize;
+
+        CHECK(to_vector(numbers) == std::vector{3, 1, 2});
+        CHECK(to_vector(numbers) == std::vector{3, 1, 2});
+    }
+
+    SECTION("the first traversal is thread-safe")
+    {
+        auto squares = std::views::iota(0, 10'000) | std::views::transform(square) | Views::materialize;
+
+        std::vector<long long> sums(4);
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t i = 0; i < sums.size(); ++i)
+                threads.emplace_back([&, i] { sums[i] = std::accumulate(squares.begin(), squares.end(), 0LL); });
+        }
+
+        CHECK(calls == 10'000);
+        CHECK(sums == std::vector<long long>(4, 333'283'335'000LL));
+    }
+}
+
+TEST_CASE("caching views - benchmarks", "[.][benchmark]")
+{
+    std::vector<int> vec(10'000);
+    std::iota(vec.begin(), vec.end(), 0);
+    auto is_big = [](double x) { return std::fmod(x, 2.0) >= 1.0; }; // half of the elements
+
+    BENCHMARK("transform | filter")
+    {
+        double sum = 0;
+        for (double item : vec | std::views::transform(expensive) | std::views::filter(is_big))
+            sum += item;
+        return sum;
+    };
+
+    BENCHMARK("transform | cache_latest | filter")
+    {
+        double sum = 0;
+        for (double item : vec | std::views::transform(expensive) | Views::cache_latest | std::views::filter(is_big))
+            sum += item;
+        return sum;
+    };
+
+    BENCHMARK("transform - 3 passes")
+    {
+        auto results = vec | std::views::transform(expensive);
+        double sum = 0;
+        for (int pass = 0; pass < 3; ++pass)
+            sum += std::accumulate(results.begin(), results.end(), 0.0);
+        return sum;
+    };
+
+    BENCHMARK("transform | materialize - 3 passes")
+    {
+        auto results = vec | std::views::transform(expensive) | Views::materialize;
+        double sum = 0;
+        for (int pass = 0; pass < 3; ++pass)
+            sum += std::accumulate(results.begin(), results.end(), 0.0);
+        return sum;
+    };
+}
@@ -0,0 +1,239 @@
+#ifndef CACHING_VIEWS_HPP
+#define CACHING_VIEWS_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Views remembering the elements computed by the range they adapt:
+//  * rng | Views::cache_latest - the current element is computed once, however many times it is dereferenced
+//    (transform | cache_latest | filter calls the transform once per element - filter dereferences twice)
+//  * rng | Views::materialize  - the elements are stored in a buffer during the first traversal (begin());
+//    the view is then a const-iterable, random-access, sized range over the buffer - later passes compute nothing
+//    and a filter or an input range becomes usable where a const range is required
+namespace Views
+{
+    namespace Detail
+    {
+        // an optional that is empty after a copy or a move - the cached value refers to the source object
+        template <typename T>
+        class NonPropagatingCache : public std::optional<T>
+        {
+        public:
+            NonPropagatingCache() = default;
+
+            NonPropagatingCache(const NonPropagatingCache&) noexcept
+            { }
+
+            NonPropagatingCache(NonPropagatingCache&& other) noexcept
+            {
+                other.reset();
+            }
+
+            NonPropagatingCache& operator=(const NonPropagatingCache& other) noexcept
+            {
+                if (this != &other)
+                    this->reset();
+                return *this;
+            }
+
+            NonPropagatingCache& operator=(NonPropagatingCache&& other) noexcept
+            {
+                this->reset();
+                other.reset();
+                return *this;
+            }
+        };
+
+        template <typename V>
+        concept Cacheable = std::ranges::view<V> && std::ranges::input_range<V>;
+    } // namespace Detail
+
+    //////////////////////////////////////////////////////////////////////
+    // cache_latest
+
+    template <Detail::Cacheable V>
+    class CacheLatestView : public std::ranges::view_interface<CacheLatestView<V>>
+    {
+        using Reference = std::ranges::range_reference_t<V>;
+
+        // an lvalue is cached as a pointer to it, a prvalue (a transform result) as a value
+        using Cached = std::conditional_t<std::is_lvalue_reference_v<Reference>, std::add_pointer_t<Reference>, std::remove_cvref_t<Reference>>;
+
+    public:
+        class sentinel
+        {
+        public:
+            sentinel() = default;
+
+            explicit sentinel(std::ranges::sentinel_t<V> end)
+                : end_{std::move(end)}
+            { }
+
+            const std::ranges::sentinel_t<V>& base() const noexcept { return end_; }
+
+        private:
+            std::ranges::sentinel_t<V> end_;
+        };
+
+        class iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::ranges::range_value_t<V>;
+            using difference_type = std::ranges::range_difference_t<V>;
+
+            iterator(CacheLatestView& parent, std::ranges::iterator_t<V> current)
+                : parent_{&parent}
+                , current_{std::move(current)}
+            { }
+
+            iterator(iterator&&) = default;
+            iterator& operator=(iterator&&) = default;
+
+            std::remove_reference_t<Reference>& operator*() const
+            {
+                auto& cache = parent_->cache_;
+
+                if constexpr (std::is_lvalue_reference_v<Reference>)
+                {
+                    if (!cache)
+                        cache.emplace(std::addressof(*current_));
+                    return **cache;
+                }
+                else
+                {
+                    if (!cache)
+                        cache.emplace(*current_);
+                    return *cache;
+                }
+            }
+
+            iterator& operator++()
+            {
+                ++current_;
+                parent_->cache_.reset();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            const std::ranges::iterator_t<V>& base() const& noexcept { return current_; }
+
+            friend bool operator==(const iterator& it, const sentinel& s) { return it.current_ == s.base(); }
+
+        private:
+            CacheLatestView* parent_;
+            std::ranges::iterator_t<V> current_;
+        };
+
+        CacheLatestView() requires std::default_initializable<V> = default;
+
+        explicit CacheLatestView(V base)
+            : base_{std::move(base)}
+        { }
+
+        V base() const& requires std::copy_constructible<V> { return base_; }
+
+        iterator begin()
+        {
+            cache_.reset();
+            return iterator{*this, std::ranges::begin(base_)};
+        }
+
+        sentinel end() { return sentinel{std::ranges::end(base_)}; }
+
+        auto size() requires std::ranges::sized_range<V> { return std::ranges::size(base_); }
+
+        auto size() const requires std::ranges::sized_range<const V> { return std::ranges::size(base_); }
+
+    private:
+        V base_;
+        Detail::NonPropagatingCache<Cached> cache_;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    // materialize
+
+    template <Detail::Cacheable V>
+        requires std::move_constructible<std::ranges::range_value_t<V>>
+    class MaterializeView : public std::ranges::view_interface<MaterializeView<V>>
+    {
+        using T = std::ranges::range_value_t<V>;
+
+        // shared by the copies of the view - a copy is O(1) and the elements are computed once for all of them
+        struct Storage
+        {
+            explicit Storage(V base)
+                : base{std::move(base)}
+            { }
+
+            std::once_flag filled;
+            V base;
+            std::vector<T> elements;
+        };
+
+    public:
+        explicit MaterializeView(V base)
+            : storage_{std::make_shared<Storage>(std::move(base))}
+        { }
+
+        typename std::vector<T>::const_iterator begin() const { return elements().begin(); }
+
+        typename std::vector<T>::const_iterator end() const { return elements().end(); }
+
+        std::size_t size() const { return elements().size(); }
+
+        const T* data() const { return elements().data(); }
+
+    private:
+        // the first call traverses the source - thread-safe, so the const view can be shared by threads
+        const std::vector<T>& elements() const
+        {
+            std::call_once(storage_->filled, [this] {
+                Storage& storage = *storage_;
+                if constexpr (std::ranges::sized_range<V>)
+                    storage.elements.reserve(std::ranges::size(storage.base));
+
+                for (auto&& item : storage.base)
+                    storage.elements.emplace_back(std::forward<decltype(item)>(item));
+            });
+            return storage_->elements;
+        }
+
+        std::shared_ptr<Storage> storage_;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    // adaptors
+
+    template <template <typename> typename TView>
+    struct CachingAdaptor
+    {
+        template <std::ranges::viewable_range R>
+            requires std::ranges::input_range<R>
+        auto operator()(R&& rng) const
+        {
+            return TView<std::views::all_t<R>>{std::views::all(std::forward<R>(rng))};
+        }
+
+        template <std::ranges::viewable_range R>
+            requires std::ranges::input_range<R>
+        friend auto operator|(R&& rng, const CachingAdaptor& adaptor)
+        {
+            return adaptor(std::forward<R>(rng));
+        }
+    };
+
+    inline constexpr CachingAdaptor<CacheLatestView> cache_latest{};
+
+    inline constexpr CachingAdaptor<MaterializeView> materialize{};
+} // namespace Views
+
+#endif
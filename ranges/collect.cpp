@@ -0,0 +1,179 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "collect.hpp"
+
+namespace
+{
+    // counts the allocations - collect must allocate once
+    template <typename T>
+    struct CountingAllocator
+    {
+        using value_type = T;
+
+        inline static int allocations = 0;
+
+        CountingAllocator() = default;
+
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U>&) noexcept
+        { }
+
+        T* allocate(std::size_t n)
+        {
+            ++allocations;
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* ptr, std::size_t n) noexcept { std::allocator<T>{}.deallocate(ptr, n); }
+
+        bool operator==(const CountingAllocator&) const = default;
+    };
+
+    using CountedVector = std::vector<int, CountingAllocator<int>>;
+
+    auto is_even = [](int x) { return x % 2 == 0; };
+} // namespace
+
+TEST_CASE("collect - the container is allocated once")
+{
+    std::vector<int> vec(1000);
+    std::iota(vec.begin(), vec.end(), 0);
+    CountingAllocator<int>::allocations = 0;
+
+    SECTION("sized range - exact size")
+    {
+        auto squares = vec | std::views::transform([](int x) { return x * x; }) | Views::collect<CountedVector>();
+
+        CHECK(squares.size() == 1000);
+        CHECK(squares.capacity() == 1000);
+        CHECK(squares[10] == 100);
+        CHECK(CountingAllocator<int>::allocations == 1);
+    }
+
+    SECTION("filter - the size of the source is the bound")
+    {
+        auto evens = vec | std::views::filter(is_even) | std::views::transform([](int x) { return x / 2; }) | Views::collect<CountedVector>();
+
+        CHECK(evens.size() == 500);
+        CHECK(evens.capacity() == 1000);
+        CHECK(std::ranges::equal(evens, std::views::iota(0, 500)));
+        CHECK(CountingAllocator<int>::allocations == 1);
+    }
+
+    SECTION("filter - shrink_to_fit")
+    {
+        auto evens = vec | std::views::filter(is_even) | Views::collect<CountedVector>({.shrink_to_fit = true});
+
+        CHECK(evens.size() == 500);
+        CHECK(evens.capacity() == 500);
+        CHECK(CountingAllocator<int>::allocations == 2);
+    }
+}
+
+TEST_CASE("collect - containers & sources")
+{
+    SECTION("element type deduced")
+    {
+        auto words = std::vector<std::string>{"one", "two", "three"}
+            | std::views::filter([](const std::string& s) { return s.size() == 3; })
+            | Views::collect<std::vector>();
+
+        static_assert(std::same_as<decltype(words), std::vector<std::string>>);
+        CHECK(words == std::vector<std::string>{"one", "two"});
+    }
+
+    SECTION("associative & node-based containers")
+    {
+        const std::vector<int> data = {5, 3, 5, 1, 3};
+        CHECK((data | Views::collect<std::set>()) == std::set{1, 3, 5});
+        CHECK((data | std::views::reverse | Views::collect<std::list<int>>()) == std::list{3, 1, 5, 3, 5});
+    }
+
+    SECTION("input range of unknown size")
+    {
+        std::istringstream input{"1 2 3 4"};
+        CHECK((std::views::istream<int>(input) | Views::collect<std::vector>()) == std::vector{1, 2, 3, 4});
+    }
+
+    SECTION("called as a function")
+    {
+        CHECK(Views::collect<std::string>()(std::string_view{"text"}) == "text");
+    }
+}
+
+TEST_CASE("collect - parallel")
+{
+    std::vector<int> vec(200'000);
+    std::iota(vec.begin(), vec.end(), 0);
+
+    SECTION("random-access source")
+    {
+        auto squares = vec | std::views::transform([](int x) { return x % 1000; }) | Views::collect<std::vector>({.parallel = true});
+        CHECK(squares == (vec | std::views::transform([](int x) { return x % 1000; }) | Views::collect<std::vector>()));
+    }
+
+    SECTION("filter of a random-access source - count, then fill")
+    {
+        auto multiples = vec | std::views::filter([](int x) { return x % 3 == 0; }) | Views::collect<std::vector>({.parallel = true});
+
+        CHECK(multiples.size() == 66'667);
+        CHECK(multiples.capacity() == multiples.size());
+        CHECK(std::ranges::equal(multiples, std::views::iota(0, 66'667) | std::views::transform([](int x) { return 3 * x; })));
+    }
+
+    SECTION("take_while stops at the first rejected element")
+    {
+        const std::vector<int> values = {1, 2, 9, 3, 4};
+        auto below_5 = [](int x) { return x < 5; };
+        CHECK((values | std::views::take_while(below_5) | Views::collect<std::vector>({.parallel = true})) == std::vector{1, 2});
+
+        auto prefix = vec | std::views::take_while([](int x) { return x < 150'000; }) | Views::collect<std::vector>({.parallel = true});
+        CHECK(std::ranges::equal(prefix, std::views::iota(0, 150'000)));
+    }
+
+    SECTION("other sources & containers are collected serially")
+    {
+        auto odds = vec | std::views::filter([](int x) { return x % 2 == 1; }) | Views::collect<std::set>({.parallel = true});
+        CHECK(odds.size() == 100'000);
+    }
+}
+
+TEST_CASE("collect - benchmarks", "[.][benchmark]")
+{
+    std::vector<int> vec(1'000'000);
+    std::iota(vec.begin(), vec.end(), 0);
+    auto selected = [](int x) { return x % 3 != 0; };
+
+    BENCHMARK("filter - vector from std::views::common")
+    {
+        auto result = vec | std::views::filter(selected) | std::views::common;
+        return std::vector<int>(result.begin(), result.end());
+    };
+
+    BENCHMARK("filter - push_back")
+    {
+        std::vector<int> result;
+        for (int x : vec | std::views::filter(selected))
+            result.push_back(x);
+        return result;
+    };
+
+    BENCHMARK("filter - collect<std::vector>()")
+    {
+        return vec | std::views::filter(selected) | Views::collect<std::vector>();
+    };
+
+    BENCHMARK("filter - collect<std::vector>({.parallel = true})")
+    {
+        return vec | std::views::filter(selected) | Views::collect<std::vector>({.parallel = true});
+    };
+}
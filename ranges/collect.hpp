@@ -0,0 +1,229 @@
+#ifndef COLLECT_HPP
+#define COLLECT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel_algorithms.hpp"
+
+// rng | Views::collect<Container>() - the elements of a range stored in a container, allocated once:
+//
+//   auto evens = vec | std::views::filter(is_even) | Views::collect<std::vector>();
+//   auto words = text | Views::collect<std::vector<std::string>>({.shrink_to_fit = true});
+//
+// The room is reserved up front for the exact size of a sized range or an upper bound of it - the size of
+// the source of a filter (take_while), preserved by transform - and the elements are constructed in place.
+// A bound much bigger than the result can be given back with shrink_to_fit.
+// With .parallel = true a random-access source (or a filter of one) is copied on ThreadPool::global():
+// the selected elements of each chunk are counted first, the container is resized once, the chunks are
+// filled in parallel (the container must be random-access & resizable; otherwise the copy is serial - as for take_while,
+// which ends at the first rejected element).
+namespace Views
+{
+    struct CollectOptions
+    {
+        bool shrink_to_fit = false;
+        bool parallel = false;
+    };
+
+    namespace Detail
+    {
+        // the elements of the source selected by a predicate - anywhere in it
+        template <typename R>
+        struct IsFiltering : std::false_type
+        { };
+
+        template <typename V, typename TPredicate>
+        struct IsFiltering<std::ranges::filter_view<V, TPredicate>> : std::true_type
+        { };
+
+        // a prefix of the source - up to the first element rejected by a predicate (no count-then-fill)
+        template <typename R>
+        struct IsPrefix : std::false_type
+        { };
+
+        template <typename V, typename TPredicate>
+        struct IsPrefix<std::ranges::take_while_view<V, TPredicate>> : std::true_type
+        { };
+
+        template <typename R>
+        struct IsSizePreserving : std::false_type
+        { };
+
+        template <typename V, typename TFunction>
+        struct IsSizePreserving<std::ranges::transform_view<V, TFunction>> : std::true_type
+        { };
+
+        template <typename R>
+        concept WithCopyableBase = requires(const R& rng) { rng.base(); };
+
+        // an upper bound of the number of elements (exact for a sized range); nullopt if nothing is known
+        template <typename R>
+        std::optional<std::size_t> size_bound(R& rng)
+        {
+            using View = std::remove_cvref_t<R>;
+
+            if constexpr (std::ranges::sized_range<R>)
+                return static_cast<std::size_t>(std::ranges::size(rng));
+            else if constexpr ((IsFiltering<View>::value || IsPrefix<View>::value || IsSizePreserving<View>::value) && WithCopyableBase<View>)
+            {
+                auto base = rng.base();
+                return size_bound(base);
+            }
+            else
+                return std::nullopt;
+        }
+
+        template <typename TContainer>
+        concept ParallelFillable = std::ranges::random_access_range<TContainer>
+            && requires(TContainer& container, std::size_t size) { container.resize(size); };
+
+        template <typename R>
+        concept FilterOfRandomAccess = IsFiltering<std::remove_cvref_t<R>>::value
+            && requires(const R& rng) { rng.pred(); }
+            && WithCopyableBase<std::remove_cvref_t<R>>
+            && std::ranges::random_access_range<decltype(std::declval<const R&>().base())>;
+
+        template <typename TContainer, typename TRef>
+        void append(TContainer& container, TRef&& item)
+        {
+            if constexpr (requires { container.emplace_back(std::forward<TRef>(item)); })
+                container.emplace_back(std::forward<TRef>(item));
+            else
+                container.insert(container.end(), std::forward<TRef>(item)); // associative containers
+        }
+
+        template <typename TContainer, typename R>
+        TContainer collect_serial(R&& rng, const CollectOptions& options)
+        {
+            TContainer container;
+
+            if constexpr (requires(std::size_t size) { container.reserve(size); })
+            {
+                if (const std::optional<std::size_t> bound = size_bound(rng))
+                    container.reserve(*bound);
+            }
+
+            for (auto&& item : rng)
+                append(container, std::forward<decltype(item)>(item));
+
+            if constexpr (requires { container.shrink_to_fit(); })
+            {
+                if (options.shrink_to_fit)
+                    container.shrink_to_fit();
+            }
+
+            return container;
+        }
+
+        // count-then-fill for a filter of a random-access range
+        template <typename TContainer, typename R>
+        TContainer collect_filtered_parallel(R& rng)
+        {
+            auto base = rng.base();
+            const auto& pred = rng.pred();
+            const auto first = std::ranges::begin(base);
+            const std::ptrdiff_t size = std::ranges::distance(base);
+            const std::ptrdiff_t chunks = par::Detail::chunk_count(size);
+
+            std::vector<std::ptrdiff_t> offsets(chunks + 1);
+            auto count = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t index) {
+                offsets[index + 1] = std::ranges::count_if(first + begin, first + end, std::ref(pred));
+            };
+            par::Detail::for_chunks(size, chunks, count);
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            TContainer container;
+            container.resize(offsets[chunks]);
+
+            auto fill = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t index) {
+                std::ranges::copy_if(first + begin, first + end, std::ranges::begin(container) + offsets[index], std::ref(pred));
+            };
+            par::Detail::for_chunks(size, chunks, fill);
+
+            return container;
+        }
+
+        template <typename TContainer, typename R>
+        TContainer collect(R&& rng, const CollectOptions& options)
+        {
+            if constexpr (ParallelFillable<TContainer>)
+            {
+                if (options.parallel)
+                {
+                    if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>)
+                    {
+                        TContainer container;
+                        container.resize(std::ranges::size(rng));
+                        par::transform(rng, std::ranges::begin(container), std::identity{});
+                        return container;
+                    }
+                    else if constexpr (FilterOfRandomAccess<R>)
+                        return collect_filtered_parallel<TContainer>(rng);
+                }
+            }
+
+            return collect_serial<TContainer>(std::forward<R>(rng), options);
+        }
+    } // namespace Detail
+
+    template <typename TContainer>
+    struct CollectAdaptor
+    {
+        CollectOptions options;
+
+        template <std::ranges::input_range R>
+            requires std::constructible_from<std::ranges::range_value_t<TContainer>, std::ranges::range_reference_t<R>>
+        TContainer operator()(R&& rng) const
+        {
+            return Detail::collect<TContainer>(std::forward<R>(rng), options);
+        }
+
+        template <std::ranges::input_range R>
+            requires std::constructible_from<std::ranges::range_value_t<TContainer>, std::ranges::range_reference_t<R>>
+        friend TContainer operator|(R&& rng, const CollectAdaptor& adaptor)
+        {
+            return adaptor(std::forward<R>(rng));
+        }
+    };
+
+    // the element type deduced from the range: collect<std::vector>()
+    template <template <typename...> typename TContainer>
+    struct DeducingCollectAdaptor
+    {
+        CollectOptions options;
+
+        template <std::ranges::input_range R>
+        auto operator()(R&& rng) const
+        {
+            return Detail::collect<TContainer<std::ranges::range_value_t<R>>>(std::forward<R>(rng), options);
+        }
+
+        template <std::ranges::input_range R>
+        friend auto operator|(R&& rng, const DeducingCollectAdaptor& adaptor)
+        {
+            return adaptor(std::forward<R>(rng));
+        }
+    };
+
+    template <typename TContainer>
+    constexpr CollectAdaptor<TContainer> collect(CollectOptions options = {})
+    {
+        return {options};
+    }
+
+    template <template <typename...> typename TContainer>
+    constexpr DeducingCollectAdaptor<TContainer> collect(CollectOptions options = {})
+    {
+        return {options};
+    }
+} // namespace Views
+
+#endif
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <array>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random.hpp>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "distinct_aggregate.hpp"
+#include "thread_pool.hpp"
+
+namespace
+{
+    // count values drawn from [-range / 4, range * 3 / 4) - about min(count, range) distinct ones
+    std::vector<std::int64_t> create_values(std::size_t count, std::uint32_t range, std::uint32_t seed)
+    {
+        helpers::random::PCG rnd{seed};
+        std::vector<std::int64_t> values(count);
+        for (auto& value : values)
+            value = static_cast<std::int64_t>(rnd() % range) - range / 4; // negative values & zero too
+        return values;
+    }
+
+    // the distinct values by sorting a copy - as avg_for_unique did
+    std::vector<std::int64_t> sorted_unique(std::vector<std::int64_t> values)
+    {
+        std::ranges::sort(values);
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return values;
+    }
+
+    double mean_of(const std::vector<std::int64_t>& values)
+    {
+        return static_cast<double>(std::accumulate(values.begin(), values.end(), std::int64_t{})) / static_cast<double>(values.size());
+    }
+
+    constexpr double avg_of_distinct()
+    {
+        Aggregates::ExactDistinct<int> distinct;
+        distinct.push_range(std::array{9, 1, 1, 4});
+        distinct.push_range(std::array{1, 2, 3, 4, 5});
+        return distinct.mean();
+    }
+} // namespace
+
+TEST_CASE("ExactDistinct - the distinct values")
+{
+    Aggregates::ExactDistinct<int> distinct;
+    CHECK(distinct.count() == 0);
+
+    CHECK(distinct.push(5));
+    CHECK_FALSE(distinct.push(5));
+    CHECK(distinct.push(0));
+    CHECK_FALSE(distinct.push(0));
+    distinct.push_range(std::vector{-3, 5, 7, -3});
+
+    CHECK(distinct.count() == 4);
+    CHECK(distinct.sum() == 9);
+    CHECK(distinct.mean() == 2.25);
+    CHECK(distinct.contains(-3));
+    CHECK(distinct.contains(0));
+    CHECK_FALSE(distinct.contains(4));
+
+    SECTION("as sorting & std::unique")
+    {
+        for (std::uint32_t range : {10u, 1000u, 1'000'000u})
+        {
+            const auto values = create_values(100'000, range, range);
+            const auto expected = sorted_unique(values);
+
+            Aggregates::ExactDistinct<std::int64_t> all;
+            all.push_range(values);
+            CHECK(all.count() == expected.size());
+            CHECK(all.sum() == std::accumulate(expected.begin(), expected.end(), std::int64_t{}));
+            CHECK(all.mean() == mean_of(expected));
+        }
+    }
+
+    SECTION("floating-point values - zero & negative zero")
+    {
+        Aggregates::ExactDistinct<double> reals;
+        reals.push_range(std::vector{0.5, -0.0, 0.0, 0.5, 2.5});
+        CHECK(reals.count() == 3);
+        CHECK(reals.mean() == 1.0);
+    }
+
+    SECTION("constexpr")
+    {
+        static_assert(avg_of_distinct() == 4.0);
+    }
+}
+
+TEST_CASE("ApproximateDistinct - HyperLogLog count & sampled mean")
+{
+    SECTION("exact below the size of the sample")
+    {
+        Aggregates::ApproximateDistinct<int> approx;
+        approx.push_range(std::vector{4, 8, 4, 15, 16, 23, 42, 8});
+        CHECK(approx.count() == 6.0);
+        CHECK(approx.mean() == 18.0);
+    }
+
+    SECTION("within the expected error")
+    {
+        for (std::uint32_t range : {5'000u, 200'000u, 4'000'000u})
+        {
+            const auto values = create_values(2'000'000, range, range);
+            const auto expected = sorted_unique(values);
+
+            Aggregates::ApproximateDistinct<std::int64_t> approx;
+            approx.push_range(values);
+
+            // 1.04 / sqrt(4096) - 1.6% standard error; a uniform sample of 1024 values - 1.8% of the range
+            const auto distinct = static_cast<double>(expected.size());
+            CHECK(std::abs(approx.count() - distinct) < 0.06 * distinct);
+            CHECK(std::abs(approx.mean() - mean_of(expected)) < 0.06 * range);
+            CHECK(std::abs(approx.sum() - approx.count() * approx.mean()) < 1e-6 * std::abs(approx.sum()));
+        }
+    }
+}
+
+TEST_CASE("distinct aggregates - merged shards")
+{
+    const auto values = create_values(1'000'000, 300'000, 7);
+    const std::span all{values};
+    constexpr std::size_t shard_count = 8;
+
+    std::vector<Aggregates::ExactDistinct<std::int64_t>> exact_shards(shard_count);
+    std::vector<Aggregates::ApproximateDistinct<std::int64_t>> approximate_shards(shard_count);
+
+    par::TaskGroup group;
+    for (std::size_t shard = 0; shard < shard_count; ++shard)
+    {
+        group.run([&, shard] {
+            const std::size_t begin = all.size() * shard / shard_count;
+            const auto part = all.subspan(begin, all.size() * (shard + 1) / shard_count - begin);
+            exact_shards[shard].push_range(part);
+            approximate_shards[shard].push_range(part);
+        });
+    }
+    group.wait();
+
+    for (std::size_t shard = 1; shard < shard_count; ++shard)
+    {
+        exact_shards[0].merge(exact_shards[shard]);
+        approximate_shards[0].merge(approximate_shards[shard]);
+    }
+
+    const auto expected = sorted_unique(values);
+    CHECK(exact_shards[0].count() == expected.size());
+    CHECK(exact_shards[0].mean() == mean_of(expected));
+
+    // the merged sketch & sample are the same as of one pass
+    Aggregates::ApproximateDistinct<std::int64_t> approx;
+    approx.push_range(values);
+    CHECK(approximate_shards[0].count() == approx.count());
+    CHECK(approximate_shards[0].mean() == approx.mean());
+}
+
+TEST_CASE("distinct aggregates - benchmarks", "[.][benchmark]")
+{
+    for (std::uint32_t range : {100'000u, 10'000'000u})
+    {
+        const auto values = create_values(10'000'000, range, 42);
+        const std::string label = " - 10M values, " + std::to_string(sorted_unique(values).size()) + " distinct";
+
+        BENCHMARK("copy, sort & unique" + label)
+        {
+            return mean_of(sorted_unique(values));
+        };
+
+        BENCHMARK("std::set" + label)
+        {
+            const std::set<std::int64_t> distinct(values.begin(), values.end());
+            return static_cast<double>(std::accumulate(distinct.begin(), distinct.end(), std::int64_t{})) / static_cast<double>(distinct.size());
+        };
+
+        BENCHMARK("ExactDistinct" + label)
+        {
+            Aggregates::ExactDistinct<std::int64_t> distinct;
+            distinct.push_range(values);
+            return distinct.mean();
+        };
+
+        BENCHMARK("ApproximateDistinct" + label)
+        {
+            Aggregates::ApproximateDistinct<std::int64_t> distinct;
+            distinct.push_range(values);
+            return distinct.mean();
+        };
+    }
+}
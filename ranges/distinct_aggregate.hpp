@@ -0,0 +1,339 @@
+#ifndef DISTINCT_AGGREGATE_HPP
+#define DISTINCT_AGGREGATE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+// Streaming aggregates of the distinct values of numeric inputs (count, sum & mean of the values seen once or more) -
+// no copy of the input, no sort:
+//
+//   Aggregates::ExactDistinct<int> distinct;
+//   distinct.push_range(shard1);
+//   distinct.push_range(shard2);
+//   double avg = distinct.mean();
+//
+//  * ExactDistinct - an open-addressing hash set (linear probing, a power-of-two table at most half full) in one flat
+//    array, zero marks an empty slot - no allocation per element; the sum of the distinct values is updated on every
+//    new one; constexpr
+//  * ApproximateDistinct - constant memory: a HyperLogLog sketch (2^Precision one-byte registers, a relative error
+//    of ~1.04 / sqrt(2^Precision)) for the count & a sample of the SampleSize values with the smallest hashes -
+//    a uniform sample of the distinct values whatever their multiplicities - for the mean; exact while fewer
+//    than SampleSize distinct values have been seen
+// Both are mergeable - shards of the input aggregated in parallel are combined with merge(); merged approximate
+// shards are identical to one aggregate of the whole input.
+namespace Aggregates
+{
+    namespace Detail
+    {
+        template <typename T>
+        concept Summable = std::is_arithmetic_v<T> && !std::same_as<T, bool> && (sizeof(T) <= 8);
+
+        template <typename T>
+        using SumType = std::conditional_t<std::floating_point<T>, double, std::conditional_t<std::signed_integral<T>, std::int64_t, std::uint64_t>>;
+
+        // the finalizer of splitmix64 - every bit of the input affects all the bits of the hash
+        constexpr std::uint64_t mix(std::uint64_t x) noexcept
+        {
+            x ^= x >> 30;
+            x *= 0xBF58'476D'1CE4'E5B9u;
+            x ^= x >> 27;
+            x *= 0x94D0'49BB'1331'11EBu;
+            x ^= x >> 31;
+            return x;
+        }
+
+        template <Summable T>
+        constexpr std::uint64_t hash(T value) noexcept
+        {
+            if constexpr (std::floating_point<T>)
+            {
+                if (value == T{}) // -0.0 == 0.0
+                    value = T{};
+                if constexpr (sizeof(T) == 4)
+                    return mix(std::bit_cast<std::uint32_t>(value));
+                else
+                    return mix(std::bit_cast<std::uint64_t>(value));
+            }
+            else
+                return mix(static_cast<std::uint64_t>(value));
+        }
+    } // namespace Detail
+
+    //////////////////////////////////////////////////////////////////////
+    // ExactDistinct - O(distinct values) memory
+
+    template <Detail::Summable T>
+    class ExactDistinct
+    {
+    public:
+        using sum_type = Detail::SumType<T>;
+
+        constexpr ExactDistinct() = default;
+
+        constexpr explicit ExactDistinct(std::size_t expected_count) { rehash(std::bit_ceil(std::max<std::size_t>(16, 2 * expected_count))); }
+
+        // true if the value has not been seen before
+        constexpr bool push(T value)
+        {
+            reserve(1);
+            return push_hashed(value, Detail::hash(value));
+        }
+
+        // the values of a contiguous range of T are pushed in batches (at run time)
+        template <std::ranges::input_range TRange>
+            requires std::convertible_to<std::ranges::range_reference_t<TRange>, T>
+        constexpr void push_range(TRange&& rng)
+        {
+            if constexpr (std::ranges::contiguous_range<TRange> && std::same_as<std::ranges::range_value_t<TRange>, T>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    push_batched(std::ranges::data(rng), std::ranges::size(rng));
+                    return;
+                }
+            }
+
+            for (auto&& item : rng)
+                push(static_cast<T>(item));
+        }
+
+        constexpr void merge(const ExactDistinct& other)
+        {
+            if (other.has_zero_)
+                push(T{});
+            for (T value : other.slots_)
+            {
+                if (value != T{})
+                    push(value);
+            }
+        }
+
+        constexpr bool contains(T value) const
+        {
+            if (value == T{})
+                return has_zero_;
+            if (slots_.empty())
+                return false;
+
+            const std::size_t mask = slots_.size() - 1;
+            for (std::size_t i = Detail::hash(value) & mask;; i = (i + 1) & mask)
+            {
+                if (slots_[i] == value)
+                    return true;
+                if (slots_[i] == T{})
+                    return false;
+            }
+        }
+
+        constexpr std::size_t count() const noexcept { return count_; }
+
+        constexpr sum_type sum() const noexcept { return sum_; }
+
+        // NaN for no values
+        constexpr double mean() const noexcept { return static_cast<double>(sum_) / static_cast<double>(count_); }
+
+    private:
+        static constexpr std::size_t batch_size = 16;
+
+        // room for count more values - the table doubled until it is at most half full
+        constexpr void reserve(std::size_t count)
+        {
+            std::size_t capacity = std::max<std::size_t>(16, slots_.size());
+            while (2 * (count_ + count) > capacity)
+                capacity *= 2;
+            rehash(capacity);
+        }
+
+        // there is room for the value
+        constexpr bool push_hashed(T value, std::uint64_t hash)
+        {
+            if (value == T{})
+            {
+                if (has_zero_)
+                    return false;
+                has_zero_ = true;
+            }
+            else if (!insert(value, hash))
+                return false;
+
+            sum_ += static_cast<sum_type>(value);
+            ++count_;
+            return true;
+        }
+
+        // the slots of a batch of values are prefetched before any of them is looked up -
+        // the cache misses of a table larger than the cache overlap
+        void push_batched(const T* values, std::size_t size)
+        {
+            std::array<std::uint64_t, batch_size> hashes;
+            for (std::size_t offset = 0; offset < size; offset += batch_size)
+            {
+                const std::size_t count = std::min(batch_size, size - offset);
+                reserve(count);
+
+                const std::size_t mask = slots_.size() - 1;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    hashes[i] = Detail::hash(values[offset + i]);
+                    __builtin_prefetch(&slots_[hashes[i] & mask]);
+                }
+
+                for (std::size_t i = 0; i < count; ++i)
+                    push_hashed(values[offset + i], hashes[i]);
+            }
+        }
+
+        // a non-zero value - the table has room for it
+        constexpr bool insert(T value, std::uint64_t hash)
+        {
+            const std::size_t mask = slots_.size() - 1;
+            for (std::size_t i = hash & mask;; i = (i + 1) & mask)
+            {
+                if (slots_[i] == T{})
+                {
+                    slots_[i] = value;
+                    return true;
+                }
+                if (slots_[i] == value)
+                    return false;
+            }
+        }
+
+        constexpr void rehash(std::size_t capacity)
+        {
+            if (capacity <= slots_.size())
+                return;
+
+            std::vector<T> slots(capacity);
+            slots.swap(slots_);
+            for (T value : slots)
+            {
+                if (value != T{})
+                    insert(value, Detail::hash(value));
+            }
+        }
+
+        std::vector<T> slots_; // zero - an empty slot (the zero value is kept in has_zero_), at most half of them used
+        bool has_zero_ = false;
+        std::size_t count_ = 0;
+        sum_type sum_{};
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    // ApproximateDistinct - 2^Precision bytes & SampleSize values
+
+    template <Detail::Summable T, unsigned Precision = 12, std::size_t SampleSize = 1024>
+    class ApproximateDistinct
+    {
+        static_assert(Precision >= 4 && Precision <= 18);
+        static_assert(SampleSize > 0);
+
+        static constexpr std::size_t register_count = std::size_t{1} << Precision;
+
+        struct Sampled
+        {
+            std::uint64_t hash;
+            T value;
+        };
+
+    public:
+        using sum_type = Detail::SumType<T>;
+
+        ApproximateDistinct() { sample_.reserve(SampleSize + 1); }
+
+        void push(T value)
+        {
+            const std::uint64_t hash = Detail::hash(value);
+
+            // the top bits select a register, it keeps the longest run of leading zeros of the other bits (+ 1)
+            const std::size_t index = hash >> (64 - Precision);
+            const auto rank = static_cast<std::uint8_t>(std::min<int>(std::countl_zero(hash << Precision), 64 - Precision) + 1);
+            registers_[index] = std::max(registers_[index], rank);
+
+            if (sample_.size() < SampleSize || hash < sample_.back().hash)
+                add_to_sample({hash, value});
+        }
+
+        template <std::ranges::input_range TRange>
+            requires std::convertible_to<std::ranges::range_reference_t<TRange>, T>
+        void push_range(TRange&& rng)
+        {
+            for (auto&& item : rng)
+                push(static_cast<T>(item));
+        }
+
+        void merge(const ApproximateDistinct& other)
+        {
+            for (std::size_t i = 0; i < register_count; ++i)
+                registers_[i] = std::max(registers_[i], other.registers_[i]);
+
+            std::vector<Sampled> sample;
+            sample.reserve(SampleSize + 1);
+            std::ranges::set_union(sample_, other.sample_, std::back_inserter(sample), {}, &Sampled::hash, &Sampled::hash);
+            if (sample.size() > SampleSize)
+                sample.resize(SampleSize);
+            sample_ = std::move(sample);
+        }
+
+        // exact below SampleSize distinct values
+        double count() const
+        {
+            if (sample_.size() < SampleSize)
+                return static_cast<double>(sample_.size());
+
+            constexpr double m = register_count;
+            constexpr double alpha = 0.7213 / (1.0 + 1.079 / m);
+
+            double harmonic = 0;
+            std::size_t zeros = 0;
+            for (std::uint8_t rank : registers_)
+            {
+                harmonic += std::ldexp(1.0, -rank);
+                zeros += rank == 0;
+            }
+
+            double estimate = alpha * m * m / harmonic;
+            if (estimate <= 2.5 * m && zeros > 0) // few values - linear counting of the empty registers
+                estimate = m * std::log(m / static_cast<double>(zeros));
+            return std::max(estimate, static_cast<double>(SampleSize));
+        }
+
+        // NaN for no values
+        double mean() const
+        {
+            sum_type sum{};
+            for (const Sampled& item : sample_)
+                sum += static_cast<sum_type>(item.value);
+            return static_cast<double>(sum) / static_cast<double>(sample_.size());
+        }
+
+        double sum() const { return sample_.empty() ? 0.0 : mean() * count(); }
+
+    private:
+        // sorted by the hashes - a value is sampled once, the one of the largest hash is dropped when full
+        void add_to_sample(const Sampled& item)
+        {
+            const auto pos = std::ranges::lower_bound(sample_, item.hash, {}, &Sampled::hash);
+            if (pos != sample_.end() && pos->hash == item.hash)
+                return;
+
+            sample_.insert(pos, item);
+            if (sample_.size() > SampleSize)
+                sample_.pop_back();
+        }
+
+        std::array<std::uint8_t, register_count> registers_{};
+        std::vector<Sampled> sample_;
+    };
+} // namespace Aggregates
+
+#endif
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <random.hpp>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "external_sort.hpp"
+
+namespace
+{
+    std::vector<std::uint32_t> random_values(std::size_t size, std::uint64_t seed = 42)
+    {
+        helpers::random::PCG rnd{seed};
+        std::vector<std::uint32_t> values(size);
+        for (std::uint32_t& value : values)
+            value = rnd();
+        return values;
+    }
+
+    struct Record
+    {
+        std::uint64_t id;
+        double score;
+        char tag[4];
+    };
+
+    // a directory of its own - no spill file may be left in it
+    class TempDirectory
+    {
+    public:
+        explicit TempDirectory(std::string_view name)
+            : path_{std::filesystem::temp_directory_path() / name}
+        {
+            std::filesystem::create_directories(path_);
+        }
+
+        TempDirectory(const TempDirectory&) = delete;
+        TempDirectory& operator=(const TempDirectory&) = delete;
+
+        ~TempDirectory() { std::filesystem::remove_all(path_); }
+
+        const std::filesystem::path& path() const noexcept { return path_; }
+
+    private:
+        std::filesystem::path path_;
+    };
+} // namespace
+
+TEST_CASE("loser tree - k-way merge")
+{
+    const std::vector<std::vector<int>> sources = {{1, 4, 9}, {2, 3, 10, 11}, {}, {0, 5}, {6, 7, 8}};
+    std::vector<std::size_t> positions(sources.size());
+
+    auto less = [&](std::size_t lhs, std::size_t rhs) {
+        if (positions[lhs] == sources[lhs].size())
+            return false;
+        if (positions[rhs] == sources[rhs].size())
+            return true;
+        return sources[lhs][positions[lhs]] < sources[rhs][positions[rhs]];
+    };
+
+    par::Detail::LoserTree tree{sources.size(), less};
+    std::vector<int> merged;
+    while (positions[tree.winner()] != sources[tree.winner()].size())
+    {
+        merged.push_back(sources[tree.winner()][positions[tree.winner()]++]);
+        tree.replay();
+    }
+
+    CHECK(merged == std::vector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
+}
+
+TEST_CASE("external_sort")
+{
+    const TempDirectory directory{"external_sort_test"};
+
+    SECTION("many runs, several merge passes")
+    {
+        const std::vector<std::uint32_t> values = random_values(300'000);
+        std::vector<std::uint32_t> expected = values;
+        std::ranges::sort(expected);
+
+        for (std::size_t budget : {std::size_t{1} << 20, std::size_t{64} << 10, std::size_t{1000}})
+        {
+            std::vector<std::uint32_t> sorted;
+            par::external_sort(values, std::back_inserter(sorted), std::less{}, std::identity{}, {.memory_budget = budget, .temp_directory = directory.path()});
+            CHECK(sorted == expected);
+        }
+
+        CHECK(std::filesystem::is_empty(directory.path()));
+    }
+
+    SECTION("records, comparator & projection")
+    {
+        helpers::random::PCG rnd{7};
+        std::vector<Record> records(50'000);
+        for (std::size_t i = 0; i < records.size(); ++i)
+            records[i] = {i, static_cast<double>(rnd() % 1000) / 10, {'r', 'e', 'c', '\0'}};
+
+        std::vector<Record> sorted(records.size());
+        const auto end = par::external_sort(records, sorted.begin(), std::greater{}, &Record::score, {.memory_budget = 32 << 10, .temp_directory = directory.path()});
+
+        CHECK(end == sorted.end());
+        CHECK(std::ranges::is_sorted(sorted, std::greater{}, &Record::score));
+
+        std::ranges::sort(sorted, {}, &Record::id);
+        CHECK(std::ranges::equal(sorted, records, {}, &Record::id, &Record::id));
+    }
+
+    SECTION("input range of unknown size")
+    {
+        std::istringstream input{"5 3 9 1 7 2 8"};
+        std::vector<int> sorted;
+        par::external_sort(std::views::istream<int>(input), std::back_inserter(sorted), std::less{}, std::identity{}, {.memory_budget = 3 * sizeof(int) * 2, .temp_directory = directory.path()});
+
+        CHECK(sorted == std::vector{1, 2, 3, 5, 7, 8, 9});
+    }
+
+    SECTION("empty input")
+    {
+        std::vector<int> sorted;
+        par::external_sort(std::vector<int>{}, std::back_inserter(sorted), std::less{}, std::identity{}, {.temp_directory = directory.path()});
+        CHECK(sorted.empty());
+    }
+
+    SECTION("budget too small")
+    {
+        std::vector<int> sorted;
+        CHECK_THROWS_AS(par::external_sort(std::vector{3, 2, 1}, std::back_inserter(sorted), std::less{}, std::identity{}, {.memory_budget = 4 * sizeof(int)}),
+            std::invalid_argument);
+    }
+}
+
+TEST_CASE("external_sort - benchmarks", "[.][benchmark]")
+{
+    constexpr std::size_t size = 20'000'000;
+    const std::vector<std::uint32_t> values = random_values(size);
+    std::vector<std::uint32_t> sorted(size);
+
+    auto measure = [](auto function) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::cout << "external_sort of " << size << " uint32 (" << size * sizeof(std::uint32_t) / (1 << 20) << " MiB):\n";
+    std::cout << "  std::ranges::sort in memory: " << measure([&] {
+        std::ranges::copy(values, sorted.begin());
+        std::ranges::sort(sorted);
+    }) << " s\n";
+
+    for (std::size_t budget_mib : {64, 16, 4})
+    {
+        const double time = measure([&] { par::external_sort(values, sorted.begin(), std::less{}, std::identity{}, {.memory_budget = budget_mib << 20}); });
+        std::cout << "  external_sort, budget " << budget_mib << " MiB: " << time << " s\n";
+    }
+
+    CHECK(std::ranges::is_sorted(sorted));
+}
@@ -0,0 +1,448 @@
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <unistd.h>
+#define EXTERNAL_SORT_POSIX 1
+#else
+#include <cstdio>
+#include <mutex>
+#endif
+
+#include "parallel_algorithms.hpp"
+
+// External merge sort - for inputs that do not fit in memory:
+//
+//   par::external_sort(records, out, std::less{}, &Record::key, {.memory_budget = 1 << 30});
+//
+//  * runs - the input is read into a buffer of memory_budget bytes, its chunks are sorted in parallel
+//    (ThreadPool::global()) and written to a temporary file with a single write - every chunk is a run
+//  * merge - k runs merged with a loser tree (log k comparisons per element); every run is read through
+//    two blocks - while one is consumed the next one is read ahead on the thread pool;
+//    if there are too many runs for blocks of a reasonable size, they are merged in several passes
+// The buffers never take more than memory_budget bytes together (the bookkeeping - a few words per run - aside).
+// The records must be trivially copyable - they are written & read as bytes.
+namespace par
+{
+    struct ExternalSortOptions
+    {
+        std::size_t memory_budget = std::size_t{256} << 20; // bytes
+        std::filesystem::path temp_directory = std::filesystem::temp_directory_path();
+    };
+
+    namespace Detail
+    {
+        // an anonymous temporary file - removed when closed
+        class SpillFile
+        {
+        public:
+            explicit SpillFile(const std::filesystem::path& directory)
+            {
+                static std::atomic<unsigned> counter{0};
+                const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+                const std::filesystem::path path = directory
+                    / ("external_sort_" + std::to_string(stamp) + "_" + std::to_string(counter.fetch_add(1)) + ".tmp");
+
+#ifdef EXTERNAL_SORT_POSIX
+                fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+                if (fd_ == -1)
+                    throw std::system_error(errno, std::generic_category(), "cannot create " + path.string());
+                ::unlink(path.c_str()); // the data lives as long as the descriptor
+#else
+                file_ = std::fopen(path.string().c_str(), "w+b");
+                if (!file_)
+                    throw std::system_error(errno, std::generic_category(), "cannot create " + path.string());
+                path_ = path;
+#endif
+            }
+
+            SpillFile(const SpillFile&) = delete;
+            SpillFile& operator=(const SpillFile&) = delete;
+
+            ~SpillFile()
+            {
+#ifdef EXTERNAL_SORT_POSIX
+                ::close(fd_);
+#else
+                std::fclose(file_);
+                std::error_code ignored;
+                std::filesystem::remove(path_, ignored);
+#endif
+            }
+
+            // appends the bytes at the end of the file - returns their offset
+            std::uint64_t append(const void* data, std::size_t size)
+            {
+                const std::uint64_t offset = size_;
+#ifdef EXTERNAL_SORT_POSIX
+                const char* pos = static_cast<const char*>(data);
+                while (size > 0)
+                {
+                    const ::ssize_t written = ::pwrite(fd_, pos, size, static_cast<::off_t>(size_));
+                    if (written == -1)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        throw std::system_error(errno, std::generic_category(), "cannot write a run");
+                    }
+                    pos += written;
+                    size -= static_cast<std::size_t>(written);
+                    size_ += static_cast<std::uint64_t>(written);
+                }
+#else
+                std::lock_guard lk{mtx_};
+                if (std::fseek(file_, static_cast<long>(size_), SEEK_SET) != 0 || std::fwrite(data, 1, size, file_) != size)
+                    throw std::system_error(errno, std::generic_category(), "cannot write a run");
+                size_ += size;
+#endif
+                return offset;
+            }
+
+            std::uint64_t size() const noexcept { return size_; }
+
+            // safe to call concurrently
+            void read(std::uint64_t offset, void* data, std::size_t size) const
+            {
+#ifdef EXTERNAL_SORT_POSIX
+                char* pos = static_cast<char*>(data);
+                while (size > 0)
+                {
+                    const ::ssize_t count = ::pread(fd_, pos, size, static_cast<::off_t>(offset));
+                    if (count == -1 && errno == EINTR)
+                        continue;
+                    if (count <= 0)
+                        throw std::system_error(count == 0 ? EIO : errno, std::generic_category(), "cannot read a run");
+                    pos += count;
+                    size -= static_cast<std::size_t>(count);
+                    offset += static_cast<std::uint64_t>(count);
+                }
+#else
+                std::lock_guard lk{mtx_};
+                if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0 || std::fread(data, 1, size, file_) != size)
+                    throw std::system_error(errno, std::generic_category(), "cannot read a run");
+#endif
+            }
+
+        private:
+#ifdef EXTERNAL_SORT_POSIX
+            int fd_ = -1;
+#else
+            std::FILE* file_ = nullptr;
+            std::filesystem::path path_;
+            mutable std::mutex mtx_;
+#endif
+            std::uint64_t size_ = 0;
+        };
+
+        // a sorted sequence of records in a spill file
+        struct Run
+        {
+            std::uint64_t offset; // bytes
+            std::uint64_t size;   // records
+        };
+
+        // tournament tree for a k-way merge: the internal nodes keep the losers of their matches, so after
+        // the winner is replaced only its path to the root is replayed (one comparison per level)
+        template <typename TLess>
+        class LoserTree
+        {
+        public:
+            // less(i, j) - the current element of source i goes before the one of source j
+            LoserTree(std::size_t sources, TLess less)
+                : less_{std::move(less)}
+                , sources_{sources}
+                , nodes_(std::max<std::size_t>(sources, 1))
+            {
+                // the winners of the matches in a complete binary tree - the sources are the leaves [k, 2k)
+                std::vector<std::size_t> winners(2 * sources_);
+                for (std::size_t i = 0; i < sources_; ++i)
+                    winners[sources_ + i] = i;
+
+                for (std::size_t node = sources_ > 0 ? sources_ - 1 : 0; node > 0; --node)
+                {
+                    const std::size_t left = winners[2 * node];
+                    const std::size_t right = winners[2 * node + 1];
+                    const bool right_wins = less_(right, left);
+                    winners[node] = right_wins ? right : left;
+                    nodes_[node] = right_wins ? left : right;
+                }
+
+                nodes_[0] = sources_ > 1 ? winners[1] : 0;
+            }
+
+            std::size_t winner() const noexcept { return nodes_[0]; }
+
+            // the current element of the winner has changed
+            void replay()
+            {
+                std::size_t winner = nodes_[0];
+                for (std::size_t node = (winner + sources_) / 2; node > 0; node /= 2)
+                {
+                    if (less_(nodes_[node], winner))
+                        std::swap(nodes_[node], winner);
+                }
+                nodes_[0] = winner;
+            }
+
+        private:
+            TLess less_;
+            std::size_t sources_;
+            std::vector<std::size_t> nodes_;
+        };
+
+        // the records of a run read block by block - the next block is read on the thread pool
+        // while the current one is merged
+        template <typename T>
+        class RunReader
+        {
+        public:
+            RunReader(const SpillFile& file, Run run, T* front, T* back, std::size_t block_size)
+                : file_{file}
+                , run_{run}
+                , front_{front}
+                , back_{back}
+                , block_size_{block_size}
+            {
+                load_front_now();
+                read_ahead();
+            }
+
+            RunReader(const RunReader&) = delete;
+            RunReader& operator=(const RunReader&) = delete;
+
+            bool exhausted() const noexcept { return position_ == front_size_; }
+
+            const T& current() const noexcept { return front_[position_]; }
+
+            void next()
+            {
+                if (++position_ == front_size_ && back_size_ > 0)
+                {
+                    read_ahead_group_.wait(); // rethrows a read error
+                    std::swap(front_, back_);
+                    front_size_ = back_size_;
+                    position_ = 0;
+                    read_ahead();
+                }
+            }
+
+        private:
+            void load_front_now()
+            {
+                front_size_ = block(next_offset_);
+                file_.read(byte_offset(next_offset_), front_, front_size_ * sizeof(T));
+                next_offset_ += front_size_;
+            }
+
+            void read_ahead()
+            {
+                back_size_ = block(next_offset_);
+                if (back_size_ == 0)
+                    return;
+
+                const std::uint64_t offset = byte_offset(next_offset_);
+                next_offset_ += back_size_;
+                read_ahead_group_.run([this, offset, size = back_size_ * sizeof(T)] { file_.read(offset, back_, size); });
+            }
+
+            std::size_t block(std::uint64_t from) const noexcept { return static_cast<std::size_t>(std::min<std::uint64_t>(block_size_, run_.size - from)); }
+
+            std::uint64_t byte_offset(std::uint64_t record) const noexcept { return run_.offset + record * sizeof(T); }
+
+            const SpillFile& file_;
+            Run run_;
+            T* front_;
+            T* back_;
+            std::size_t block_size_;
+            std::size_t front_size_ = 0;
+            std::size_t back_size_ = 0;
+            std::size_t position_ = 0;
+            std::uint64_t next_offset_ = 0; // records of the run already read or being read
+            TaskGroup read_ahead_group_;    // the last member - joined before the buffers go
+        };
+
+        inline constexpr std::size_t min_block_bytes = 64 << 10; // smaller blocks - more seeks than reads
+
+        // merges the runs into out (records) - memory: 2 blocks per run in budget
+        template <typename T, typename TOut, typename TComp, typename TProj>
+        TOut merge_runs(const SpillFile& file, const std::vector<Run>& runs, TOut out, TComp& comp, TProj& proj, std::size_t budget)
+        {
+            const std::size_t block_size = budget / (2 * runs.size()) / sizeof(T);
+            auto buffer = std::make_unique_for_overwrite<T[]>(2 * runs.size() * block_size);
+
+            std::vector<std::unique_ptr<RunReader<T>>> readers;
+            readers.reserve(runs.size());
+            for (std::size_t i = 0; i < runs.size(); ++i)
+                readers.push_back(std::make_unique<RunReader<T>>(file, runs[i], &buffer[2 * i * block_size], &buffer[(2 * i + 1) * block_size], block_size));
+
+            auto less = [&](std::size_t lhs, std::size_t rhs) {
+                if (readers[lhs]->exhausted())
+                    return false;
+                if (readers[rhs]->exhausted())
+                    return true;
+                return std::invoke(comp, std::invoke(proj, readers[lhs]->current()), std::invoke(proj, readers[rhs]->current()));
+            };
+
+            LoserTree tree{readers.size(), less};
+            for (;;)
+            {
+                RunReader<T>& reader = *readers[tree.winner()];
+                if (reader.exhausted())
+                    return out;
+
+                *out = reader.current();
+                ++out;
+                reader.next();
+                tree.replay();
+            }
+        }
+
+        // writes the records to a spill file through a block of the budget
+        template <typename T>
+        class RunWriter
+        {
+        public:
+            using difference_type = std::ptrdiff_t;
+
+            RunWriter(SpillFile& file, T* block, std::size_t block_size) noexcept
+                : file_{&file}
+                , block_{block}
+                , block_size_{block_size}
+            { }
+
+            RunWriter& operator*() noexcept { return *this; }
+
+            RunWriter& operator=(const T& record)
+            {
+                block_[size_++] = record;
+                if (size_ == block_size_)
+                    flush();
+                return *this;
+            }
+
+            RunWriter& operator++() noexcept { return *this; }
+
+            RunWriter& operator++(int) noexcept { return *this; }
+
+            void flush()
+            {
+                if (size_ > 0)
+                    file_->append(block_, size_ * sizeof(T));
+                size_ = 0;
+            }
+
+        private:
+            SpillFile* file_;
+            T* block_;
+            std::size_t block_size_;
+            std::size_t size_ = 0;
+        };
+    } // namespace Detail
+
+    // sorts the records of input (any input range) into out; not stable
+    template <std::ranges::input_range TRange, std::weakly_incrementable TOut, typename TComp = std::ranges::less, typename TProj = std::identity>
+        requires std::is_trivially_copyable_v<std::ranges::range_value_t<TRange>> && std::default_initializable<std::ranges::range_value_t<TRange>>
+        && std::indirectly_writable<TOut, const std::ranges::range_value_t<TRange>&>
+        && std::sortable<std::ranges::range_value_t<TRange>*, TComp, TProj>
+    TOut external_sort(TRange&& input, TOut out, TComp comp = {}, TProj proj = {}, const ExternalSortOptions& options = {})
+    {
+        using T = std::ranges::range_value_t<TRange>;
+
+        const std::size_t budget = options.memory_budget;
+        if (budget < 5 * sizeof(T)) // a merge pass needs 2 blocks of at least 1 record per run (2 runs at least) & 1 to write
+            throw std::invalid_argument("external_sort: the memory budget is too small for the records");
+
+        Detail::SpillFile file{options.temp_directory};
+        std::vector<Detail::Run> runs;
+
+        // runs - the chunks of every buffer-load sorted in parallel, the buffer written at once
+        {
+            const std::size_t capacity = budget / sizeof(T);
+            auto buffer = std::make_unique_for_overwrite<T[]>(capacity);
+
+            auto it = std::ranges::begin(input);
+            const auto last = std::ranges::end(input);
+            while (it != last)
+            {
+                std::size_t size = 0;
+                for (; size < capacity && it != last; ++it)
+                    buffer[size++] = *it;
+
+                const auto chunks = Detail::chunk_count(static_cast<std::ptrdiff_t>(size));
+                std::vector<Detail::Run> chunk_runs(chunks);
+                auto sort_chunk = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t index) {
+                    std::ranges::sort(buffer.get() + begin, buffer.get() + end, std::ref(comp), std::ref(proj));
+                    chunk_runs[index] = {static_cast<std::uint64_t>(begin) * sizeof(T), static_cast<std::uint64_t>(end - begin)};
+                };
+                Detail::for_chunks(static_cast<std::ptrdiff_t>(size), chunks, sort_chunk);
+
+                const std::uint64_t offset = file.append(buffer.get(), size * sizeof(T));
+                for (Detail::Run& run : chunk_runs)
+                    runs.push_back({offset + run.offset, run.size});
+            }
+        }
+
+        // merge passes - at most max_fan_in runs at once, so that the blocks do not get too small
+        const std::size_t max_fan_in = std::max<std::size_t>(2, budget / (2 * std::max(Detail::min_block_bytes, sizeof(T))));
+        std::unique_ptr<Detail::SpillFile> merged_file;
+        const Detail::SpillFile* current_file = &file;
+
+        while (runs.size() > max_fan_in)
+        {
+            // the budget split between the readers of a group & the block of the writer
+            const std::size_t fan_in = std::min(max_fan_in, std::max<std::size_t>(2, budget / (3 * std::max(Detail::min_block_bytes, sizeof(T)))));
+            const std::size_t writer_block_size = std::max<std::size_t>(1, budget / (2 * fan_in + 1) / sizeof(T));
+            const std::size_t readers_budget = budget - writer_block_size * sizeof(T);
+
+            auto target = std::make_unique<Detail::SpillFile>(options.temp_directory);
+            std::vector<Detail::Run> merged_runs;
+            auto writer_block = std::make_unique_for_overwrite<T[]>(writer_block_size);
+
+            for (std::size_t first = 0; first < runs.size(); first += fan_in)
+            {
+                const std::vector<Detail::Run> group(runs.begin() + first, runs.begin() + std::min(first + fan_in, runs.size()));
+
+                std::uint64_t size = 0;
+                for (const Detail::Run& run : group)
+                    size += run.size;
+
+                Detail::RunWriter<T> writer{*target, writer_block.get(), writer_block_size};
+                const std::uint64_t offset = target->size();
+                writer = Detail::merge_runs<T>(*current_file, group, writer, comp, proj, readers_budget);
+                writer.flush();
+                merged_runs.push_back({offset, size});
+            }
+
+            runs = std::move(merged_runs);
+            merged_file = std::move(target); // the previous intermediate file is removed
+            current_file = merged_file.get();
+        }
+
+        if (runs.empty())
+            return out;
+
+        return Detail::merge_runs<T>(*current_file, runs, std::move(out), comp, proj, budget);
+    }
+} // namespace par
+
+#endif
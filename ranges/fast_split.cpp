@@ -0,0 +1,160 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <random.hpp>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fast_split.hpp"
+
+using namespace std::literals;
+
+namespace
+{
+    std::vector<std::string_view> split_with_std(std::string_view text, std::string_view separator)
+    {
+        std::vector<std::string_view> tokens;
+        for (auto&& rng : text | std::views::split(separator))
+            tokens.emplace_back(rng.begin(), rng.end());
+        return tokens;
+    }
+
+    std::vector<std::string_view> split_with_fast_split(std::string_view text, std::string_view separator)
+    {
+        std::vector<std::string_view> tokens;
+        for (std::string_view token : Text::fast_split(text, separator))
+            tokens.push_back(token);
+        return tokens;
+    }
+
+    // text from a tiny alphabet, so that partial matches of the separator are frequent
+    std::string random_text(helpers::random::PCG& rnd, std::size_t size, std::string_view alphabet)
+    {
+        std::string text(size, ' ');
+        for (char& c : text)
+            c = alphabet[rnd() % alphabet.size()];
+        return text;
+    }
+
+    std::string create_log(std::size_t lines)
+    {
+        helpers::random::PCG rnd{42};
+        const std::string_view levels[] = {"INFO", "DEBUG", "WARN", "ERROR"};
+
+        std::string log;
+        for (std::size_t i = 0; i < lines; ++i)
+        {
+            log += "2024-03-0" + std::to_string(rnd() % 9 + 1) + "T12:" + std::to_string(rnd() % 60) + ":00 | ";
+            log += levels[rnd() % 4];
+            log += " | worker-" + std::to_string(rnd() % 64) + " | request " + std::to_string(rnd()) + " handled in ";
+            log += std::to_string(rnd() % 1000) + " ms, status=" + std::to_string(200 + rnd() % 4 * 100) + "\r\n";
+        }
+        return log;
+    }
+} // namespace
+
+TEST_CASE("fast_find")
+{
+    CHECK(Text::fast_find("abc,def", ",") == 3);
+    CHECK(Text::fast_find("abc,def", ",", 4) == std::string_view::npos);
+    CHECK(Text::fast_find("abc", "abcd") == std::string_view::npos);
+    CHECK(Text::fast_find("aaab", "ab") == 2);
+
+    const std::string long_text = std::string(100, 'x') + "--><--" + std::string(100, 'x');
+    CHECK(Text::fast_find(long_text, "--><--") == 100);
+    CHECK(Text::fast_find(long_text, "-->x") == std::string_view::npos);
+
+    // every position with respect to the 16/32-byte blocks
+    for (std::size_t pos = 0; pos < 100; ++pos)
+    {
+        std::string text(100, '.');
+        text.replace(pos, 3, "<->", 0, std::min<std::size_t>(3, 100 - pos));
+        CHECK(Text::fast_find(text, "<->") == (pos + 3 <= 100 ? pos : std::string_view::npos));
+    }
+}
+
+TEST_CASE("fast_split - the same tokens as std::views::split")
+{
+    SECTION("edge cases")
+    {
+        for (std::string_view text : {""sv, ","sv, ",,"sv, "a"sv, "a,"sv, ",a"sv, "a,,b"sv, "abc,def,ghi"sv})
+            CHECK(split_with_fast_split(text, ",") == split_with_std(text, ","));
+
+        CHECK(split_with_fast_split("abc", "") == split_with_std("abc", ""));
+        CHECK(split_with_fast_split("ab", "abc") == std::vector{"ab"sv});
+        CHECK(split_with_fast_split("aaa", "aa") == std::vector{""sv, "a"sv});
+    }
+
+    SECTION("random texts")
+    {
+        helpers::random::PCG rnd{665};
+
+        for (std::string_view separator : {"a"sv, "ab"sv, "aba"sv, "<=>"sv, "abcabcabcabcabcabcabc"sv})
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                const std::string text = random_text(rnd, rnd() % 1000, "abc<=>");
+                CHECK(split_with_fast_split(text, separator) == split_with_std(text, separator));
+            }
+        }
+    }
+}
+
+TEST_CASE("fast_split - pipe & ranges")
+{
+    const std::string_view line = "GET | /index.html | 200 | 1.2 ms";
+
+    auto fields = line | Text::fast_split(" | ");
+    static_assert(std::ranges::forward_range<decltype(fields)>);
+    static_assert(std::ranges::view<decltype(fields)>);
+
+    CHECK(std::ranges::distance(fields) == 4);
+    CHECK(*std::ranges::next(fields.begin(), 2) == "200");
+
+    auto lengths = fields | std::views::transform(&std::string_view::size);
+    CHECK(std::ranges::equal(lengths, std::vector<std::size_t>{3, 11, 3, 6}));
+}
+
+TEST_CASE("fast_split - benchmarks", "[.][benchmark]")
+{
+    const std::string log = create_log(1'000); // ~110 KB - stays in the cache, so the search itself is measured
+
+    auto count_tokens = [](auto&& tokens) {
+        std::size_t count = 0;
+        std::size_t length = 0;
+        for (auto&& token : tokens)
+        {
+            ++count;
+            length += std::ranges::distance(token);
+        }
+        return count + length;
+    };
+
+    for (std::string_view separator : {","sv, " | "sv, "\r\n"sv, "handled in"sv})
+    {
+        const std::string name{separator == "\r\n" ? "\\r\\n"sv : separator};
+
+        BENCHMARK("std::views::split - '" + name + "'")
+        {
+            return count_tokens(log | std::views::split(separator));
+        };
+
+        BENCHMARK("string_view::find loop - '" + name + "'")
+        {
+            std::size_t result = 0;
+            std::string_view text = log;
+            for (std::size_t pos = text.find(separator); pos != std::string_view::npos; pos = text.find(separator))
+            {
+                result += 1 + pos;
+                text.remove_prefix(pos + separator.size());
+            }
+            return result + 1 + text.size();
+        };
+
+        BENCHMARK("Text::fast_split - '" + name + "'")
+        {
+            return count_tokens(Text::fast_split(log, separator));
+        };
+    }
+}
@@ -0,0 +1,320 @@
+#ifndef FAST_SPLIT_HPP
+#define FAST_SPLIT_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FAST_SPLIT_X86 1
+#endif
+
+// Substring search with SIMD filtering: two bytes of the separator (the first one and the last one different from it)
+// are compared against 64 positions at once (2 x AVX2 or 4 x SSE2 compares) giving a bitmask of candidates,
+// only the candidates are verified with memcmp. Works for separators of any length and needs no SSE4.2
+// string instructions. A split keeps the bitmask between tokens, so short tokens cost a few bit operations.
+namespace Text
+{
+    namespace Detail
+    {
+        inline constexpr std::size_t npos = std::string_view::npos;
+        inline constexpr std::size_t chunk_size = 64; // bits in a candidate mask
+
+        // the second filter byte - distinct from the first one, so that e.g. " | " is not filtered by two spaces
+        inline std::size_t probe_offset(std::string_view separator) noexcept
+        {
+            const std::size_t offset = separator.find_last_not_of(separator.front());
+            return offset == npos ? separator.size() - 1 : offset;
+        }
+
+        // candidates for the positions chunk..chunk+63 (all of them must be valid starts of the separator)
+        inline std::uint64_t chunk_candidates_scalar(const char* chunk, char first, char second, std::size_t probe) noexcept
+        {
+            std::uint64_t mask = 0;
+            for (std::size_t i = 0; i < chunk_size; ++i)
+                mask |= static_cast<std::uint64_t>(chunk[i] == first && chunk[i + probe] == second) << i;
+            return mask;
+        }
+
+        using ChunkCandidates = std::uint64_t (*)(const char*, char, char, std::size_t) noexcept;
+
+#ifdef FAST_SPLIT_X86
+        inline std::uint64_t chunk_candidates_sse2(const char* chunk, char first, char second, std::size_t probe) noexcept
+        {
+            const __m128i first_bytes = _mm_set1_epi8(first);
+            const __m128i second_bytes = _mm_set1_epi8(second);
+
+            std::uint64_t mask = 0;
+            for (std::size_t i = 0; i < chunk_size; i += 16)
+            {
+                const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + i));
+                const __m128i block_second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + i + probe));
+                const auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first_bytes, block_first), _mm_cmpeq_epi8(second_bytes, block_second))));
+                mask |= static_cast<std::uint64_t>(bits) << i;
+            }
+            return mask;
+        }
+
+        __attribute__((target("avx2"))) inline std::uint64_t chunk_candidates_avx2(const char* chunk, char first, char second, std::size_t probe) noexcept
+        {
+            const __m256i first_bytes = _mm256_set1_epi8(first);
+            const __m256i second_bytes = _mm256_set1_epi8(second);
+
+            const __m256i low_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk));
+            const __m256i low_second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk + probe));
+            const __m256i high_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk + 32));
+            const __m256i high_second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk + 32 + probe));
+
+            const auto low = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first_bytes, low_first), _mm256_cmpeq_epi8(second_bytes, low_second))));
+            const auto high = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first_bytes, high_first), _mm256_cmpeq_epi8(second_bytes, high_second))));
+
+            return (static_cast<std::uint64_t>(high) << 32) | low;
+        }
+
+        inline ChunkCandidates select_chunk_candidates() noexcept
+        {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &chunk_candidates_avx2 : &chunk_candidates_sse2;
+        }
+
+        inline const ChunkCandidates chunk_candidates = select_chunk_candidates();
+#else
+        inline constexpr ChunkCandidates chunk_candidates = &chunk_candidates_scalar;
+#endif
+    } // namespace Detail
+
+    // search for one (non-empty) separator with the filter bytes chosen up front - shared by all the tokens of a split
+    class Searcher
+    {
+    public:
+        Searcher() = default;
+
+        explicit Searcher(std::string_view separator) noexcept
+            : separator_{separator}
+        {
+            if (!separator_.empty())
+            {
+                probe_ = Detail::probe_offset(separator_);
+                exact_ = separator_.size() <= 2; // both bytes are compared by the filter
+            }
+        }
+
+        std::string_view separator() const noexcept { return separator_; }
+
+        // bitmask of the positions chunk..chunk+63 where the separator may start (bit 0 - chunk)
+        std::uint64_t candidates(std::string_view text, std::size_t chunk) const noexcept
+        {
+            if (chunk + separator_.size() > text.size())
+                return 0;
+
+            const char* data = text.data();
+            const std::size_t starts = text.size() - separator_.size() + 1 - chunk;
+
+            if (starts >= Detail::chunk_size) // then the loads at chunk + probe stay inside of the text too
+                return Detail::chunk_candidates(data + chunk, separator_.front(), separator_[probe_], probe_);
+
+            std::uint64_t mask = 0;
+            for (std::size_t i = 0; i < starts; ++i)
+                mask |= static_cast<std::uint64_t>(data[chunk + i] == separator_.front() && data[chunk + i + probe_] == separator_[probe_]) << i;
+            return mask;
+        }
+
+        bool matches_at(std::string_view text, std::size_t pos) const noexcept
+        {
+            if (exact_)
+                return true;
+
+            if (separator_.size() > 16)
+                return std::memcmp(text.data() + pos, separator_.data(), separator_.size()) == 0;
+
+            for (std::size_t i = 1; i < separator_.size(); ++i) // inlined - a call to memcmp costs more for short separators
+            {
+                if (text[pos + i] != separator_[i])
+                    return false;
+            }
+            return true;
+        }
+
+        // position of the first occurrence of the separator at or after `from` (npos if there is none)
+        std::size_t find(std::string_view text, std::size_t from = 0) const noexcept
+        {
+            if (separator_.empty())
+                return from <= text.size() ? from : Detail::npos;
+
+            for (std::size_t chunk = from; chunk + separator_.size() <= text.size(); chunk += Detail::chunk_size)
+            {
+                for (std::uint64_t mask = candidates(text, chunk); mask; mask &= mask - 1)
+                {
+                    const std::size_t pos = chunk + std::countr_zero(mask);
+                    if (matches_at(text, pos))
+                        return pos;
+                }
+            }
+
+            return Detail::npos;
+        }
+
+    private:
+        std::string_view separator_;
+        std::size_t probe_ = 0;
+        bool exact_ = false;
+    };
+
+    inline std::size_t fast_find(std::string_view text, std::string_view separator, std::size_t from = 0) noexcept
+    {
+        return Searcher{separator}.find(text, from);
+    }
+
+    // lazy view of the tokens of `text` separated by `separator` - the same tokens as std::views::split
+    // (empty tokens between adjacent separators and after a trailing one, an empty separator splits into characters)
+    class FastSplitView : public std::ranges::view_interface<FastSplitView>
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag; // operator* returns a prvalue
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(const FastSplitView* parent, std::size_t token_begin) noexcept
+                : parent_{parent}
+                , token_begin_{token_begin}
+            {
+                if (token_begin_ != parent_->text_.size())
+                    find_token_end();
+            }
+
+            std::string_view operator*() const noexcept { return {parent_->text_.data() + token_begin_, token_end_ - token_begin_}; }
+
+            iterator& operator++() noexcept
+            {
+                const std::size_t text_size = parent_->text_.size();
+
+                if (token_end_ == text_size)
+                {
+                    token_begin_ = text_size;
+                    trailing_empty_ = false;
+                    return *this;
+                }
+
+                const std::size_t separator_size = parent_->searcher_.separator().size();
+                token_begin_ = token_end_ + separator_size;
+                if (token_begin_ == text_size)
+                {
+                    token_end_ = text_size;
+                    trailing_empty_ = separator_size != 0; // separator at the very end of the text
+                }
+                else
+                    find_token_end();
+
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                iterator prev = *this;
+                ++*this;
+                return prev;
+            }
+
+            bool operator==(const iterator& other) const noexcept
+            {
+                return token_begin_ == other.token_begin_ && trailing_empty_ == other.trailing_empty_;
+            }
+
+        private:
+            // the candidates left in the current chunk are reused - those before token_begin_ overlapped the last separator
+            void find_token_end() noexcept
+            {
+                const Searcher& searcher = parent_->searcher_;
+                const std::string_view text = parent_->text_;
+
+                if (searcher.separator().empty())
+                {
+                    token_end_ = token_begin_ + 1;
+                    return;
+                }
+
+                if (token_begin_ - chunk_ >= Detail::chunk_size)
+                {
+                    chunk_ = token_begin_;
+                    candidates_ = searcher.candidates(text, chunk_);
+                }
+                else
+                    candidates_ &= ~std::uint64_t{0} << (token_begin_ - chunk_);
+
+                for (;;)
+                {
+                    for (; candidates_; candidates_ &= candidates_ - 1)
+                    {
+                        const std::size_t pos = chunk_ + std::countr_zero(candidates_);
+                        if (searcher.matches_at(text, pos))
+                        {
+                            token_end_ = pos;
+                            return;
+                        }
+                    }
+
+                    chunk_ += Detail::chunk_size;
+                    if (chunk_ + searcher.separator().size() > text.size())
+                    {
+                        token_end_ = text.size();
+                        return;
+                    }
+                    candidates_ = searcher.candidates(text, chunk_);
+                }
+            }
+
+            const FastSplitView* parent_ = nullptr;
+            std::size_t token_begin_ = 0;
+            std::size_t token_end_ = 0;
+            std::size_t chunk_ = Detail::npos / 2; // far from any token - the first search loads a fresh chunk
+            std::uint64_t candidates_ = 0;
+            bool trailing_empty_ = false;
+        };
+
+        FastSplitView() = default;
+
+        FastSplitView(std::string_view text, std::string_view separator) noexcept
+            : text_{text}
+            , searcher_{separator}
+        { }
+
+        iterator begin() const noexcept { return iterator{this, 0}; }
+
+        iterator end() const noexcept { return iterator{this, text_.size()}; }
+
+    private:
+        std::string_view text_;
+        Searcher searcher_;
+    };
+
+    struct FastSplitAdaptor
+    {
+        std::string_view separator;
+
+        friend FastSplitView operator|(std::string_view text, FastSplitAdaptor adaptor) noexcept { return FastSplitView{text, adaptor.separator}; }
+    };
+
+    // fast_split(text, ", ") or text | fast_split(", ")
+    inline FastSplitView fast_split(std::string_view text, std::string_view separator) noexcept
+    {
+        return FastSplitView{text, separator};
+    }
+
+    inline FastSplitAdaptor fast_split(std::string_view separator) noexcept
+    {
+        return FastSplitAdaptor{separator};
+    }
+} // namespace Text
+
+#endif
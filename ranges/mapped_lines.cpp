@@ -0,0 +1,194 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random.hpp>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "mapped_lines.hpp"
+
+using namespace std::literals;
+
+namespace
+{
+    // file removed when the test is done
+    class TempFile
+    {
+    public:
+        TempFile(std::string_view name, std::string_view content)
+            : path_{std::filesystem::temp_directory_path() / name}
+        {
+            std::ofstream out{path_, std::ios::binary};
+            out << content;
+        }
+
+        TempFile(const TempFile&) = delete;
+        TempFile& operator=(const TempFile&) = delete;
+
+        ~TempFile() { std::filesystem::remove(path_); }
+
+        const std::filesystem::path& path() const { return path_; }
+
+    private:
+        std::filesystem::path path_;
+    };
+
+    std::vector<std::string_view> to_vector(auto&& lines)
+    {
+        std::vector<std::string_view> result;
+        for (std::string_view line : lines)
+            result.push_back(line);
+        return result;
+    }
+
+    std::pair<std::string_view, std::string_view> split_key_value(std::string_view line)
+    {
+        const std::size_t pos = line.find('/');
+        if (pos == std::string_view::npos)
+            return {line, ""};
+        return {line.substr(0, pos), line.substr(pos + 1)};
+    }
+
+    // the pipeline of the ranges exercise - the comments and blank lines may appear anywhere in a chunk
+    std::vector<std::string_view> parse_values(Text::Lines lines)
+    {
+        auto values = lines
+            | std::views::filter([](std::string_view line) { return !line.empty() && !line.starts_with('#'); })
+            | std::views::transform([](std::string_view line) { return split_key_value(line).second; });
+        return to_vector(values);
+    }
+
+    std::string create_config(std::size_t entries)
+    {
+        helpers::random::PCG rnd{42};
+
+        std::string text = "# generated config\n# key/value\n";
+        for (std::size_t i = 0; i < entries; ++i)
+        {
+            if (rnd() % 10 == 0)
+                text += "# comment " + std::to_string(i) + "\n\n";
+            text += "key_" + std::to_string(i) + "/value_" + std::to_string(rnd() % 1'000'000) + "\n";
+        }
+        return text;
+    }
+} // namespace
+
+TEST_CASE("lines")
+{
+    CHECK(to_vector(Text::lines("")).empty());
+    CHECK(to_vector(Text::lines("\n")) == std::vector{""sv});
+    CHECK(to_vector(Text::lines("a\n\nb")) == std::vector{"a"sv, ""sv, "b"sv});
+    CHECK(to_vector(Text::lines("a\r\nb\n")) == std::vector{"a\r"sv, "b"sv});
+
+    static_assert(std::ranges::forward_range<Text::Lines>);
+    static_assert(std::ranges::view<Text::MappedLines>);
+}
+
+TEST_CASE("mapped_lines")
+{
+    SECTION("lines of a file")
+    {
+        const TempFile file{"mapped_lines_test.txt", "# Comment 1\n# Comment 2\n\n1/one\n2/two\n\n3/three"};
+
+        auto values = Text::mapped_lines(file.path())
+            | std::views::drop_while([](std::string_view line) { return line.starts_with("#"); })
+            | std::views::filter([](std::string_view line) { return !line.empty(); })
+            | std::views::transform([](std::string_view line) { return split_key_value(line).second; });
+
+        CHECK(to_vector(values) == std::vector{"one"sv, "two"sv, "three"sv});
+    }
+
+    SECTION("empty file")
+    {
+        const TempFile file{"mapped_lines_empty.txt", ""};
+
+        CHECK(std::ranges::empty(Text::mapped_lines(file.path())));
+    }
+
+    SECTION("missing file")
+    {
+        CHECK_THROWS_AS(Text::mapped_lines(std::filesystem::temp_directory_path() / "no_such_file.txt"), std::system_error);
+    }
+}
+
+TEST_CASE("line_chunks")
+{
+    const std::string text = create_config(1'000);
+
+    for (std::size_t count : {1u, 2u, 3u, 8u, 100u})
+    {
+        const std::vector<std::string_view> chunks = Text::line_chunks(text, count);
+
+        CHECK(chunks.size() <= count);
+        CHECK(chunks.front().data() == text.data());
+
+        std::size_t total_size = 0;
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            if (i + 1 < chunks.size())
+                CHECK(chunks[i].ends_with('\n'));
+            total_size += chunks[i].size();
+        }
+        CHECK(total_size == text.size());
+    }
+
+    CHECK(Text::line_chunks("", 4).empty());
+    CHECK(Text::line_chunks("a\nb", 10) == std::vector{"a\n"sv, "b"sv});
+}
+
+TEST_CASE("parse_chunks - the same results in the same order as a sequential parse")
+{
+    const std::string text = create_config(10'000);
+    const std::vector<std::string_view> expected = parse_values(Text::lines(text));
+
+    for (std::size_t threads : {1u, 2u, 4u, 7u})
+        CHECK(Text::parse_chunks(text, parse_values, threads) == expected);
+
+    SECTION("exception thrown by a parse of a chunk")
+    {
+        auto faulty = [](Text::Lines lines) -> std::vector<int> {
+            if (lines.text().find("key_9999/") != std::string_view::npos)
+                throw std::runtime_error("parse error");
+            return {};
+        };
+
+        CHECK_THROWS_AS(Text::parse_chunks(text, faulty, 4), std::runtime_error);
+    }
+}
+
+TEST_CASE("mapped_lines - benchmarks", "[.][benchmark]")
+{
+    const TempFile file{"mapped_lines_benchmark.txt", create_config(4'000'000)}; // ~100 MB
+    const auto mapped = Text::mapped_lines(file.path());
+    const double size_in_gb = mapped.text().size() / 1e9;
+
+    auto measure = [&](std::string_view description, auto parse) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t result = parse();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << description << ": " << size_in_gb / elapsed.count() << " GB/s (" << result << ")\n";
+    };
+
+    measure("std::getline from std::ifstream", [&] {
+        std::ifstream in{file.path()};
+        std::size_t count = 0;
+        for (std::string line; std::getline(in, line);)
+            count += !line.empty() && !line.starts_with('#');
+        return count;
+    });
+
+    measure("mapped_lines - lines only", [&] { return static_cast<std::size_t>(std::ranges::distance(mapped)); });
+
+    measure("mapped_lines", [&] { return parse_values(Text::lines(mapped.text())).size(); });
+
+    for (std::size_t threads : {2u, 4u, 8u})
+        measure("parse_chunks - " + std::to_string(threads) + " threads", [&] { return Text::parse_chunks(mapped.text(), parse_values, threads).size(); });
+}
@@ -0,0 +1,341 @@
+#ifndef MAPPED_LINES_HPP
+#define MAPPED_LINES_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_LINES_POSIX 1
+#else
+#include <fstream>
+#endif
+
+#include "fast_split.hpp"
+
+// Line-oriented reading of big files without copying:
+//  * mapped_lines(path)                    - view of the lines of a memory-mapped file
+//  * lines(text)                           - the same for text already in memory
+//  * parse_chunks(text, parse_chunk, n)    - text split at line boundaries into n chunks parsed on n threads,
+//                                            the results concatenated in the order of the text
+// A line is a std::string_view without its '\n' (a '\r' before it is kept); a newline at the end of the text
+// terminates the last line instead of starting an empty one.
+namespace Text
+{
+    // read-only mapping of a whole file (the contents read into memory where mmap is not available)
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::filesystem::path& path)
+        {
+#ifdef MAPPED_LINES_POSIX
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd == -1)
+                throw std::system_error(errno, std::generic_category(), "cannot open " + path.string());
+
+            struct stat info{};
+            if (::fstat(fd, &info) == -1)
+            {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "cannot stat " + path.string());
+            }
+
+            size_ = static_cast<std::size_t>(info.st_size);
+            if (size_ > 0) // an empty file cannot be mapped
+            {
+                void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED)
+                {
+                    const int error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "cannot map " + path.string());
+                }
+                data_ = static_cast<const char*>(data);
+                ::madvise(data, size_, MADV_SEQUENTIAL); // only a hint for the read-ahead - a failure is harmless
+            }
+            ::close(fd); // the mapping keeps the file alive
+#else
+            std::ifstream in{path, std::ios::binary};
+            if (!in)
+                throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "cannot open " + path.string());
+            buffer_.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+            : data_{std::exchange(other.data_, nullptr)}
+            , size_{std::exchange(other.size_, 0)}
+#ifndef MAPPED_LINES_POSIX
+            , buffer_{std::move(other.buffer_)}
+#endif
+        { }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other)
+            {
+                unmap();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+#ifndef MAPPED_LINES_POSIX
+                buffer_ = std::move(other.buffer_);
+#endif
+            }
+            return *this;
+        }
+
+        ~MappedFile() { unmap(); }
+
+        std::string_view text() const noexcept { return {data_, size_}; }
+
+        std::size_t size() const noexcept { return size_; }
+
+    private:
+        void unmap() noexcept
+        {
+#ifdef MAPPED_LINES_POSIX
+            if (data_)
+                ::munmap(const_cast<char*>(data_), size_);
+#endif
+        }
+
+        const char* data_ = nullptr;
+        std::size_t size_ = 0;
+#ifndef MAPPED_LINES_POSIX
+        std::vector<char> buffer_;
+#endif
+    };
+
+    namespace Detail
+    {
+        inline const Searcher newline_searcher{"\n"};
+    }
+
+    // lines of a text that outlives the view
+    class Lines : public std::ranges::view_interface<Lines>
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag; // operator* returns a prvalue
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(std::string_view text, std::size_t line) noexcept
+                : text_{text}
+                , line_{line}
+            {
+                if (line_ != text_.size())
+                    find_line_end();
+            }
+
+            std::string_view operator*() const noexcept { return {text_.data() + line_, line_end_ - line_}; }
+
+            iterator& operator++() noexcept
+            {
+                line_ = line_end_ == text_.size() ? line_end_ : line_end_ + 1;
+                if (line_ != text_.size())
+                    find_line_end();
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                iterator prev = *this;
+                ++*this;
+                return prev;
+            }
+
+            bool operator==(const iterator& other) const noexcept { return line_ == other.line_; }
+
+        private:
+            // a bitmask of the newlines in 64 bytes is kept between lines (like in FastSplitView)
+            void find_line_end() noexcept
+            {
+                if (line_ - chunk_ >= Detail::chunk_size)
+                {
+                    chunk_ = line_;
+                    newlines_ = Detail::newline_searcher.candidates(text_, chunk_);
+                }
+                else
+                    newlines_ &= ~std::uint64_t{0} << (line_ - chunk_);
+
+                while (newlines_ == 0)
+                {
+                    chunk_ += Detail::chunk_size;
+                    if (chunk_ >= text_.size())
+                    {
+                        line_end_ = text_.size();
+                        return;
+                    }
+                    newlines_ = Detail::newline_searcher.candidates(text_, chunk_);
+                }
+
+                line_end_ = chunk_ + std::countr_zero(newlines_);
+            }
+
+            std::string_view text_;
+            std::size_t line_ = 0;
+            std::size_t line_end_ = 0;
+            std::size_t chunk_ = Detail::npos / 2;
+            std::uint64_t newlines_ = 0;
+        };
+
+        Lines() = default;
+
+        explicit Lines(std::string_view text) noexcept
+            : text_{text}
+        { }
+
+        iterator begin() const noexcept { return iterator{text_, 0}; }
+
+        iterator end() const noexcept { return iterator{text_, text_.size()}; }
+
+        std::string_view text() const noexcept { return text_; }
+
+    private:
+        std::string_view text_;
+    };
+
+    inline Lines lines(std::string_view text) noexcept
+    {
+        return Lines{text};
+    }
+
+    // view owning the mapping of a file - the lines are valid as long as the view
+    class MappedLines : public std::ranges::view_interface<MappedLines>
+    {
+    public:
+        explicit MappedLines(const std::filesystem::path& path)
+            : file_{path}
+        { }
+
+        Lines::iterator begin() const noexcept { return Lines{file_.text()}.begin(); }
+
+        Lines::iterator end() const noexcept { return Lines{file_.text()}.end(); }
+
+        std::string_view text() const noexcept { return file_.text(); }
+
+    private:
+        MappedFile file_;
+    };
+
+    inline MappedLines mapped_lines(const std::filesystem::path& path)
+    {
+        return MappedLines{path};
+    }
+
+    // up to `count` non-empty pieces of the text, each of them ending just after a newline (except the last one)
+    inline std::vector<std::string_view> line_chunks(std::string_view text, std::size_t count)
+    {
+        std::vector<std::string_view> chunks;
+        const std::size_t approx_size = text.size() / std::max<std::size_t>(count, 1) + 1;
+
+        while (!text.empty())
+        {
+            std::size_t end = text.find('\n', std::min(approx_size, text.size()) - 1);
+            end = end == std::string_view::npos ? text.size() : end + 1;
+
+            chunks.push_back(text.substr(0, end));
+            text.remove_prefix(end);
+        }
+
+        return chunks;
+    }
+
+    namespace Detail
+    {
+        // task(i) for every i in [0, count), each on its own thread (task(0) on the calling one);
+        // the first exception (in the order of i) is rethrown when all of them are done
+        template <typename TTask>
+        void run_parallel(std::size_t count, TTask& task)
+        {
+            std::vector<std::exception_ptr> errors(count);
+
+            auto run = [&](std::size_t i) {
+                try
+                {
+                    task(i);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            };
+
+            {
+                std::vector<std::jthread> threads;
+                threads.reserve(count);
+                for (std::size_t i = 1; i < count; ++i)
+                    threads.emplace_back(run, i);
+
+                if (count > 0)
+                    run(0);
+            }
+
+            for (const std::exception_ptr& error : errors)
+            {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        }
+    } // namespace Detail
+
+    // parse_chunk(Lines) -> a container of results; each chunk is parsed on its own thread
+    // (the chunk may start anywhere in the text - a parse must not depend on the lines before it)
+    template <typename TParseChunk>
+        requires std::ranges::sized_range<std::invoke_result_t<TParseChunk&, Lines>>
+    auto parse_chunks(std::string_view text, TParseChunk parse_chunk, std::size_t threads_count = std::max(1u, std::thread::hardware_concurrency()))
+    {
+        using Result = std::invoke_result_t<TParseChunk&, Lines>;
+        using Value = std::ranges::range_value_t<Result>;
+
+        const std::vector<std::string_view> chunks = line_chunks(text, threads_count);
+        std::vector<Result> results(chunks.size());
+
+        auto parse = [&](std::size_t i) { results[i] = std::invoke(parse_chunk, Lines{chunks[i]}); };
+        Detail::run_parallel(chunks.size(), parse);
+
+        std::size_t total_size = 0;
+        for (const Result& result : results)
+            total_size += std::ranges::size(result);
+
+        std::vector<Value> merged;
+        merged.reserve(total_size);
+        for (Result& result : results)
+            std::ranges::move(result, std::back_inserter(merged));
+
+        return merged;
+    }
+} // namespace Text
+
+#endif
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <array>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <forward_list>
+#include <functional>
+#include <random.hpp>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "merge_view.hpp"
+
+using namespace std::literals;
+
+namespace
+{
+    template <std::ranges::input_range R>
+    auto to_vector(R&& rng)
+    {
+        std::vector<std::ranges::range_value_t<R>> result;
+        for (auto&& item : rng)
+            result.push_back(item);
+        return result;
+    }
+
+    std::vector<std::vector<int>> create_shards(std::size_t count, std::size_t size, std::uint32_t seed)
+    {
+        helpers::random::PCG rnd{seed};
+        std::vector<std::vector<int>> shards(count);
+        for (auto& shard : shards)
+        {
+            shard.resize(rnd() % (2 * size + 1));
+            for (int& item : shard)
+                item = static_cast<int>(rnd() % (4 * size));
+            std::ranges::sort(shard);
+        }
+        return shards;
+    }
+
+    std::vector<int> merged_by_sort(const std::vector<std::vector<int>>& shards)
+    {
+        std::vector<int> result;
+        for (const auto& shard : shards)
+            result.insert(result.end(), shard.begin(), shard.end());
+        std::ranges::sort(result);
+        return result;
+    }
+
+    template <std::size_t... Is>
+    auto merge_shards(const std::vector<std::vector<int>>& shards, std::index_sequence<Is...>)
+    {
+        return Views::merge(shards[Is]...);
+    }
+
+    template <std::size_t... Is>
+    auto merge_unique_shards(const std::vector<std::vector<int>>& shards, std::index_sequence<Is...>)
+    {
+        return Views::merge_unique(shards[Is]...);
+    }
+
+    constexpr int sum_of_unique()
+    {
+        const std::array lst1 = {1, 2, 3, 4, 5};
+        const std::array lst2 = {5, 6, 7, 8, 9};
+        const std::array lst3 = {0, 5, 9};
+
+        int sum = 0;
+        for (int x : Views::merge_unique(lst1, lst2, lst3))
+            sum += x;
+        return sum;
+    }
+} // namespace
+
+TEST_CASE("merge - sorted ranges in one sorted sequence")
+{
+    const std::vector<int> evens = {0, 2, 4, 6, 8};
+    const std::vector<int> odds = {1, 3, 5};
+    const std::vector<int> empty;
+
+    SECTION("two ranges")
+    {
+        auto merged = Views::merge(evens, odds);
+
+        static_assert(std::ranges::forward_range<decltype(merged)>);
+        static_assert(std::ranges::sized_range<decltype(merged)>);
+        CHECK(merged.size() == 8);
+        CHECK(to_vector(merged) == std::vector{0, 1, 2, 3, 4, 5, 6, 8});
+    }
+
+    SECTION("empty & single sources")
+    {
+        CHECK(to_vector(Views::merge(empty, odds, empty)) == odds);
+        CHECK(to_vector(Views::merge(evens)) == evens);
+        CHECK(Views::merge(empty, empty).empty());
+    }
+
+    SECTION("sources of different types")
+    {
+        const std::forward_list<long> longs = {-1, 3, 10};
+        auto merged = Views::merge(evens, longs, std::views::iota(4, 7));
+
+        static_assert(std::same_as<std::ranges::range_value_t<decltype(merged)>, long>);
+        static_assert(!std::ranges::sized_range<decltype(merged)>);
+        CHECK(to_vector(merged) == std::vector<long>{-1, 0, 2, 3, 4, 4, 5, 6, 6, 8, 10});
+    }
+
+    SECTION("the merge is stable")
+    {
+        using Item = std::pair<int, char>;
+        const std::vector<Item> first = {{1, 'a'}, {2, 'a'}, {2, 'b'}};
+        const std::vector<Item> second = {{1, 'c'}, {2, 'c'}};
+        const std::vector<Item> third = {{0, 'd'}, {2, 'd'}};
+        auto by_key = [](const Item& lhs, const Item& rhs) { return lhs.first < rhs.first; };
+
+        std::vector<Item> expected;
+        std::ranges::merge(first, second, std::back_inserter(expected), by_key);
+        std::vector<Item> all;
+        std::ranges::merge(expected, third, std::back_inserter(all), by_key);
+
+        CHECK(to_vector(Views::merge(by_key, first, second, third)) == all);
+    }
+
+    SECTION("comparator & the elements as lvalues of the sources")
+    {
+        std::vector<std::string> words1 = {"gamma", "beta"};
+        std::vector<std::string> words2 = {"delta", "alpha"};
+
+        auto merged = Views::merge(std::ranges::greater{}, words1, words2);
+        CHECK(to_vector(merged) == std::vector<std::string>{"gamma", "delta", "beta", "alpha"});
+        CHECK(&*merged.begin() == &words1[0]);
+
+        for (std::string& word : merged)
+            word += "!";
+        CHECK(words2[1] == "alpha!");
+    }
+
+    SECTION("multipass")
+    {
+        const auto merged = Views::merge(evens, odds);
+        auto it = std::ranges::next(merged.begin(), 3);
+        auto copy = it;
+        CHECK(*++it == 4);
+        CHECK(*copy == 3);
+        CHECK(std::ranges::distance(merged) == 8);
+    }
+}
+
+TEST_CASE("merge_unique - each value once")
+{
+    const std::vector<int> first = {1, 1, 2, 5, 7};
+    const std::vector<int> second = {1, 2, 2, 3, 7, 9};
+
+    auto merged = Views::merge_unique(first, second);
+    static_assert(!std::ranges::sized_range<decltype(merged)>);
+    CHECK(to_vector(merged) == std::vector{1, 2, 3, 5, 7, 9});
+
+    CHECK(to_vector(Views::merge_unique(std::vector{4, 4, 4})) == std::vector{4});
+    CHECK(to_vector(Views::merge_unique(std::ranges::greater{}, std::vector{9, 3}, std::vector{9, 5, 3})) == std::vector{9, 5, 3});
+    CHECK(to_vector(Views::merge_unique(std::views::iota(0, 5) | std::views::transform([](int x) { return x / 2; }))) == std::vector{0, 1, 2});
+}
+
+TEST_CASE("merge - constexpr")
+{
+    static_assert(sum_of_unique() == 45);
+
+    constexpr std::array lst1 = {1, 3, 5};
+    constexpr std::array lst2 = {2, 3, 4};
+    static_assert(std::ranges::equal(Views::merge(lst1, lst2), std::array{1, 2, 3, 3, 4, 5}));
+}
+
+TEST_CASE("merge - many shards as with sort")
+{
+    for (std::uint32_t seed : {1, 2, 3, 4, 5})
+    {
+        const auto shards = create_shards(13, 50, seed);
+        const std::vector<int> expected = merged_by_sort(shards);
+
+        CHECK(to_vector(merge_shards(shards, std::make_index_sequence<13>{})) == expected);
+        CHECK(to_vector(merge_shards(shards, std::make_index_sequence<5>{})) == merged_by_sort({shards.begin(), shards.begin() + 5}));
+
+        std::vector<int> unique = expected;
+        unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+        CHECK(to_vector(merge_unique_shards(shards, std::make_index_sequence<13>{})) == unique);
+    }
+}
+
+TEST_CASE("merge - benchmarks", "[.][benchmark]")
+{
+    const auto shards = create_shards(16, 100'000, 42);
+
+    BENCHMARK("16 shards - copy & std::ranges::sort")
+    {
+        return merged_by_sort(shards).size();
+    };
+
+    BENCHMARK("16 shards - Views::merge")
+    {
+        long long sum = 0;
+        for (int x : merge_shards(shards, std::make_index_sequence<16>{}))
+            sum += x;
+        return sum;
+    };
+
+    BENCHMARK("16 shards - copy, sort & unique")
+    {
+        std::vector<int> merged = merged_by_sort(shards);
+        return std::unique(merged.begin(), merged.end()) - merged.begin();
+    };
+
+    BENCHMARK("16 shards - Views::merge_unique")
+    {
+        std::ptrdiff_t count = 0;
+        for ([[maybe_unused]] int x : merge_unique_shards(shards, std::make_index_sequence<16>{}))
+            ++count;
+        return count;
+    };
+}
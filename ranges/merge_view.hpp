@@ -0,0 +1,287 @@
+#ifndef MERGE_VIEW_HPP
+#define MERGE_VIEW_HPP
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Views::merge(r1, r2, ...) - the elements of sorted ranges in one sorted sequence, computed lazily:
+//
+//   for (int x : Views::merge(shard1, shard2, shard3))        // 1 1 2 3 3 ...
+//   for (int x : Views::merge_unique(shard1, shard2, shard3)) // 1 2 3 ...
+//   auto descending = Views::merge(std::ranges::greater{}, r1, r2);
+//
+// The sources are the leaves of a tournament (loser) tree kept in the iterator: the next element is found
+// with log(k) comparisons - n elements of k ranges cost O(n log k), nothing is copied or buffered.
+// The merge is stable (equal elements come in the order of the sources, as with std::merge); merge_unique
+// skips the elements equal to the previous one (as std::unique of the merged sequence).
+// The sources must be forward ranges; all the operations are constexpr.
+namespace Views
+{
+    namespace Detail
+    {
+        template <typename... Vs>
+        concept Mergeable = sizeof...(Vs) > 0
+            && ((std::ranges::view<Vs> && std::ranges::forward_range<Vs>) && ...)
+            && requires {
+                   typename std::common_reference_t<std::ranges::range_reference_t<Vs>...>;
+                   typename std::common_type_t<std::ranges::range_value_t<Vs>...>;
+               };
+
+        // the sources of one type are held in an array & indexed at run time, the others in a tuple
+        template <typename T, typename... Ts>
+        struct SourceStorageFor
+        {
+            using type = std::conditional_t<(std::same_as<T, Ts> && ...), std::array<T, 1 + sizeof...(Ts)>, std::tuple<T, Ts...>>;
+        };
+
+        template <typename... Ts>
+        using SourceStorage = typename SourceStorageFor<Ts...>::type;
+
+        template <typename TStorage>
+        inline constexpr bool indexable = requires(TStorage& storage) { storage[0]; };
+
+        // f(index) for an array, f(std::integral_constant<index>) for a tuple
+        template <typename TStorage, std::size_t I = 0, typename F>
+        constexpr decltype(auto) with_source(std::size_t index, F&& f)
+        {
+            if constexpr (indexable<TStorage>)
+                return f(index);
+            else if constexpr (I + 1 == std::tuple_size_v<TStorage>)
+                return f(std::integral_constant<std::size_t, I>{});
+            else
+            {
+                if (index == I)
+                    return f(std::integral_constant<std::size_t, I>{});
+                return with_source<TStorage, I + 1>(index, std::forward<F>(f));
+            }
+        }
+
+        template <typename TStorage, typename TIndex>
+        constexpr decltype(auto) source(TStorage& storage, TIndex index)
+        {
+            if constexpr (std::same_as<TIndex, std::size_t>)
+                return storage[index];
+            else
+                return std::get<TIndex::value>(storage);
+        }
+    } // namespace Detail
+
+    template <bool Unique, typename TLess, typename... Vs>
+        requires Detail::Mergeable<Vs...>
+            && (std::indirect_strict_weak_order<TLess, std::ranges::iterator_t<Vs>, std::ranges::iterator_t<Vs>> && ...)
+    class MergeView : public std::ranges::view_interface<MergeView<Unique, TLess, Vs...>>
+    {
+        static constexpr std::size_t N = sizeof...(Vs);
+
+        using Bases = Detail::SourceStorage<Vs...>;
+
+        template <bool Const>
+        class Iterator
+        {
+            using Parent = std::conditional_t<Const, const MergeView, MergeView>;
+
+            template <typename V>
+            using MaybeConst = std::conditional_t<Const, const V, V>;
+
+            // indexed as the sources
+            using Iterators = std::conditional_t<Detail::indexable<Bases>, std::array<std::ranges::iterator_t<MaybeConst<std::tuple_element_t<0, std::tuple<Vs...>>>>, N>,
+                std::tuple<std::ranges::iterator_t<MaybeConst<Vs>>...>>;
+
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::common_type_t<std::ranges::range_value_t<MaybeConst<Vs>>...>;
+            using reference = std::common_reference_t<std::ranges::range_reference_t<MaybeConst<Vs>>...>;
+            using difference_type = std::common_type_t<std::ranges::range_difference_t<MaybeConst<Vs>>...>;
+
+            Iterator() = default;
+
+            constexpr explicit Iterator(Parent& parent)
+                : parent_{&parent}
+                , current_{[&parent]<std::size_t... Is>(std::index_sequence<Is...>) {
+                    return Iterators{std::ranges::begin(std::get<Is>(parent.bases_))...};
+                }(std::make_index_sequence<N>{})}
+            {
+                for (std::size_t i = 0; i < N; ++i)
+                    exhausted_[i] = at_end(i);
+                build();
+            }
+
+            constexpr reference operator*() const { return head(nodes_[0]); }
+
+            constexpr Iterator& operator++()
+            {
+                if constexpr (Unique)
+                {
+                    // the element stays valid after ++ - the sources are forward ranges;
+                    // the next one is not less than it - an equal one is not greater
+                    reference previous = head(nodes_[0]);
+                    do
+                    {
+                        next();
+                    } while (!exhausted_[nodes_[0]] && !std::invoke(parent_->less_, previous, head(nodes_[0])));
+                }
+                else
+                    next();
+
+                return *this;
+            }
+
+            constexpr Iterator operator++(int)
+            {
+                Iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            friend constexpr bool operator==(const Iterator& it, std::default_sentinel_t) { return it.exhausted_[it.nodes_[0]]; }
+
+            friend constexpr bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.current_ == rhs.current_; }
+
+        private:
+            template <typename F>
+            constexpr decltype(auto) with_source(std::size_t index, F&& f) const
+            {
+                return Detail::with_source<Iterators>(index, std::forward<F>(f));
+            }
+
+            constexpr reference head(std::size_t index) const
+            {
+                return with_source(index, [this](auto i) -> reference { return *Detail::source(current_, i); });
+            }
+
+            constexpr bool at_end(std::size_t index) const
+            {
+                return with_source(index, [this](auto i) { return Detail::source(current_, i) == std::ranges::end(Detail::source(parent_->bases_, i)); });
+            }
+
+            // the element of source a goes before the one of source b - an exhausted source loses,
+            // equal elements are taken from the sources in order
+            constexpr bool before(std::size_t a, std::size_t b) const
+            {
+                if (exhausted_[a])
+                    return false;
+                if (exhausted_[b])
+                    return true;
+                return a < b ? !std::invoke(parent_->less_, head(b), head(a)) : std::invoke(parent_->less_, head(a), head(b));
+            }
+
+            // nodes_[0] - the winner, nodes_[1..N) - the losers of the matches; the sources are the leaves [N, 2N)
+            constexpr void build()
+            {
+                std::array<std::size_t, 2 * N> winners{};
+                for (std::size_t i = 0; i < N; ++i)
+                    winners[N + i] = i;
+
+                for (std::size_t node = N - 1; node > 0; --node)
+                {
+                    const std::size_t left = winners[2 * node];
+                    const std::size_t right = winners[2 * node + 1];
+                    const bool right_wins = before(right, left);
+                    winners[node] = right_wins ? right : left;
+                    nodes_[node] = right_wins ? left : right;
+                }
+
+                nodes_[0] = N > 1 ? winners[1] : 0;
+            }
+
+            // the winner moves to its next element & the matches on the path to the root are replayed
+            constexpr void next()
+            {
+                std::size_t winner = nodes_[0];
+                with_source(winner, [this](auto i) { ++Detail::source(current_, i); });
+                exhausted_[winner] = at_end(winner);
+
+                if constexpr (N > 1)
+                {
+                    for (std::size_t node = (winner + N) / 2; node > 0; node /= 2)
+                    {
+                        if (before(nodes_[node], winner))
+                            std::swap(nodes_[node], winner);
+                    }
+                    nodes_[0] = winner;
+                }
+            }
+
+            Parent* parent_ = nullptr;
+            Iterators current_{};
+            std::array<std::size_t, N> nodes_{};
+            std::array<bool, N> exhausted_{};
+        };
+
+    public:
+        MergeView() requires std::default_initializable<TLess> && (std::default_initializable<Vs> && ...) = default;
+
+        constexpr explicit MergeView(TLess less, Vs... bases)
+            : bases_{std::move(bases)...}
+            , less_{std::move(less)}
+        { }
+
+        constexpr Iterator<false> begin() { return Iterator<false>{*this}; }
+
+        constexpr Iterator<true> begin() const
+            requires(std::ranges::forward_range<const Vs> && ...)
+            && (std::indirect_strict_weak_order<const TLess, std::ranges::iterator_t<const Vs>, std::ranges::iterator_t<const Vs>> && ...)
+        {
+            return Iterator<true>{*this};
+        }
+
+        constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+        constexpr auto size() requires(!Unique && (std::ranges::sized_range<Vs> && ...))
+        {
+            return std::apply([](auto&... bases) { return (std::ranges::size(bases) + ...); }, as_tuple(bases_));
+        }
+
+        constexpr auto size() const requires(!Unique && (std::ranges::sized_range<const Vs> && ...))
+        {
+            return std::apply([](auto&... bases) { return (std::ranges::size(bases) + ...); }, as_tuple(bases_));
+        }
+
+    private:
+        template <typename TBases>
+        static constexpr auto as_tuple(TBases& bases)
+        {
+            return [&bases]<std::size_t... Is>(std::index_sequence<Is...>) {
+                return std::tie(std::get<Is>(bases)...);
+            }(std::make_index_sequence<N>{});
+        }
+
+        Bases bases_;
+        [[no_unique_address]] TLess less_;
+    };
+
+    namespace Detail
+    {
+        template <bool Unique>
+        struct MergeFn
+        {
+            template <std::ranges::viewable_range... Rs>
+                requires(sizeof...(Rs) > 0) && Mergeable<std::views::all_t<Rs>...>
+            constexpr auto operator()(Rs&&... rngs) const
+            {
+                return (*this)(std::ranges::less{}, std::forward<Rs>(rngs)...);
+            }
+
+            template <typename TLess, std::ranges::viewable_range... Rs>
+                requires(!std::ranges::range<TLess>) && Mergeable<std::views::all_t<Rs>...>
+            constexpr auto operator()(TLess less, Rs&&... rngs) const
+            {
+                return MergeView<Unique, TLess, std::views::all_t<Rs>...>{std::move(less), std::views::all(std::forward<Rs>(rngs))...};
+            }
+        };
+    } // namespace Detail
+
+    inline constexpr Detail::MergeFn<false> merge{};
+
+    inline constexpr Detail::MergeFn<true> merge_unique{};
+} // namespace Views
+
+#endif
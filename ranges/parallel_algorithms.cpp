@@ -0,0 +1,292 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <random.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parallel_algorithms.hpp"
+
+namespace
+{
+    constexpr int large_size = 1'000'000; // enough for many chunks
+
+    std::vector<int> random_numbers(std::size_t size, std::uint64_t seed = 42)
+    {
+        helpers::random::PCG rnd{seed};
+        std::vector<int> numbers(size);
+        for (int& n : numbers)
+            n = static_cast<int>(rnd() % 2'000'001) - 1'000'000;
+        return numbers;
+    }
+
+    template <typename T, typename TBinaryOp>
+    constexpr bool reducible = requires(const std::vector<int>& numbers, T init, TBinaryOp op) { par::reduce(numbers, init, op); };
+
+    struct Person
+    {
+        std::string name;
+        int age;
+    };
+
+    template <typename TFunction>
+    double measure(TFunction function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+} // namespace
+
+TEST_CASE("thread pool - task group")
+{
+    par::TaskGroup group;
+    std::atomic<int> counter = 0;
+
+    for (int i = 0; i < 1'000; ++i)
+        group.run([&] { ++counter; });
+    group.wait();
+
+    CHECK(counter == 1'000);
+
+    SECTION("exception is rethrown by wait")
+    {
+        par::TaskGroup faulty_group;
+        faulty_group.run([] { throw std::runtime_error("task failed"); });
+        faulty_group.run([&] { ++counter; });
+
+        CHECK_THROWS_AS(faulty_group.wait(), std::runtime_error);
+        CHECK(counter == 1'001);
+    }
+}
+
+TEST_CASE("par::sort")
+{
+    SECTION("the same result as std::ranges::sort")
+    {
+        for (std::size_t size : {0u, 1u, 1'000u, 100'003u, 1'000'000u})
+        {
+            std::vector<int> numbers = random_numbers(size);
+            std::vector<int> expected = numbers;
+            std::ranges::sort(expected);
+
+            CHECK(par::sort(numbers) == numbers.end());
+            CHECK(numbers == expected);
+        }
+    }
+
+    SECTION("comparator & projection")
+    {
+        std::vector<Person> people;
+        helpers::random::PCG rnd{7};
+        for (int i = 0; i < large_size / 10; ++i)
+            people.push_back({"person-" + std::to_string(i), static_cast<int>(rnd() % 100)});
+
+        par::sort(people, std::greater{}, &Person::age);
+
+        CHECK(std::ranges::is_sorted(people, std::greater{}, &Person::age));
+    }
+
+    SECTION("iterator & sentinel")
+    {
+        std::vector<int> numbers = random_numbers(large_size);
+        const std::vector<int> tail(numbers.begin() + large_size / 2, numbers.end());
+
+        par::sort(std::counted_iterator{numbers.begin(), large_size / 2}, std::default_sentinel);
+
+        CHECK(std::ranges::is_sorted(numbers.begin(), numbers.begin() + large_size / 2));
+        CHECK(std::ranges::equal(numbers.begin() + large_size / 2, numbers.end(), tail.begin(), tail.end()));
+    }
+}
+
+TEST_CASE("par::stable_sort")
+{
+    SECTION("the same result as std::ranges::stable_sort")
+    {
+        std::vector<Person> people;
+        helpers::random::PCG rnd{11};
+        for (int i = 0; i < large_size / 5; ++i)
+            people.push_back({"person-" + std::to_string(i), static_cast<int>(rnd() % 100)});
+
+        std::vector<Person> expected = people;
+        std::ranges::stable_sort(expected, std::greater{}, &Person::age);
+
+        CHECK(par::stable_sort(people, std::greater{}, &Person::age) == people.end());
+        CHECK(std::ranges::equal(people, expected, {}, &Person::name, &Person::name));
+    }
+
+    SECTION("small inputs are sorted serially")
+    {
+        std::vector<int> numbers = random_numbers(1'000);
+        par::stable_sort(numbers);
+        CHECK(std::ranges::is_sorted(numbers));
+    }
+}
+
+TEST_CASE("par::transform, for_each, count_if")
+{
+    const std::vector<int> numbers = random_numbers(large_size);
+
+    std::vector<long long> squares(numbers.size());
+    const auto [in, out] = par::transform(numbers, squares.begin(), [](long long n) { return n * n; });
+    CHECK(in == numbers.end());
+    CHECK(out == squares.end());
+    CHECK(squares[12'345] == 1LL * numbers[12'345] * numbers[12'345]);
+
+    std::vector<Person> people(large_size, Person{"", 0});
+    par::for_each(people, [](int& age) { ++age; }, &Person::age);
+    CHECK(std::ranges::all_of(people, [](const Person& p) { return p.age == 1; }));
+
+    CHECK(par::count_if(numbers, [](int n) { return n % 3 == 0; }) == std::ranges::count_if(numbers, [](int n) { return n % 3 == 0; }));
+    CHECK(par::count_if(people, [](int age) { return age == 1; }, &Person::age) == large_size);
+}
+
+TEST_CASE("par::copy_if")
+{
+    const std::vector<int> numbers = random_numbers(large_size);
+
+    std::vector<int> expected;
+    std::ranges::copy_if(numbers, std::back_inserter(expected), [](int n) { return n > 0; });
+
+    SECTION("random-access output - in parallel, order preserved")
+    {
+        std::vector<int> positive(numbers.size());
+        const auto [in, out] = par::copy_if(numbers, positive.begin(), [](int n) { return n > 0; });
+        positive.erase(out, positive.end());
+
+        CHECK(in == numbers.end());
+        CHECK(positive == expected);
+    }
+
+    SECTION("back_inserter - serial")
+    {
+        std::vector<int> positive;
+        par::copy_if(numbers, std::back_inserter(positive), [](int n) { return n > 0; });
+
+        CHECK(positive == expected);
+    }
+}
+
+TEST_CASE("par::reduce")
+{
+    const std::vector<int> numbers = random_numbers(large_size);
+
+    CHECK(par::reduce(numbers, 0LL) == std::accumulate(numbers.begin(), numbers.end(), 0LL));
+    CHECK(par::reduce(numbers, 0LL, std::plus{}, [](int n) { return 1LL * n * n; })
+        == std::transform_reduce(numbers.begin(), numbers.end(), 0LL, std::plus{}, [](int n) { return 1LL * n * n; }));
+
+    // op must accept two partial results
+    auto append = [](std::string text, int n) { return text + std::to_string(n); };
+    static_assert(!reducible<std::string, decltype(append)>);
+    static_assert(reducible<long long, std::plus<>>);
+
+    // concatenation is associative but not commutative - the chunks are combined in order
+    std::vector<std::string> digits(100'000);
+    for (std::size_t i = 0; i < digits.size(); ++i)
+        digits[i] = std::to_string(i % 10);
+
+    const std::string concatenated = par::reduce(digits, std::string{">"});
+    CHECK(concatenated == std::accumulate(digits.begin(), digits.end(), std::string{">"}));
+}
+
+TEST_CASE("par::fold - an accumulator of another meaning than the elements")
+{
+    // chunked - the counts of the chunks are added, not folded as elements
+    const std::vector<int> threes(1'000'000, 3);
+    auto count_odd = [](long long count, int n) { return count + (n & 1); };
+    CHECK(par::fold(threes, 0LL, count_odd) == std::accumulate(threes.begin(), threes.end(), 0LL, count_odd));
+
+    const std::vector<int> numbers = random_numbers(large_size);
+    auto count_even = [](long long count, int n) { return count + (n % 2 == 0); };
+    CHECK(par::fold(numbers, 5LL, count_even) == std::accumulate(numbers.begin(), numbers.end(), 5LL, count_even));
+
+    // the longest word - combined with max
+    std::vector<std::string> words(100'000);
+    for (std::size_t i = 0; i < words.size(); ++i)
+        words[i] = std::string(i * 7919 % 1000, 'x');
+    auto longest = [](std::size_t length, const std::string& word) { return std::max(length, word.size()); };
+    CHECK(par::fold(words, std::size_t{0}, longest, [](std::size_t a, std::size_t b) { return std::max(a, b); }) == 999);
+}
+
+TEST_CASE("par - exceptions and nested calls")
+{
+    const std::vector<int> numbers = random_numbers(large_size);
+    const int max = *std::ranges::max_element(numbers);
+
+    CHECK_THROWS_AS(par::for_each(numbers, [max](int n) { if (n == max) throw std::out_of_range("max"); }), std::out_of_range);
+
+    // a par:: call inside of a chunk - the waiting threads run the inner tasks, so there is no deadlock
+    constexpr int rows_count = 8;
+    constexpr int row_step = par::Detail::min_chunk_size;
+    std::vector<std::vector<int>> rows(rows_count, random_numbers(50'000));
+    par::for_each(std::views::iota(0, rows_count * row_step), [&](int i) {
+        if (i % row_step == 0)
+            par::sort(rows[i / row_step]);
+    });
+    CHECK(std::ranges::all_of(rows, [](const auto& row) { return std::ranges::is_sorted(row); }));
+}
+
+TEST_CASE("par - benchmarks", "[.][benchmark]")
+{
+    constexpr std::size_t size = 100'000'000;
+    std::cout << "par:: speed-up for " << size << " elements on " << par::ThreadPool::global().size() << " worker threads:\n";
+
+    auto report = [](std::string_view name, double serial, double parallel) {
+        std::cout << "  " << name << ": " << serial << " s -> " << parallel << " s (x" << serial / parallel << ")\n";
+    };
+
+    std::vector<int> numbers = random_numbers(size);
+    std::vector<int> output(size);
+
+    {
+        std::vector<int> copy = numbers;
+        const double serial = measure([&] { std::ranges::sort(copy); });
+        copy = numbers;
+        const double parallel = measure([&] { par::sort(copy); });
+        report("sort", serial, parallel);
+
+        copy = numbers;
+        const double serial_stable = measure([&] { std::ranges::stable_sort(copy); });
+        copy = numbers;
+        const double parallel_stable = measure([&] { par::stable_sort(copy); });
+        report("stable_sort", serial_stable, parallel_stable);
+    }
+
+    {
+        std::vector<std::string> words(size / 10);
+        helpers::random::PCG rnd{665};
+        for (std::string& word : words)
+            word = "word-" + std::to_string(rnd() % 10'000'000);
+
+        std::vector<std::string> copy = words;
+        const double serial = measure([&] { std::ranges::sort(copy, std::less{}, [](const std::string& s) -> std::string_view { return s; }); });
+        copy = words;
+        const double parallel = measure([&] { par::sort(copy, std::less{}, [](const std::string& s) -> std::string_view { return s; }); });
+        report("sort - 10^7 strings, projection", serial, parallel);
+    }
+
+    auto expensive = [](int n) { return static_cast<int>(std::sqrt(std::abs(n)) * 3.0); };
+    report("transform", measure([&] { std::ranges::transform(numbers, output.begin(), expensive); }),
+        measure([&] { par::transform(numbers, output.begin(), expensive); }));
+
+    auto is_even = [](int n) { return n % 2 == 0; };
+    report("copy_if", measure([&] { std::ranges::copy_if(numbers, output.begin(), is_even); }),
+        measure([&] { par::copy_if(numbers, output.begin(), is_even); }));
+
+    long long sink = 0;
+    report("count_if", measure([&] { sink += std::ranges::count_if(numbers, is_even); }), measure([&] { sink += par::count_if(numbers, is_even); }));
+    report("reduce", measure([&] { sink += std::reduce(numbers.begin(), numbers.end(), 0LL); }), measure([&] { sink += par::reduce(numbers, 0LL); }));
+    report("for_each", measure([&] { std::ranges::for_each(numbers, [](int& n) { n = n * 3 + 1; }); }),
+        measure([&] { par::for_each(numbers, [](int& n) { n = n * 3 + 1; }); }));
+
+    CHECK(sink != 0);
+}
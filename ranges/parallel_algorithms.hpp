@@ -0,0 +1,416 @@
+#ifndef PARALLEL_ALGORITHMS_HPP
+#define PARALLEL_ALGORITHMS_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+// Parallel counterparts of the std::ranges algorithms (which take no execution policies):
+//   par::sort, par::stable_sort, par::transform, par::copy_if, par::reduce, par::fold, par::for_each, par::count_if
+// The same arguments as in std::ranges (iterator & sentinel or a range, projections), but the input must be
+// random-access. The work is split into chunks run on ThreadPool::global(); small inputs are processed serially.
+// Function objects are shared by the threads - they must be safe to call concurrently.
+namespace par
+{
+    namespace Detail
+    {
+        inline constexpr std::ptrdiff_t min_chunk_size = 16'384; // below that a task costs more than it saves
+
+        inline std::ptrdiff_t chunk_count(std::ptrdiff_t size)
+        {
+            const auto max_chunks = static_cast<std::ptrdiff_t>(4 * (ThreadPool::global().size() + 1)); // + the calling thread
+            return std::clamp<std::ptrdiff_t>(size / min_chunk_size, 1, max_chunks);
+        }
+
+        // body(begin, end, chunk_index) for the consecutive chunks of [0, size) - the caller runs the first chunk itself
+        template <typename TBody>
+        void for_chunks(std::ptrdiff_t size, std::ptrdiff_t chunks, TBody& body)
+        {
+            auto chunk_begin = [=](std::ptrdiff_t index) { return size * index / chunks; };
+
+            TaskGroup group;
+            for (std::ptrdiff_t index = 1; index < chunks; ++index)
+                group.run([&, index] { body(chunk_begin(index), chunk_begin(index + 1), index); });
+
+            body(chunk_begin(0), chunk_begin(1), 0);
+            group.wait();
+        }
+
+        // as for std::reduce - the projected elements, the partial results of the chunks & init are combined
+        // in any pairing, so each of them must be convertible to T & op must accept any two of them
+        template <typename TBinaryOp, typename T, typename TProjected>
+        concept Reduction = std::convertible_to<TProjected, T>
+            && std::convertible_to<std::invoke_result_t<TBinaryOp&, T, T>, T>
+            && std::convertible_to<std::invoke_result_t<TBinaryOp&, T, TProjected>, T>
+            && std::convertible_to<std::invoke_result_t<TBinaryOp&, TProjected, T>, T>
+            && std::convertible_to<std::invoke_result_t<TBinaryOp&, TProjected, TProjected>, T>;
+
+        inline constexpr std::ptrdiff_t min_merge_size = 32'768;
+
+        // merges two sorted sequences into out (moving the elements) - split recursively around the middle
+        // of the longer one, the halves are merged in parallel
+        template <typename TIn1, typename TIn2, typename TOut, typename TComp, typename TProj>
+        void parallel_merge(TIn1 first1, TIn1 last1, TIn2 first2, TIn2 last2, TOut out, TComp& comp, TProj& proj, TaskGroup& group)
+        {
+            for (;;)
+            {
+                const std::ptrdiff_t size1 = last1 - first1;
+                const std::ptrdiff_t size2 = last2 - first2;
+
+                if (size1 + size2 <= min_merge_size)
+                {
+                    std::ranges::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+                        std::make_move_iterator(first2), std::make_move_iterator(last2), out, std::ref(comp), std::ref(proj), std::ref(proj));
+                    return;
+                }
+
+                TIn1 middle1;
+                TIn2 middle2;
+                if (size1 >= size2)
+                {
+                    middle1 = first1 + size1 / 2;
+                    middle2 = std::ranges::lower_bound(first2, last2, std::invoke(proj, *middle1), std::ref(comp), std::ref(proj));
+                }
+                else
+                {
+                    middle2 = first2 + size2 / 2;
+                    middle1 = std::ranges::upper_bound(first1, last1, std::invoke(proj, *middle2), std::ref(comp), std::ref(proj));
+                }
+
+                group.run([=, &comp, &proj, &group] { parallel_merge(first1, middle1, first2, middle2, out, comp, proj, group); });
+
+                out += (middle1 - first1) + (middle2 - first2);
+                first1 = middle1;
+                first2 = middle2;
+            }
+        }
+
+        // the chunks are sorted in parallel, then merged pairwise (ping-pong between the range and a buffer);
+        // the merges keep the order of equal elements - the sort is stable if the chunks are sorted stably
+        template <bool Stable, typename TIter, typename TComp, typename TProj>
+        void parallel_sort(TIter first, TIter last, TComp& comp, TProj& proj)
+        {
+            auto serial_sort = [&](TIter begin, TIter end) {
+                if constexpr (Stable)
+                    std::ranges::stable_sort(begin, end, std::ref(comp), std::ref(proj));
+                else
+                    std::ranges::sort(begin, end, std::ref(comp), std::ref(proj));
+            };
+
+            using Value = std::iter_value_t<TIter>;
+
+            const std::ptrdiff_t size = last - first;
+            const std::ptrdiff_t chunks = chunk_count(size);
+
+            if constexpr (std::default_initializable<Value>)
+            {
+                if (chunks > 1)
+                {
+                    std::vector<std::ptrdiff_t> bounds(chunks + 1);
+                    for (std::ptrdiff_t i = 0; i <= chunks; ++i)
+                        bounds[i] = size * i / chunks;
+
+                    auto sort_chunk = [&](std::ptrdiff_t, std::ptrdiff_t, std::ptrdiff_t index) { serial_sort(first + bounds[index], first + bounds[index + 1]); };
+                    for_chunks(size, chunks, sort_chunk);
+
+                    std::vector<Value> buffer(size);
+
+                    auto merge_round = [&](auto source, auto target, std::ptrdiff_t width) {
+                        TaskGroup group;
+                        for (std::ptrdiff_t left = 0; left < chunks; left += 2 * width)
+                        {
+                            const std::ptrdiff_t middle = std::min(left + width, chunks);
+                            const std::ptrdiff_t right = std::min(left + 2 * width, chunks);
+                            group.run([=, &bounds, &comp, &proj, &group] {
+                                parallel_merge(source + bounds[left], source + bounds[middle], source + bounds[middle], source + bounds[right],
+                                    target + bounds[left], comp, proj, group);
+                            });
+                        }
+                        group.wait();
+                    };
+
+                    bool in_buffer = false;
+                    for (std::ptrdiff_t width = 1; width < chunks; width *= 2, in_buffer = !in_buffer)
+                    {
+                        if (in_buffer)
+                            merge_round(buffer.begin(), first, width);
+                        else
+                            merge_round(first, buffer.begin(), width);
+                    }
+
+                    if (in_buffer)
+                    {
+                        auto move_back = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t) {
+                            std::ranges::move(buffer.begin() + begin, buffer.begin() + end, first + begin);
+                        };
+                        for_chunks(size, chunks, move_back);
+                    }
+
+                    return;
+                }
+            }
+
+            serial_sort(first, last);
+        }
+    } // namespace Detail
+
+    //////////////////////////////////////////////////////////////////////
+    // for_each - returns the end of the input (not the function object - it has been shared by the threads)
+
+    template <std::random_access_iterator TIter, std::sentinel_for<TIter> TSentinel, typename TProj = std::identity,
+        std::indirectly_unary_invocable<std::projected<TIter, TProj>> TFunction>
+    TIter for_each(TIter first, TSentinel last, TFunction function, TProj proj = {})
+    {
+        const TIter end = std::ranges::next(first, last);
+
+        auto body = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t) {
+            for (TIter it = first + begin; it != first + end; ++it)
+                std::invoke(function, std::invoke(proj, *it));
+        };
+        Detail::for_chunks(end - first, Detail::chunk_count(end - first), body);
+
+        return end;
+    }
+
+    template <std::ranges::random_access_range TRange, typename TProj = std::identity,
+        std::indirectly_unary_invocable<std::projected<std::ranges::iterator_t<TRange>, TProj>> TFunction>
+    std::ranges::borrowed_iterator_t<TRange> for_each(TRange&& rng, TFunction function, TProj proj = {})
+    {
+        return par::for_each(std::ranges::begin(rng), std::ranges::end(rng), std::move(function), std::move(proj));
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // transform - the output must be random-access too
+
+    template <std::random_access_iterator TIter, std::sentinel_for<TIter> TSentinel, std::random_access_iterator TOut,
+        std::copy_constructible TFunction, typename TProj = std::identity>
+        requires std::indirectly_writable<TOut, std::indirect_result_t<TFunction&, std::projected<TIter, TProj>>>
+    std::ranges::unary_transform_result<TIter, TOut> transform(TIter first, TSentinel last, TOut out, TFunction function, TProj proj = {})
+    {
+        const TIter end = std::ranges::next(first, last);
+
+        auto body = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t) {
+            std::ranges::transform(first + begin, first + end, out + begin, std::ref(function), std::ref(proj));
+        };
+        Detail::for_chunks(end - first, Detail::chunk_count(end - first), body);
+
+        return {end, out + (end - first)};
+    }
+
+    template <std::ranges::random_access_range TRange, std::random_access_iterator TOut, std::copy_constructible TFunction,
+        typename TProj = std::identity>
+        requires std::indirectly_writable<TOut, std::indirect_result_t<TFunction&, std::projected<std::ranges::iterator_t<TRange>, TProj>>>
+    std::ranges::unary_transform_result<std::ranges::borrowed_iterator_t<TRange>, TOut> transform(TRange&& rng, TOut out, TFunction function, TProj proj = {})
+    {
+        return par::transform(std::ranges::begin(rng), std::ranges::end(rng), std::move(out), std::move(function), std::move(proj));
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // count_if
+
+    template <std::random_access_iterator TIter, std::sentinel_for<TIter> TSentinel, typename TProj = std::identity,
+        std::indirect_unary_predicate<std::projected<TIter, TProj>> TPredicate>
+    std::iter_difference_t<TIter> count_if(TIter first, TSentinel last, TPredicate pred, TProj proj = {})
+    {
+        const TIter end = std::ranges::next(first, last);
+        const std::ptrdiff_t chunks = Detail::chunk_count(end - first);
+
+        std::vector<std::iter_difference_t<TIter>> counts(chunks);
+        auto body = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t index) {
+            counts[index] = std::ranges::count_if(first + begin, first + end, std::ref(pred), std::ref(proj));
+        };
+        Detail::for_chunks(end - first, chunks, body);
+
+        return std::reduce(counts.begin(), counts.end());
+    }
+
+    template <std::ranges::random_access_range TRange, typename TProj = std::identity,
+        std::indirect_unary_predicate<std::projected<std::ranges::iterator_t<TRange>, TProj>> TPredicate>
+    std::ranges::range_difference_t<TRange> count_if(TRange&& rng, TPredicate pred, TProj proj = {})
+    {
+        return par::count_if(std::ranges::begin(rng), std::ranges::end(rng), std::move(pred), std::move(proj));
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // copy_if - in parallel for a random-access output (the matches of each chunk are counted first,
+    // so that every chunk knows where its output starts), serially for any other one (e.g. std::back_inserter)
+
+    template <std::random_access_iterator TIter, std::sentinel_for<TIter> TSentinel, std::weakly_incrementable TOut,
+        typename TProj = std::identity, std::indirect_unary_predicate<std::projected<TIter, TProj>> TPredicate>
+        requires std::indirectly_copyable<TIter, TOut>
+    std::ranges::copy_if_result<TIter, TOut> copy_if(TIter first, TSentinel last, TOut out, TPredicate pred, TProj proj = {})
+    {
+        const TIter end = std::ranges::next(first, last);
+        const std::ptrdiff_t chunks = Detail::chunk_count(end - first);
+
+        if constexpr (std::random_access_iterator<TOut>)
+        {
+            if (chunks > 1)
+            {
+                std::vector<std::ptrdiff_t> offsets(chunks + 1);
+                auto count = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t index) {
+                    offsets[index + 1] = std::ranges::count_if(first + begin, first + end, std::ref(pred), std::ref(proj));
+                };
+                Detail::for_chunks(end - first, chunks, count);
+
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+                auto copy = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t index) {
+                    std::ranges::copy_if(first + begin, first + end, out + offsets[index], std::ref(pred), std::ref(proj));
+                };
+                Detail::for_chunks(end - first, chunks, copy);
+
+                return {end, out + offsets[chunks]};
+            }
+        }
+
+        return std::ranges::copy_if(first, end, std::move(out), std::ref(pred), std::ref(proj));
+    }
+
+    template <std::ranges::random_access_range TRange, std::weakly_incrementable TOut, typename TProj = std::identity,
+        std::indirect_unary_predicate<std::projected<std::ranges::iterator_t<TRange>, TProj>> TPredicate>
+        requires std::indirectly_copyable<std::ranges::iterator_t<TRange>, TOut>
+    std::ranges::copy_if_result<std::ranges::borrowed_iterator_t<TRange>, TOut> copy_if(TRange&& rng, TOut out, TPredicate pred, TProj proj = {})
+    {
+        return par::copy_if(std::ranges::begin(rng), std::ranges::end(rng), std::move(out), std::move(pred), std::move(proj));
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // reduce - op must be associative (the partial results are combined in the order of the chunks,
+    // so it does not have to be commutative) & homogeneous as for std::reduce: a chunk is seeded with its first
+    // element, the partial results are passed to op as elements - a fold of an accumulator & an element of
+    // different meanings (op(count, x) { return count + (x & 1); }) needs par::fold
+
+    template <std::random_access_iterator TIter, std::sentinel_for<TIter> TSentinel, typename T, typename TBinaryOp = std::plus<>,
+        typename TProj = std::identity>
+        requires Detail::Reduction<TBinaryOp, T, std::indirect_result_t<TProj&, TIter>>
+    T reduce(TIter first, TSentinel last, T init, TBinaryOp op = {}, TProj proj = {})
+    {
+        const TIter end = std::ranges::next(first, last);
+        const std::ptrdiff_t chunks = Detail::chunk_count(end - first);
+
+        if (chunks == 1)
+        {
+            for (; first != end; ++first)
+                init = std::invoke(op, std::move(init), std::invoke(proj, *first));
+            return init;
+        }
+
+        std::vector<std::optional<T>> partials(chunks);
+        auto body = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t index) {
+            T partial = std::invoke(proj, first[begin]); // the chunks are never empty - seeded with an element as T
+            for (std::ptrdiff_t i = begin + 1; i < end; ++i)
+                partial = std::invoke(op, std::move(partial), std::invoke(proj, first[i]));
+            partials[index].emplace(std::move(partial));
+        };
+        Detail::for_chunks(end - first, chunks, body);
+
+        for (std::optional<T>& partial : partials)
+            init = std::invoke(op, std::move(init), std::move(*partial));
+        return init;
+    }
+
+    template <std::ranges::random_access_range TRange, typename T, typename TBinaryOp = std::plus<>, typename TProj = std::identity>
+        requires Detail::Reduction<TBinaryOp, T, std::indirect_result_t<TProj&, std::ranges::iterator_t<TRange>>>
+    T reduce(TRange&& rng, T init, TBinaryOp op = {}, TProj proj = {})
+    {
+        return par::reduce(std::ranges::begin(rng), std::ranges::end(rng), std::move(init), std::move(op), std::move(proj));
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // fold - op(T, element) of any types: each chunk is folded from T{} (the first one from init),
+    // the partial results are combined in order with combine(T, T) - T{} must be an identity of combine
+
+    template <std::random_access_iterator TIter, std::sentinel_for<TIter> TSentinel, std::default_initializable T, typename TFoldOp,
+        typename TCombineOp = std::plus<>, typename TProj = std::identity>
+        requires std::convertible_to<std::invoke_result_t<TFoldOp&, T, std::indirect_result_t<TProj&, TIter>>, T>
+        && std::convertible_to<std::invoke_result_t<TCombineOp&, T, T>, T>
+    T fold(TIter first, TSentinel last, T init, TFoldOp op, TCombineOp combine = {}, TProj proj = {})
+    {
+        const TIter end = std::ranges::next(first, last);
+        const std::ptrdiff_t chunks = Detail::chunk_count(end - first);
+
+        if (chunks == 1)
+        {
+            for (; first != end; ++first)
+                init = std::invoke(op, std::move(init), std::invoke(proj, *first));
+            return init;
+        }
+
+        std::vector<std::optional<T>> partials(chunks);
+        auto body = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t index) {
+            T partial = index == 0 ? init : T{};
+            for (std::ptrdiff_t i = begin; i < end; ++i)
+                partial = std::invoke(op, std::move(partial), std::invoke(proj, first[i]));
+            partials[index].emplace(std::move(partial));
+        };
+        Detail::for_chunks(end - first, chunks, body);
+
+        T result = std::move(*partials[0]);
+        for (std::ptrdiff_t index = 1; index < chunks; ++index)
+            result = std::invoke(combine, std::move(result), std::move(*partials[index]));
+        return result;
+    }
+
+    template <std::ranges::random_access_range TRange, std::default_initializable T, typename TFoldOp, typename TCombineOp = std::plus<>,
+        typename TProj = std::identity>
+        requires std::convertible_to<std::invoke_result_t<TFoldOp&, T, std::indirect_result_t<TProj&, std::ranges::iterator_t<TRange>>>, T>
+        && std::convertible_to<std::invoke_result_t<TCombineOp&, T, T>, T>
+    T fold(TRange&& rng, T init, TFoldOp op, TCombineOp combine = {}, TProj proj = {})
+    {
+        return par::fold(std::ranges::begin(rng), std::ranges::end(rng), std::move(init), std::move(op), std::move(combine), std::move(proj));
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // sort - not stable (like std::ranges::sort); needs a buffer of the size of the input
+    // (serial for a value type that is not default-constructible)
+
+    template <std::random_access_iterator TIter, std::sentinel_for<TIter> TSentinel, typename TComp = std::ranges::less,
+        typename TProj = std::identity>
+        requires std::sortable<TIter, TComp, TProj>
+    TIter sort(TIter first, TSentinel last, TComp comp = {}, TProj proj = {})
+    {
+        const TIter end = std::ranges::next(first, last);
+        Detail::parallel_sort<false>(first, end, comp, proj);
+        return end;
+    }
+
+    template <std::ranges::random_access_range TRange, typename TComp = std::ranges::less, typename TProj = std::identity>
+        requires std::sortable<std::ranges::iterator_t<TRange>, TComp, TProj>
+    std::ranges::borrowed_iterator_t<TRange> sort(TRange&& rng, TComp comp = {}, TProj proj = {})
+    {
+        return par::sort(std::ranges::begin(rng), std::ranges::end(rng), std::move(comp), std::move(proj));
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // stable_sort - the order of equal elements kept (like std::ranges::stable_sort); the same buffer as sort
+
+    template <std::random_access_iterator TIter, std::sentinel_for<TIter> TSentinel, typename TComp = std::ranges::less,
+        typename TProj = std::identity>
+        requires std::sortable<TIter, TComp, TProj>
+    TIter stable_sort(TIter first, TSentinel last, TComp comp = {}, TProj proj = {})
+    {
+        const TIter end = std::ranges::next(first, last);
+        Detail::parallel_sort<true>(first, end, comp, proj);
+        return end;
+    }
+
+    template <std::ranges::random_access_range TRange, typename TComp = std::ranges::less, typename TProj = std::identity>
+        requires std::sortable<std::ranges::iterator_t<TRange>, TComp, TProj>
+    std::ranges::borrowed_iterator_t<TRange> stable_sort(TRange&& rng, TComp comp = {}, TProj proj = {})
+    {
+        return par::stable_sort(std::ranges::begin(rng), std::ranges::end(rng), std::move(comp), std::move(proj));
+    }
+} // namespace par
+
+#endif
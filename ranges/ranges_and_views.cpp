@@ -7,6 +7,8 @@
 #include <string>
 #include <vector>
 
+#include "sentinels.hpp"
+
 using namespace std::literals;
 
 TEST_CASE("ranges")
@@ -15,14 +17,7 @@ TEST_CASE("ranges")
     helpers::print(data, "data");
 }
 
-template <auto Value_> // NTTP
-struct EndValue
-{
-    bool operator==(std::input_or_output_iterator auto pos) const
-    {
-        return *pos == Value_;
-    }
-};
+using Sentinels::EndValue; // a sized sentinel for contiguous iterators - the end is found with a SIMD scan
 
 TEST_CASE("ranges - algorithms")
 {
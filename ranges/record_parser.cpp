@@ -0,0 +1,230 @@
+#include <array>
+#include <bit>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <charconv>
+#include <cstdint>
+#include <random.hpp>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "record_parser.hpp"
+
+using namespace std::literals;
+
+namespace
+{
+    using IdName = Text::Schema<Text::Field<int, '/'>, Text::Field<std::string_view>>;
+
+    using Measurement = Text::Schema<Text::Field<std::uint32_t, ','>, Text::Field<double, ','>, Text::Field<std::int64_t, ','>, Text::Field<std::string_view, ','>, Text::Field<float>>;
+
+    std::string create_measurements(std::size_t count)
+    {
+        helpers::random::PCG rnd{42};
+        const std::string_view sensors[] = {"alpha", "beta", "gamma", "delta"};
+
+        std::string text;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            text += std::to_string(i) + ',';
+            text += std::to_string(rnd() % 100'000 / 100.0) + ',';
+            text += std::to_string(static_cast<std::int32_t>(rnd())) + ',';
+            text += std::string{sensors[rnd() % 4]} + ',';
+            text += std::to_string(rnd() % 1000 / 8.0f) + '\n';
+        }
+        return text;
+    }
+
+    // the fast paths parse what std::from_chars parses - the same value, the same end, the same error
+    template <typename T>
+    void check_like_from_chars(std::string_view text)
+    {
+        T expected{};
+        const auto [expected_end, expected_error] = std::from_chars(text.data(), text.data() + text.size(), expected);
+
+        T value{};
+        std::from_chars_result parsed;
+        if constexpr (std::integral<T>)
+            parsed = Text::Detail::parse_integer(text.data(), text.data() + text.size(), value);
+        else
+            parsed = Text::Detail::parse_decimal(text.data(), text.data() + text.size(), value);
+
+        INFO(text);
+        CHECK(parsed.ec == expected_error);
+        if (expected_error == std::errc{})
+        {
+            CHECK(parsed.ptr == expected_end);
+            CHECK(std::bit_cast<std::array<unsigned char, sizeof(T)>>(value) == std::bit_cast<std::array<unsigned char, sizeof(T)>>(expected));
+        }
+    }
+
+    // the record parsed field by field with std::views::split - the approach the schema replaces
+    std::vector<std::pair<int, std::string_view>> parse_with_split(std::string_view text)
+    {
+        std::vector<std::pair<int, std::string_view>> records;
+        for (auto&& line : text | std::views::split('\n'))
+        {
+            std::string_view record{line.begin(), line.end()};
+            if (record.empty())
+                continue;
+
+            auto fields = record | std::views::split('/');
+            auto it = fields.begin();
+            std::string_view id{(*it).begin(), (*it).end()};
+            ++it;
+            int value = 0;
+            std::from_chars(id.data(), id.data() + id.size(), value);
+            records.emplace_back(value, std::string_view{(*it).begin(), (*it).end()});
+        }
+        return records;
+    }
+} // namespace
+
+TEST_CASE("record parser - columns of a schema")
+{
+    SECTION("fields into columns")
+    {
+        const std::string_view text = "1/one\n2/two\n-3/three";
+        const IdName::Columns columns = Text::parse_records<IdName>(text, 1);
+
+        CHECK(columns.size() == 3);
+        CHECK(columns.get<0>() == std::vector{1, 2, -3});
+        CHECK(columns.get<1>() == std::vector{"one"sv, "two"sv, "three"sv});
+        CHECK(columns.get<1>()[0].data() == text.data() + 2); // a view into the text
+    }
+
+    SECTION("numbers of all kinds & empty strings")
+    {
+        const std::string_view text = "7,-2.5,-9000000000,,1e3\n8,0.125,42,beta,0.5\n";
+        const Measurement::Columns columns = Text::parse_records<Measurement>(text, 1);
+
+        CHECK(columns.get<0>() == std::vector<std::uint32_t>{7, 8});
+        CHECK(columns.get<1>() == std::vector{-2.5, 0.125});
+        CHECK(columns.get<2>() == std::vector<std::int64_t>{-9'000'000'000, 42});
+        CHECK(columns.get<3>() == std::vector{""sv, "beta"sv});
+        CHECK(columns.get<4>() == std::vector{1000.0f, 0.5f});
+    }
+
+    SECTION("empty text")
+    {
+        CHECK(Text::parse_records<IdName>("").empty());
+    }
+
+    SECTION("appending to columns")
+    {
+        IdName::Columns columns;
+        IdName::parse_into("1/one\n", columns);
+        IdName::parse_into("2/two\n", columns);
+        CHECK(columns.get<0>() == std::vector{1, 2});
+    }
+
+    SECTION("malformed records")
+    {
+        CHECK_THROWS_AS(Text::parse_records<IdName>("1/one\nx/two\n"), Text::ParseError);
+        CHECK_THROWS_AS(Text::parse_records<IdName>("1/one\n2\n3/three\n"), Text::ParseError); // missing delimiter
+        CHECK_THROWS_AS(Text::parse_records<IdName>("1/one\n2 /two\n"), Text::ParseError);
+        CHECK_THROWS_AS(Text::parse_records<Measurement>("1,2.0,3,abc\n4,5.0,6,def,7\n"), Text::ParseError); // the string field crosses the record
+
+        try
+        {
+            Text::parse_records<IdName>("1/one\n2:two\n3/three\n");
+        }
+        catch (const Text::ParseError& e)
+        {
+            CHECK(e.what() == "cannot parse field 0 of record \"2:two\""sv);
+        }
+    }
+}
+
+TEST_CASE("record parser - numbers parsed as std::from_chars does")
+{
+    SECTION("integers")
+    {
+        for (std::string_view text : {"0", "7,", "-1", "12345678", "123456789/", "-2147483648", "2147483647", "2147483648", "-2147483649",
+                 "0000000000000000000042", "99999999999999999999", "-", "", "x1", "+1", "12a"})
+        {
+            check_like_from_chars<int>(text);
+            check_like_from_chars<std::int64_t>(text);
+            check_like_from_chars<std::uint32_t>(text);
+        }
+
+        for (std::string_view text : {"255", "256", "-128", "-129", "65535", "65536", "18446744073709551615", "18446744073709551616", "9223372036854775808"})
+        {
+            check_like_from_chars<std::uint8_t>(text);
+            check_like_from_chars<std::int8_t>(text);
+            check_like_from_chars<std::uint16_t>(text);
+            check_like_from_chars<std::int64_t>(text);
+            check_like_from_chars<std::uint64_t>(text);
+        }
+
+        helpers::random::PCG rnd{7};
+        for (int i = 0; i < 10'000; ++i)
+        {
+            const std::string text = std::to_string(static_cast<std::int64_t>((std::uint64_t{rnd()} << 32) | rnd()) >> (rnd() % 64)) + ",1";
+            check_like_from_chars<std::int64_t>(text);
+            check_like_from_chars<std::int32_t>(text);
+        }
+    }
+
+    SECTION("decimals")
+    {
+        for (std::string_view text : {"0", "-0.0", "2.5", ".5", "5.", ".", "-", "", "1e3", "1.5E-3", "inf", "nan", "0.1", "123.450000",
+                 "16777217", "9007199254740993", "0.30000000000000004", "12345678901234567890.5", "3.14159265358979323846"})
+        {
+            check_like_from_chars<float>(text);
+            check_like_from_chars<double>(text);
+        }
+
+        helpers::random::PCG rnd{11};
+        for (int i = 0; i < 10'000; ++i)
+        {
+            std::string text = std::to_string(rnd() % 2'000'000) + "." + std::to_string(rnd() % 1'000'000'000);
+            if (rnd() % 2)
+                text.insert(0, "-");
+            check_like_from_chars<float>(text);
+            check_like_from_chars<double>(text);
+        }
+    }
+}
+
+TEST_CASE("record parser - parallel parse gives the sequential result")
+{
+    const std::string text = create_measurements(20'000);
+    const Measurement::Columns expected = Text::parse_records<Measurement>(text, 1);
+    CHECK(expected.size() == 20'000);
+
+    for (std::size_t threads : {2, 3, 8})
+        CHECK(Text::parse_records<Measurement>(text, threads) == expected);
+}
+
+TEST_CASE("record parser - benchmarks", "[.][benchmark]")
+{
+    std::string id_names;
+    for (int i = 0; i < 1'000'000; ++i)
+        id_names += std::to_string(i) + "/name" + std::to_string(i % 100) + '\n';
+
+    const std::string measurements = create_measurements(1'000'000);
+
+    BENCHMARK("id/name - views::split + from_chars")
+    {
+        return parse_with_split(id_names).size();
+    };
+
+    BENCHMARK("id/name - schema, 1 thread")
+    {
+        return Text::parse_records<IdName>(id_names, 1).size();
+    };
+
+    BENCHMARK("measurements - schema, 1 thread")
+    {
+        return Text::parse_records<Measurement>(measurements, 1).size();
+    };
+
+    BENCHMARK("measurements - schema, all threads")
+    {
+        return Text::parse_records<Measurement>(measurements).size();
+    };
+}
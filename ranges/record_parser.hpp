@@ -0,0 +1,345 @@
+#ifndef RECORD_PARSER_HPP
+#define RECORD_PARSER_HPP
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mapped_lines.hpp"
+
+// Delimited records parsed according to a compile-time schema into columns (struct of arrays):
+//
+//   using Schema = Text::Schema<Text::Field<int, '/'>, Text::Field<std::string_view>>; // "1/one\n2/two\n"
+//   Schema::Columns columns = Text::parse_records<Schema>(text);
+//   std::vector<int>& ids = columns.get<0>();
+//   std::vector<std::string_view>& names = columns.get<1>(); // views into text - no copies
+//
+// Numbers are parsed as std::from_chars does - with fast paths for the common short ones (integers 8 digits
+// at a time, plain decimals with a single division); a string field ends at its delimiter. The delimiter
+// of the last field ends the record (by default '\n' - also the end of the text is accepted there).
+// parse_records(text, threads) parses chunks of whole lines on separate threads and concatenates the columns.
+// A malformed record throws Text::ParseError.
+namespace Text
+{
+    namespace Detail
+    {
+        // the count of the leading decimal digits in 8 bytes (little endian) and their value
+        inline unsigned parse_8_digits(const char* pos, std::uint64_t& value) noexcept
+        {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, pos, 8);
+
+            // a byte of a non-digit gets its high bit set - a borrow or a carry spoils only the bytes after it
+            const std::uint64_t digits = chunk - 0x3030'3030'3030'3030;
+            const std::uint64_t non_digits = (digits | (digits + 0x7676'7676'7676'7676)) & 0x8080'8080'8080'8080;
+            const unsigned count = static_cast<unsigned>(std::countr_zero(non_digits)) / 8;
+            if (count == 0)
+                return 0;
+
+            std::uint64_t result = digits << (8 * (8 - count)); // leading zeros in place of the bytes after the digits
+            result = (result * 10 + (result >> 8)) & 0x00FF'00FF'00FF'00FF;
+            result = (result * 100 + (result >> 16)) & 0x0000'FFFF'0000'FFFF;
+            result = (result * 10'000 + (result >> 32)) & 0xFFFF'FFFF;
+            value = result;
+            return count;
+        }
+
+        // std::from_chars for base 10 - the common (short) numbers without the per-digit loop
+        template <std::integral T>
+        std::from_chars_result parse_integer(const char* first, const char* last, T& value) noexcept
+        {
+            static constexpr std::uint64_t powers_of_10[] = {1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000};
+
+            const char* pos = first;
+            bool negative = false;
+            if constexpr (std::is_signed_v<T>)
+            {
+                if (pos != last && *pos == '-')
+                {
+                    negative = true;
+                    ++pos;
+                }
+            }
+
+            std::uint64_t result = 0;
+            unsigned count = 0;
+            for (;;)
+            {
+                if (last - pos >= 8)
+                {
+                    std::uint64_t part = 0;
+                    const unsigned part_count = parse_8_digits(pos, part);
+                    result = result * powers_of_10[part_count] + part;
+                    count += part_count;
+                    pos += part_count;
+                    if (part_count < 8)
+                        break;
+                }
+                else
+                {
+                    for (; pos != last && static_cast<unsigned char>(*pos - '0') < 10; ++pos, ++count)
+                        result = result * 10 + static_cast<unsigned char>(*pos - '0');
+                    break;
+                }
+
+                if (count > 8) // 16 digits fit in 64 bits - longer numbers are left to std::from_chars
+                    return std::from_chars(first, last, value);
+            }
+
+            if (count == 0 || count > 16)
+                return std::from_chars(first, last, value);
+
+            using U = std::make_unsigned_t<T>;
+            const std::uint64_t max = std::uint64_t{std::numeric_limits<U>::max() >> std::is_signed_v<T>} + negative;
+            if (result > max)
+                return {first, std::errc::result_out_of_range};
+
+            value = static_cast<T>(negative ? U(0) - static_cast<U>(result) : static_cast<U>(result));
+            return {pos, std::errc{}};
+        }
+
+        // std::from_chars for plain decimals ("-12.375") - exact when the digits fit in the mantissa and the
+        // power of 10 is exact too (Clinger's fast path: a single correctly rounded division); the rest - from_chars
+        template <std::floating_point T>
+        std::from_chars_result parse_decimal(const char* first, const char* last, T& value) noexcept
+        {
+            static constexpr T powers_of_10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10};
+
+            const char* pos = first;
+            const bool negative = pos != last && *pos == '-';
+            pos += negative;
+
+            std::uint64_t mantissa = 0;
+            unsigned digits = 0;
+            unsigned fraction_digits = 0;
+
+            for (; pos != last && static_cast<unsigned char>(*pos - '0') < 10; ++pos, ++digits)
+                mantissa = mantissa * 10 + static_cast<unsigned char>(*pos - '0');
+            if (pos != last && *pos == '.')
+            {
+                for (++pos; pos != last && static_cast<unsigned char>(*pos - '0') < 10; ++pos, ++fraction_digits)
+                    mantissa = mantissa * 10 + static_cast<unsigned char>(*pos - '0');
+            }
+
+            const bool exponent = pos != last && (*pos == 'e' || *pos == 'E');
+            if (digits + fraction_digits == 0 || digits + fraction_digits > 19 || exponent)
+                return std::from_chars(first, last, value);
+
+            constexpr std::uint64_t max_mantissa = std::uint64_t{1} << std::numeric_limits<T>::digits;
+            if (mantissa > max_mantissa || fraction_digits >= std::size(powers_of_10))
+            {
+                for (; fraction_digits > 0 && mantissa % 10 == 0; --fraction_digits) // "2.500000" == "2.5"
+                    mantissa /= 10;
+            }
+
+            if (mantissa > max_mantissa || fraction_digits >= std::size(powers_of_10))
+                return std::from_chars(first, last, value);
+
+            const T result = static_cast<T>(mantissa) / powers_of_10[fraction_digits];
+            value = negative ? -result : result;
+            return {pos, std::errc{}};
+        }
+
+        // the first of two bytes - 8 bytes at a time (SWAR); fields are short, a memchr call would cost more
+        inline const char* find_either(const char* pos, const char* end, char first, char second) noexcept
+        {
+            constexpr std::uint64_t ones = 0x0101'0101'0101'0101;
+            constexpr std::uint64_t high_bits = 0x8080'8080'8080'8080;
+            const std::uint64_t first_bytes = ones * static_cast<unsigned char>(first);
+            const std::uint64_t second_bytes = ones * static_cast<unsigned char>(second);
+
+            for (; end - pos >= 8; pos += 8)
+            {
+                std::uint64_t chunk;
+                std::memcpy(&chunk, pos, 8);
+
+                // high bit of every zero byte of x (the bytes after a zero one may be marked too - they are not needed)
+                const std::uint64_t x = chunk ^ first_bytes;
+                const std::uint64_t y = chunk ^ second_bytes;
+                if (const std::uint64_t found = (((x - ones) & ~x) | ((y - ones) & ~y)) & high_bits)
+                    return pos + std::countr_zero(found) / 8;
+            }
+
+            for (; pos != end; ++pos)
+            {
+                if (*pos == first || *pos == second)
+                    return pos;
+            }
+            return end;
+        }
+    } // namespace Detail
+
+    template <typename T>
+    concept FieldType = (std::is_arithmetic_v<T> && !std::same_as<T, bool>) || std::same_as<T, std::string_view>;
+
+    template <FieldType T, char Delimiter = '\n'>
+    struct Field
+    {
+        using type = T;
+        static constexpr char delimiter = Delimiter;
+    };
+
+    class ParseError : public std::runtime_error
+    {
+    public:
+        ParseError(std::size_t field, std::string_view record)
+            : std::runtime_error{"cannot parse field " + std::to_string(field) + " of record \"" + std::string{record} + "\""}
+        { }
+    };
+
+    // a column (std::vector) per field
+    template <typename... TFields>
+    class Columns
+    {
+    public:
+        template <std::size_t Index>
+        auto& get() noexcept { return std::get<Index>(columns_); }
+
+        template <std::size_t Index>
+        const auto& get() const noexcept { return std::get<Index>(columns_); }
+
+        std::size_t size() const noexcept { return std::get<0>(columns_).size(); }
+
+        bool empty() const noexcept { return size() == 0; }
+
+        void reserve(std::size_t records)
+        {
+            std::apply([=](auto&... columns) { (columns.reserve(records), ...); }, columns_);
+        }
+
+        // the records of the other columns moved after the records of these
+        void append(Columns&& other)
+        {
+            [&]<std::size_t... Indexes>(std::index_sequence<Indexes...>) {
+                (std::get<Indexes>(columns_).insert(std::get<Indexes>(columns_).end(), std::get<Indexes>(other.columns_).begin(), std::get<Indexes>(other.columns_).end()), ...);
+            }(std::index_sequence_for<TFields...>{});
+        }
+
+        bool operator==(const Columns&) const = default;
+
+    private:
+        std::tuple<std::vector<typename TFields::type>...> columns_;
+    };
+
+    template <typename... TFields>
+    struct Schema
+    {
+        static_assert(sizeof...(TFields) > 0);
+
+        using Columns = Text::Columns<TFields...>;
+
+        static constexpr char record_delimiter = std::get<sizeof...(TFields) - 1>(std::tuple{TFields::delimiter...});
+
+        // appends the records of text to columns (after a ParseError they may hold a part of the bad record)
+        static void parse_into(std::string_view text, Columns& columns)
+        {
+            const char* pos = text.data();
+            const char* const end = pos + text.size();
+
+            constexpr std::size_t sample_size = 64;
+            std::size_t records = 0;
+
+            while (pos != end)
+            {
+                const char* const record = pos;
+                [&]<std::size_t... Indexes>(std::index_sequence<Indexes...>) {
+                    (parse_field<Indexes, TFields>(pos, end, record, columns.template get<Indexes>()), ...);
+                }(std::index_sequence_for<TFields...>{});
+
+                // the columns reserved for the records estimated from the first ones (+ 1/8) - no reallocations on the way
+                if (++records == sample_size)
+                {
+                    const auto parsed_size = static_cast<std::size_t>(pos - text.data());
+                    const std::size_t estimate = static_cast<std::size_t>(end - pos) * sample_size / parsed_size;
+                    columns.reserve(columns.size() + estimate + estimate / 8);
+                }
+            }
+        }
+
+    private:
+        template <std::size_t Index, typename TField>
+        static void parse_field(const char*& pos, const char* end, const char* record, std::vector<typename TField::type>& column)
+        {
+            using T = typename TField::type;
+            constexpr bool is_last = Index == sizeof...(TFields) - 1;
+
+            if constexpr (std::same_as<T, std::string_view>)
+            {
+                // the end of the record before the delimiter - an error reported below
+                const char* field_end = Detail::find_either(pos, end, TField::delimiter, record_delimiter);
+                column.emplace_back(pos, field_end - pos);
+                pos = field_end;
+            }
+            else
+            {
+                T value;
+                std::from_chars_result parsed;
+                if constexpr (std::integral<T>)
+                    parsed = Detail::parse_integer(pos, end, value);
+                else
+                    parsed = Detail::parse_decimal(pos, end, value);
+
+                const auto [field_end, error] = parsed;
+                if (error != std::errc{})
+                    throw_error(Index, record, end);
+
+                column.push_back(value);
+                pos = field_end;
+            }
+
+            if (pos != end && *pos == TField::delimiter)
+                ++pos;
+            else if (!is_last || pos != end)
+                throw_error(Index, record, end);
+        }
+
+        [[noreturn]] static void throw_error(std::size_t field, const char* record, const char* end)
+        {
+            const std::string_view rest{record, static_cast<std::size_t>(end - record)};
+            throw ParseError{field, rest.substr(0, rest.find(record_delimiter))};
+        }
+    };
+
+    // parses the records of text on `threads_count` threads (chunks of whole lines - the record delimiter must be '\n')
+    template <typename TSchema>
+    typename TSchema::Columns parse_records(std::string_view text, std::size_t threads_count = std::max(1u, std::thread::hardware_concurrency()))
+    {
+        static_assert(TSchema::record_delimiter == '\n');
+
+        const std::vector<std::string_view> chunks = line_chunks(text, threads_count);
+        std::vector<typename TSchema::Columns> results(chunks.size());
+
+        auto parse = [&](std::size_t i) { TSchema::parse_into(chunks[i], results[i]); };
+        Detail::run_parallel(chunks.size(), parse);
+
+        if (results.empty())
+            return {};
+
+        std::size_t total_size = 0;
+        for (const auto& result : results)
+            total_size += result.size();
+
+        typename TSchema::Columns columns = std::move(results.front());
+        columns.reserve(total_size);
+        for (std::size_t i = 1; i < results.size(); ++i)
+            columns.append(std::move(results[i]));
+
+        return columns;
+    }
+} // namespace Text
+
+#endif
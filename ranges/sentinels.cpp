@@ -0,0 +1,148 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <random.hpp>
+#include <string>
+#include <vector>
+
+#include "sentinels.hpp"
+
+using Sentinels::EndValue;
+
+namespace
+{
+    // counts the comparisons with the sentinel made by an algorithm
+    template <auto Value_>
+    struct CountingEndValue
+    {
+        inline static int comparisons = 0;
+
+        bool operator==(std::input_or_output_iterator auto pos) const
+        {
+            ++comparisons;
+            return *pos == Value_;
+        }
+    };
+
+    template <typename T>
+    void check_every_end_position()
+    {
+        // every alignment of the start and every distance to the end (also within the first block)
+        for (std::size_t start = 0; start < 8; ++start)
+        {
+            for (std::size_t end = start; end < 140; ++end)
+            {
+                std::vector<T> data(160, T{1});
+                data[end] = T{0};
+                data[end + 3] = T{0};
+                CHECK(EndValue<0>{} - (data.begin() + start) == static_cast<std::ptrdiff_t>(end - start));
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE("EndValue - sized sentinel for contiguous iterators")
+{
+    static_assert(std::sized_sentinel_for<EndValue<'.'>, std::string::iterator>);
+    static_assert(std::sized_sentinel_for<EndValue<0>, const std::uint64_t*>);
+    static_assert(!std::sized_sentinel_for<EndValue<0>, std::list<int>::iterator>);
+
+    check_every_end_position<char>();
+    check_every_end_position<std::int16_t>();
+    check_every_end_position<std::uint32_t>();
+    check_every_end_position<std::int64_t>();
+
+    SECTION("negative & wide values")
+    {
+        const std::vector<std::int64_t> data = {5, 1LL << 40, -1, 7};
+        CHECK(EndValue<-1>{} - data.begin() == 2);
+        CHECK(data.begin() - EndValue<(1LL << 40)>{} == -1);
+    }
+
+    SECTION("not an integral element - compared one by one")
+    {
+        const std::vector<double> data = {1.5, 2.5, 0.0, 4.5};
+        CHECK(EndValue<0>{} - data.begin() == 2);
+    }
+
+    SECTION("constant evaluation")
+    {
+        constexpr std::array text = {'a', 'b', 'c', '\0'};
+        static_assert(EndValue<'\0'>{} - text.begin() == 3);
+    }
+}
+
+TEST_CASE("EndValue - algorithms with the sentinel")
+{
+    std::string str = "fajsdkh.gjadfg";
+
+    std::ranges::sort(str.begin(), EndValue<'.'>{});
+    CHECK(str == "adfhjks.gjadfg");
+
+    std::array text = std::to_array("acbgdef\0ajdhfgajsdhfgkasdjhfg");
+    std::ranges::sort(text.begin(), EndValue<'\0'>{}, std::greater{});
+    CHECK(std::string_view{text.data()} == "gfedcba");
+
+    SECTION("bounded - the sentinel is compared once")
+    {
+        std::vector<int> data = {5, 423, 665, 1, 235, 42, 6, 345, 33, -1, 8};
+        CountingEndValue<-1>::comparisons = 0;
+
+        auto bounded = Sentinels::bounded(data.begin(), CountingEndValue<-1>{});
+        CHECK(std::ranges::find(bounded, 42) == data.begin() + 5);
+        CHECK(std::ranges::find(bounded, 8) == bounded.end());
+        CHECK(CountingEndValue<-1>::comparisons == 10);
+
+        CHECK(std::ranges::find(Sentinels::bounded(data.begin(), EndValue<-1>{}), 33) == data.begin() + 8);
+    }
+}
+
+TEST_CASE("EndValue - benchmarks", "[.][benchmark]")
+{
+    std::string text(1'000'000, 'x');
+    text += '.';
+    std::vector<std::uint32_t> numbers(1'000'000, 7);
+    numbers.push_back(0);
+
+    // the end located comparing one element at a time
+    auto scalar_distance = [](auto first, auto value) {
+        auto pos = first;
+        while (*pos != value)
+            ++pos;
+        return pos - first;
+    };
+
+    BENCHMARK("find the end - char, one by one")
+    {
+        return scalar_distance(text.begin(), '.');
+    };
+
+    BENCHMARK("find the end - char, EndValue<'.'> - it")
+    {
+        return EndValue<'.'>{} - text.begin();
+    };
+
+    BENCHMARK("find the end - uint32, one by one")
+    {
+        return scalar_distance(numbers.begin(), 0u);
+    };
+
+    BENCHMARK("find the end - uint32, EndValue<0> - it")
+    {
+        return EndValue<0>{} - numbers.begin();
+    };
+
+    BENCHMARK("std::ranges::find with EndValue<'.'>")
+    {
+        return std::ranges::find(text.begin(), EndValue<'.'>{}, 'y') - text.begin();
+    };
+
+    BENCHMARK("std::ranges::find with bounded(it, EndValue<'.'>)")
+    {
+        return std::ranges::find(Sentinels::bounded(text.begin(), EndValue<'.'>{}), 'y') - text.begin();
+    };
+}
@@ -0,0 +1,196 @@
+#ifndef SENTINELS_HPP
+#define SENTINELS_HPP
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SENTINELS_X86 1
+#endif
+
+// Sentinels comparing an element with a constant (EndValue<'.'>, EndValue<'\0'>) and a SIMD scan for them:
+// for a contiguous iterator EndValue is a sized sentinel - `sentinel - it` finds the end with a memchr-like
+// kernel (8/16/32/64-bit integral elements), so algorithms that compute the end first (std::ranges::sort,
+// std::ranges::next, ...) locate it vectorized and run the bounded version.
+// bounded(it, sentinel) does the same for the algorithms that test the sentinel at every step (std::ranges::find).
+namespace Sentinels
+{
+    namespace Detail
+    {
+        template <typename T>
+        concept SimdScannable = std::integral<T> && !std::same_as<T, bool>
+            && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+        template <std::size_t Size>
+        using UInt = std::conditional_t<Size == 1, std::uint8_t,
+            std::conditional_t<Size == 2, std::uint16_t, std::conditional_t<Size == 4, std::uint32_t, std::uint64_t>>>;
+
+        template <typename T>
+        const T* find_unbounded_scalar(const T* pos, T value) noexcept
+        {
+            while (*pos != value)
+                ++pos;
+            return pos;
+        }
+
+#ifdef SENTINELS_X86
+        // The scans read whole aligned blocks - an aligned block never crosses a page, so the bytes read around
+        // the searched ones are always mapped (the same trick as in strlen); they are hidden from ASan.
+
+        template <typename T>
+        __attribute__((no_sanitize_address)) const T* find_unbounded_sse2(const T* pos, T value) noexcept
+        {
+            using U = UInt<sizeof(T)>;
+            const auto needle = std::bit_cast<U>(value);
+
+            __m128i needles;
+            if constexpr (sizeof(T) == 1)
+                needles = _mm_set1_epi8(static_cast<char>(needle));
+            else if constexpr (sizeof(T) == 2)
+                needles = _mm_set1_epi16(static_cast<short>(needle));
+            else if constexpr (sizeof(T) == 4)
+                needles = _mm_set1_epi32(static_cast<int>(needle));
+            else
+                needles = _mm_set1_epi64x(static_cast<long long>(needle));
+
+            const char* block = reinterpret_cast<const char*>(reinterpret_cast<std::uintptr_t>(pos) & ~std::uintptr_t{15});
+            const unsigned skipped = static_cast<unsigned>(reinterpret_cast<const char*>(pos) - block);
+
+            for (std::uint32_t ignored = ~0u << skipped;; ignored = ~0u, block += 16)
+            {
+                const __m128i data = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+                __m128i equal;
+                if constexpr (sizeof(T) == 1)
+                    equal = _mm_cmpeq_epi8(data, needles);
+                else if constexpr (sizeof(T) == 2)
+                    equal = _mm_cmpeq_epi16(data, needles);
+                else if constexpr (sizeof(T) == 4)
+                    equal = _mm_cmpeq_epi32(data, needles);
+                else // no 64-bit compare in SSE2 - both halves must be equal
+                {
+                    const __m128i halves = _mm_cmpeq_epi32(data, needles);
+                    equal = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+                }
+
+                if (const std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(equal)) & ignored)
+                    return reinterpret_cast<const T*>(block + std::countr_zero(mask));
+            }
+        }
+
+        template <typename T>
+        __attribute__((target("avx2"), no_sanitize_address)) const T* find_unbounded_avx2(const T* pos, T value) noexcept
+        {
+            using U = UInt<sizeof(T)>;
+            const auto needle = std::bit_cast<U>(value);
+
+            __m256i needles;
+            if constexpr (sizeof(T) == 1)
+                needles = _mm256_set1_epi8(static_cast<char>(needle));
+            else if constexpr (sizeof(T) == 2)
+                needles = _mm256_set1_epi16(static_cast<short>(needle));
+            else if constexpr (sizeof(T) == 4)
+                needles = _mm256_set1_epi32(static_cast<int>(needle));
+            else
+                needles = _mm256_set1_epi64x(static_cast<long long>(needle));
+
+            const char* block = reinterpret_cast<const char*>(reinterpret_cast<std::uintptr_t>(pos) & ~std::uintptr_t{31});
+            const unsigned skipped = static_cast<unsigned>(reinterpret_cast<const char*>(pos) - block);
+
+            for (std::uint32_t ignored = ~0u << skipped;; ignored = ~0u, block += 32)
+            {
+                const __m256i data = _mm256_load_si256(reinterpret_cast<const __m256i*>(block));
+                __m256i equal;
+                if constexpr (sizeof(T) == 1)
+                    equal = _mm256_cmpeq_epi8(data, needles);
+                else if constexpr (sizeof(T) == 2)
+                    equal = _mm256_cmpeq_epi16(data, needles);
+                else if constexpr (sizeof(T) == 4)
+                    equal = _mm256_cmpeq_epi32(data, needles);
+                else
+                    equal = _mm256_cmpeq_epi64(data, needles);
+
+                if (const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(equal)) & ignored)
+                    return reinterpret_cast<const T*>(block + std::countr_zero(mask));
+            }
+        }
+
+        template <typename T>
+        using FindUnbounded = const T* (*)(const T*, T) noexcept;
+
+        template <typename T>
+        inline const FindUnbounded<T> find_unbounded_simd = [] {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &find_unbounded_avx2<T> : &find_unbounded_sse2<T>;
+        }();
+#endif
+
+        // Value converted to T compares equal to it (std::in_range does not accept character types)
+        template <typename T, auto Value>
+        constexpr bool representable = static_cast<decltype(Value)>(static_cast<T>(Value)) == Value && ((Value < 0) == (static_cast<T>(Value) < 0));
+
+        // first element equal to value - there must be one
+        template <SimdScannable T>
+        const T* find_unbounded(const T* pos, T value) noexcept
+        {
+#ifdef SENTINELS_X86
+            if (reinterpret_cast<std::uintptr_t>(pos) % sizeof(T) == 0) // the blocks must be made of whole elements
+                return find_unbounded_simd<T>(pos, value);
+#endif
+            return find_unbounded_scalar(pos, value);
+        }
+    } // namespace Detail
+
+    template <auto Value_> // NTTP
+    struct EndValue
+    {
+        bool operator==(std::input_or_output_iterator auto pos) const
+        {
+            return *pos == Value_;
+        }
+
+        // makes EndValue a sized sentinel for contiguous iterators - std::ranges::next(it, EndValue{}) is one scan
+        template <std::contiguous_iterator TIter>
+        friend constexpr std::iter_difference_t<TIter> operator-(EndValue, const TIter& pos)
+        {
+            using T = std::remove_cv_t<std::iter_value_t<TIter>>;
+
+            if constexpr (Detail::SimdScannable<T> && std::integral<decltype(Value_)> && Detail::representable<T, Value_>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    const T* first = std::to_address(pos);
+                    return Detail::find_unbounded(first, static_cast<T>(Value_)) - first;
+                }
+            }
+
+            TIter end = pos;
+            while (!(*end == Value_))
+                ++end;
+            return end - pos;
+        }
+
+        template <std::contiguous_iterator TIter>
+        friend constexpr std::iter_difference_t<TIter> operator-(const TIter& pos, EndValue sentinel)
+        {
+            return -(sentinel - pos);
+        }
+    };
+
+    // [it, sentinel) as a common range - the end located once, so the algorithm does not test the sentinel at every step
+    template <std::forward_iterator TIter, std::sentinel_for<TIter> TSentinel>
+    std::ranges::subrange<TIter> bounded(TIter first, TSentinel last)
+    {
+        TIter end = std::ranges::next(first, last);
+        return {std::move(first), std::move(end)};
+    }
+} // namespace Sentinels
+
+#endif
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random.hpp>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sorted_sets.hpp"
+
+namespace
+{
+    // sets of size & other_size (default: size) elements - selectivity of the smaller one is in both
+    template <typename T>
+    std::pair<std::vector<T>, std::vector<T>> create_sets(std::size_t size, double selectivity, std::uint32_t seed, std::size_t other_size = 0)
+    {
+        helpers::random::PCG rnd{seed};
+        other_size = other_size ? other_size : size;
+        const auto shared = static_cast<std::size_t>(selectivity * std::min(size, other_size));
+
+        // 0 - in both, 1 - in a only, 2 - in b only; spread at random over ascending ids
+        std::vector<char> owners(shared, 0);
+        owners.resize(size, 1);
+        owners.resize(size + other_size - shared, 2);
+        for (std::size_t i = owners.size() - 1; i > 0; --i)
+            std::swap(owners[i], owners[rnd() % (i + 1)]);
+
+        std::vector<T> a, b;
+        T id = rnd() % 16;
+        for (char owner : owners)
+        {
+            id += 1 + rnd() % 64;
+            if (owner != 2)
+                a.push_back(id);
+            if (owner != 1)
+                b.push_back(id);
+        }
+        return {std::move(a), std::move(b)};
+    }
+
+    template <typename T>
+    void check_like_std(const std::vector<T>& a, const std::vector<T>& b)
+    {
+        std::vector<T> expected;
+        std::ranges::set_intersection(a, b, std::back_inserter(expected));
+        std::vector<T> result;
+        Simd::set_intersection(std::span{a}, std::span{b}, result);
+        CHECK(result == expected);
+
+        expected.clear();
+        std::ranges::set_union(a, b, std::back_inserter(expected));
+        result.clear();
+        Simd::set_union(std::span{a}, std::span{b}, result);
+        CHECK(result == expected);
+
+        expected.clear();
+        std::ranges::set_difference(a, b, std::back_inserter(expected));
+        result.clear();
+        Simd::set_difference(std::span{a}, std::span{b}, result);
+        CHECK(result == expected);
+    }
+
+    template <typename T>
+    void check_all_shapes()
+    {
+        for (std::uint32_t seed = 1; seed <= 3; ++seed)
+            for (double selectivity : {0.0, 0.1, 0.5, 0.9, 1.0})
+                for (std::size_t size : {1, 7, 8, 9, 31, 100, 1000})
+                {
+                    const auto [a, b] = create_sets<T>(size, selectivity, seed, size + seed * 5);
+                    check_like_std(a, b);
+                    check_like_std(b, a);
+                }
+    }
+} // namespace
+
+TEST_CASE("sorted sets - as std::ranges set algorithms")
+{
+    SECTION("32-bit ids")
+    {
+        check_all_shapes<std::uint32_t>();
+    }
+
+    SECTION("64-bit ids")
+    {
+        check_all_shapes<std::uint64_t>();
+    }
+
+    SECTION("empty & equal sets")
+    {
+        const std::vector<std::uint32_t> empty;
+        const std::vector<std::uint32_t> ids = create_sets<std::uint32_t>(100, 0.5, 7).first;
+
+        check_like_std(empty, empty);
+        check_like_std(ids, empty);
+        check_like_std(empty, ids);
+        check_like_std(ids, ids);
+    }
+
+    SECTION("extreme values")
+    {
+        constexpr std::uint32_t max = std::numeric_limits<std::uint32_t>::max();
+        const std::vector<std::uint32_t> a = {0, 1, 2, 3, 4, 5, 6, 7, 8, 0x8000'0000u, max - 8, max - 1, max};
+        const std::vector<std::uint32_t> b = {0, 2, 4, 6, 8, 10, 12, 14, 0x7FFF'FFFFu, 0x8000'0000u, max - 2, max - 1, max};
+        check_like_std(a, b);
+        check_like_std(b, a);
+
+        const std::vector<std::uint64_t> wide_a = {0, 1, 2, 3, 0x8000'0000'0000'0000u, std::numeric_limits<std::uint64_t>::max()};
+        const std::vector<std::uint64_t> wide_b = {1, 3, 5, 7, 0x8000'0000'0000'0000u, std::numeric_limits<std::uint64_t>::max()};
+        check_like_std(wide_a, wide_b);
+    }
+
+    SECTION("skewed sizes - galloping")
+    {
+        for (double selectivity : {0.0, 0.3, 1.0})
+        {
+            const auto [a, b] = create_sets<std::uint32_t>(50, selectivity, 11, 50 * Simd::galloping_ratio * 3);
+            check_like_std(a, b);
+            check_like_std(b, a);
+
+            const auto [wide_a, wide_b] = create_sets<std::uint64_t>(20, selectivity, 13, 20'000);
+            check_like_std(wide_a, wide_b);
+            check_like_std(wide_b, wide_a);
+        }
+    }
+
+    SECTION("output spans - the room required")
+    {
+        const auto [a, b] = create_sets<std::uint32_t>(64, 0.5, 5);
+        std::vector<std::uint32_t> output(std::min(a.size(), b.size()));
+        const std::size_t count = Simd::set_intersection(std::span{a}, std::span{b}, std::span{output});
+
+        std::vector<std::uint32_t> expected;
+        std::ranges::set_intersection(a, b, std::back_inserter(expected));
+        output.resize(count);
+        CHECK(output == expected);
+    }
+}
+
+TEST_CASE("sorted sets - benchmarks", "[.][benchmark]")
+{
+    for (double selectivity : {0.01, 0.5, 0.99})
+    {
+        const auto [a, b] = create_sets<std::uint32_t>(1'000'000, selectivity, 42);
+        std::vector<std::uint32_t> output(a.size() + b.size());
+        const std::string label = " - 1M x 1M, selectivity " + std::to_string(selectivity);
+
+        BENCHMARK("std::set_intersection" + label)
+        {
+            return std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), output.begin()) - output.begin();
+        };
+
+        BENCHMARK("Simd::set_intersection" + label)
+        {
+            return Simd::set_intersection(std::span{a}, std::span{b}, std::span{output});
+        };
+
+        BENCHMARK("std::set_union" + label)
+        {
+            return std::set_union(a.begin(), a.end(), b.begin(), b.end(), output.begin()) - output.begin();
+        };
+
+        BENCHMARK("Simd::set_union" + label)
+        {
+            return Simd::set_union(std::span{a}, std::span{b}, std::span{output});
+        };
+
+        BENCHMARK("std::set_difference" + label)
+        {
+            return std::set_difference(a.begin(), a.end(), b.begin(), b.end(), output.begin()) - output.begin();
+        };
+
+        BENCHMARK("Simd::set_difference" + label)
+        {
+            return Simd::set_difference(std::span{a}, std::span{b}, std::span{output});
+        };
+    }
+
+    const auto [small, large] = create_sets<std::uint64_t>(1'000, 0.5, 7, 1'000'000);
+    std::vector<std::uint64_t> output(small.size() + large.size());
+
+    BENCHMARK("std::set_intersection - 64-bit, 1K x 1M")
+    {
+        return std::set_intersection(small.begin(), small.end(), large.begin(), large.end(), output.begin()) - output.begin();
+    };
+
+    BENCHMARK("Simd::set_intersection - 64-bit, 1K x 1M (galloping)")
+    {
+        return Simd::set_intersection(std::span{small}, std::span{large}, std::span{output});
+    };
+
+    const auto [a, b] = create_sets<std::uint64_t>(1'000'000, 0.5, 9);
+
+    BENCHMARK("std::set_intersection - 64-bit, 1M x 1M")
+    {
+        return std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), output.begin()) - output.begin();
+    };
+
+    BENCHMARK("Simd::set_intersection - 64-bit, 1M x 1M")
+    {
+        return Simd::set_intersection(std::span{a}, std::span{b}, std::span{output});
+    };
+}
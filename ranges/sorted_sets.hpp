@@ -0,0 +1,522 @@
+#ifndef SORTED_SETS_HPP
+#define SORTED_SETS_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "stream_compaction.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SORTED_SETS_X86 1
+#endif
+
+// Set operations on sorted spans of 32/64-bit ids - sets: sorted ascending, without duplicates:
+//   Simd::set_intersection(a, b, out), Simd::set_union(a, b, out), Simd::set_difference(a, b, out)
+// Sets of similar sizes are merged a vector at a time (AVX2):
+//  * intersection & difference - a vector of each set compared all against all (the other vector rotated
+//    in & across the lanes), the matched (unmatched) lanes moved to the front with the lookup tables of copy_if;
+//    the vector with the smaller last element is replaced by the next one
+//  * union (32-bit) - two vectors merged with a bitonic network, the lower half stored without the duplicates
+// When one set is galloping_ratio times larger than the other, the smaller one is galloped through the larger
+// one instead (an exponential search from the last position) - O(small * log(large / small)).
+// The vectors are stored whole - the output must have room for: min(a, b) (intersection), a + b (union), a (difference).
+namespace Simd
+{
+    template <typename T>
+    concept SetElement = std::same_as<T, std::uint32_t> || std::same_as<T, std::uint64_t>;
+
+    inline constexpr std::size_t galloping_ratio = 32;
+
+    namespace Detail
+    {
+        template <typename T>
+        using SetKernel = std::size_t (*)(const T* a, std::size_t a_size, const T* b, std::size_t b_size, T* out) noexcept;
+
+        //////////////////////////////////////////////////////////////////////
+        // scalar merges - the output position & the inputs advanced by the results of comparisons
+
+        template <typename T>
+        std::size_t intersect_scalar(const T* a, std::size_t a_size, const T* b, std::size_t b_size, T* out) noexcept
+        {
+            std::size_t i = 0, j = 0, count = 0;
+            while (i < a_size && j < b_size)
+            {
+                const T x = a[i];
+                const T y = b[j];
+                out[count] = x;
+                count += x == y;
+                i += x <= y;
+                j += y <= x;
+            }
+            return count;
+        }
+
+        template <typename T>
+        std::size_t unite_scalar(const T* a, std::size_t a_size, const T* b, std::size_t b_size, T* out) noexcept
+        {
+            std::size_t i = 0, j = 0, count = 0;
+            while (i < a_size && j < b_size)
+            {
+                const T x = a[i];
+                const T y = b[j];
+                out[count++] = x < y ? x : y;
+                i += x <= y;
+                j += y <= x;
+            }
+            out = std::copy(a + i, a + a_size, out + count);
+            std::copy(b + j, b + b_size, out);
+            return count + (a_size - i) + (b_size - j);
+        }
+
+        template <typename T>
+        std::size_t subtract_scalar(const T* a, std::size_t a_size, const T* b, std::size_t b_size, T* out) noexcept
+        {
+            std::size_t i = 0, j = 0, count = 0;
+            while (i < a_size && j < b_size)
+            {
+                const T x = a[i];
+                const T y = b[j];
+                out[count] = x;
+                count += x < y;
+                i += x <= y;
+                j += y <= x;
+            }
+            std::copy(a + i, a + a_size, out + count);
+            return count + (a_size - i);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // galloping - the smaller set searched for in the larger one
+
+        // the first position in [first, last) not less than value - probes at first + 1, 2, 4, ..., then a binary search
+        template <typename T>
+        const T* gallop(const T* first, const T* last, T value) noexcept
+        {
+            const std::size_t size = last - first;
+            if (size == 0 || !(*first < value))
+                return first;
+
+            std::size_t low = 0;
+            std::size_t high = 1;
+            while (high < size && first[high] < value)
+            {
+                low = high;
+                high *= 2;
+            }
+            return std::lower_bound(first + low + 1, first + std::min(high + 1, size), value);
+        }
+
+        template <typename T>
+        std::size_t intersect_galloping(const T* small, std::size_t small_size, const T* large, std::size_t large_size, T* out) noexcept
+        {
+            const T* pos = large;
+            const T* const end = large + large_size;
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < small_size; ++i)
+            {
+                pos = gallop(pos, end, small[i]);
+                if (pos == end)
+                    break;
+                out[count] = small[i];
+                count += *pos == small[i];
+            }
+            return count;
+        }
+
+        template <typename T>
+        std::size_t unite_galloping(const T* small, std::size_t small_size, const T* large, std::size_t large_size, T* out) noexcept
+        {
+            const T* pos = large;
+            const T* const end = large + large_size;
+            T* const first_out = out;
+            for (std::size_t i = 0; i < small_size; ++i)
+            {
+                const T* const next = gallop(pos, end, small[i]);
+                out = std::copy(pos, next, out);
+                pos = next;
+                if (pos == end || *pos != small[i])
+                    *out++ = small[i];
+            }
+            out = std::copy(pos, end, out);
+            return out - first_out;
+        }
+
+        // a small - each element looked up in b
+        template <typename T>
+        std::size_t subtract_large_from_small(const T* a, std::size_t a_size, const T* b, std::size_t b_size, T* out) noexcept
+        {
+            const T* pos = b;
+            const T* const end = b + b_size;
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < a_size; ++i)
+            {
+                pos = gallop(pos, end, a[i]);
+                out[count] = a[i];
+                count += pos == end || *pos != a[i];
+            }
+            return count;
+        }
+
+        // b small - the runs of a between its elements copied
+        template <typename T>
+        std::size_t subtract_small_from_large(const T* a, std::size_t a_size, const T* b, std::size_t b_size, T* out) noexcept
+        {
+            const T* pos = a;
+            const T* const end = a + a_size;
+            T* const first_out = out;
+            for (std::size_t j = 0; j < b_size && pos != end; ++j)
+            {
+                const T* const next = gallop(pos, end, b[j]);
+                out = std::copy(pos, next, out);
+                pos = next != end && *next == b[j] ? next + 1 : next;
+            }
+            out = std::copy(pos, end, out);
+            return out - first_out;
+        }
+
+#ifdef SORTED_SETS_X86
+        //////////////////////////////////////////////////////////////////////
+        // AVX2
+
+        template <typename T>
+        inline constexpr std::size_t lanes = 32 / sizeof(T);
+
+        // a bit per lane of a equal to any lane of b - b rotated in the 128-bit halves & with the halves swapped
+        template <typename T>
+        __attribute__((target("avx2"))) inline unsigned matches_avx2(__m256i a, __m256i b) noexcept
+        {
+            const __m256i swapped = _mm256_permute2x128_si256(b, b, 0x01);
+
+            if constexpr (sizeof(T) == 4)
+            {
+                __m256i eq = _mm256_or_si256(_mm256_cmpeq_epi32(a, b), _mm256_cmpeq_epi32(a, swapped));
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(a, _mm256_shuffle_epi32(b, 0x39)));
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(a, _mm256_shuffle_epi32(b, 0x4E)));
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(a, _mm256_shuffle_epi32(b, 0x93)));
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(a, _mm256_shuffle_epi32(swapped, 0x39)));
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(a, _mm256_shuffle_epi32(swapped, 0x4E)));
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(a, _mm256_shuffle_epi32(swapped, 0x93)));
+                return _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+            }
+            else
+            {
+                __m256i eq = _mm256_or_si256(_mm256_cmpeq_epi64(a, b), _mm256_cmpeq_epi64(a, swapped));
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_shuffle_epi32(b, 0x4E)));
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_shuffle_epi32(swapped, 0x4E)));
+                return _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+            }
+        }
+
+        // the lanes of x selected by mask stored to the front of out (the whole vector is stored)
+        template <typename T>
+        __attribute__((target("avx2"))) inline std::size_t store_selected_avx2(__m256i x, unsigned mask, T* out) noexcept
+        {
+            const auto& permutation = sizeof(T) == 4 ? permutation_32[mask] : permutation_64[mask];
+            const __m256i indexes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(permutation.data()));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(x, indexes));
+            return std::popcount(mask);
+        }
+
+        template <typename T>
+        __attribute__((target("avx2"))) inline __m256i load_avx2(const T* items) noexcept
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(items));
+        }
+
+        template <typename T>
+        __attribute__((target("avx2"))) std::size_t intersect_avx2(const T* a, std::size_t a_size, const T* b, std::size_t b_size, T* out) noexcept
+        {
+            constexpr std::size_t n = lanes<T>;
+
+            // the lanes of the current vector of a matched by the vectors of b so far - stored when the vector
+            // of a is replaced (no further than the vector itself - the output needs no more room than a)
+            unsigned matched = 0;
+            std::size_t i = 0, j = 0, count = 0;
+            while (i + n <= a_size && j + n <= b_size)
+            {
+                const __m256i x = load_avx2(a + i);
+                matched |= matches_avx2<T>(x, load_avx2(b + j));
+
+                const T a_last = a[i + n - 1];
+                const T b_last = b[j + n - 1];
+                if (a_last <= b_last)
+                {
+                    count += store_selected_avx2(x, matched, out + count);
+                    matched = 0;
+                    i += n;
+                }
+                j += b_last <= a_last ? n : 0;
+            }
+
+            // the matched lanes of the current vector of a - their elements of b are behind
+            for (std::size_t lane = 0; matched; ++lane, matched >>= 1)
+            {
+                if (matched & 1)
+                    out[count++] = a[i + lane];
+            }
+
+            return count + intersect_scalar(a + i, a_size - i, b + j, b_size - j, out + count);
+        }
+
+        template <typename T>
+        __attribute__((target("avx2"))) std::size_t subtract_avx2(const T* a, std::size_t a_size, const T* b, std::size_t b_size, T* out) noexcept
+        {
+            constexpr std::size_t n = lanes<T>;
+            constexpr unsigned all_lanes = (1u << n) - 1;
+
+            // the lanes of the current vector of a matched by the vectors of b so far - the unmatched ones are stored
+            // when the vector of a is replaced
+            unsigned matched = 0;
+            std::size_t i = 0, j = 0, count = 0;
+            while (i + n <= a_size && j + n <= b_size)
+            {
+                const __m256i x = load_avx2(a + i);
+                matched |= matches_avx2<T>(x, load_avx2(b + j));
+
+                const T a_last = a[i + n - 1];
+                const T b_last = b[j + n - 1];
+                if (a_last <= b_last)
+                {
+                    count += store_selected_avx2(x, ~matched & all_lanes, out + count);
+                    matched = 0;
+                    i += n;
+                }
+                j += b_last <= a_last ? n : 0;
+            }
+
+            // the rest of the current vector of a - its matched lanes skipped
+            if (matched)
+            {
+                for (const std::size_t end = i + n; i < end; ++i, matched >>= 1)
+                {
+                    if (matched & 1)
+                        continue;
+                    while (j < b_size && b[j] < a[i])
+                        ++j;
+                    if (j == b_size || b[j] != a[i])
+                        out[count++] = a[i];
+                }
+            }
+
+            return count + subtract_scalar(a + i, a_size - i, b + j, b_size - j, out + count);
+        }
+
+        // a bitonic sequence of 8 sorted - compare & exchange at the distances 4, 2, 1
+        __attribute__((target("avx2"))) inline __m256i bitonic_sort_avx2(__m256i x) noexcept
+        {
+            __m256i other = _mm256_permute2x128_si256(x, x, 0x01);
+            x = _mm256_blend_epi32(_mm256_min_epu32(x, other), _mm256_max_epu32(x, other), 0xF0);
+            other = _mm256_shuffle_epi32(x, 0x4E);
+            x = _mm256_blend_epi32(_mm256_min_epu32(x, other), _mm256_max_epu32(x, other), 0xCC);
+            other = _mm256_shuffle_epi32(x, 0xB1);
+            return _mm256_blend_epi32(_mm256_min_epu32(x, other), _mm256_max_epu32(x, other), 0xAA);
+        }
+
+        // two sorted vectors merged: low - the 8 smallest, high - the 8 largest, both sorted
+        __attribute__((target("avx2"))) inline void merge_avx2(__m256i a, __m256i b, __m256i& low, __m256i& high) noexcept
+        {
+            const __m256i reversed = _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+            low = bitonic_sort_avx2(_mm256_min_epu32(a, reversed));
+            high = bitonic_sort_avx2(_mm256_max_epu32(a, reversed));
+        }
+
+        // a sorted vector stored without the lanes equal to the previous one (the first lane compared with last)
+        __attribute__((target("avx2"))) inline std::size_t store_unique_avx2(__m256i x, std::uint32_t last, std::uint32_t* out) noexcept
+        {
+            __m256i previous = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6));
+            previous = _mm256_blend_epi32(previous, _mm256_set1_epi32(static_cast<int>(last)), 0x01);
+            const unsigned duplicates = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, previous)));
+            return store_selected_avx2(x, ~duplicates & 0xFF, out);
+        }
+
+        __attribute__((target("avx2"))) inline std::uint32_t last_lane_avx2(__m256i x) noexcept
+        {
+            return static_cast<std::uint32_t>(_mm256_extract_epi32(x, 7));
+        }
+
+        // the 8 merged elements held back, the rest of a & b - a three-way merge until the held elements are
+        // stored, then the scalar union (the element equal to the last stored one skipped)
+        inline std::size_t unite_tail(const std::uint32_t* pending, const std::uint32_t* a, std::size_t a_size, const std::uint32_t* b, std::size_t b_size,
+            std::uint32_t* out, std::uint32_t last) noexcept
+        {
+            std::size_t h = 0, i = 0, j = 0, count = 0;
+            auto store = [&](std::uint32_t x) {
+                out[count] = x;
+                count += x != last;
+                last = x;
+            };
+
+            while (h < 8)
+            {
+                const std::uint32_t x = pending[h];
+                if (i < a_size && a[i] < x && (j == b_size || a[i] <= b[j]))
+                    store(a[i++]);
+                else if (j < b_size && b[j] < x)
+                    store(b[j++]);
+                else
+                    store(pending[h++]);
+            }
+
+            i += i < a_size && a[i] == last;
+            j += j < b_size && b[j] == last;
+            return count + unite_scalar(a + i, a_size - i, b + j, b_size - j, out + count);
+        }
+
+        __attribute__((target("avx2"))) inline std::size_t unite_avx2(const std::uint32_t* a, std::size_t a_size, const std::uint32_t* b, std::size_t b_size, std::uint32_t* out) noexcept
+        {
+            if (a_size < 8 || b_size < 8)
+                return unite_scalar(a, a_size, b, b_size, out);
+
+            __m256i low, high;
+            merge_avx2(load_avx2(a), load_avx2(b), low, high);
+            std::size_t i = 8, j = 8;
+
+            // ~x differs from x - the first element is stored
+            std::size_t count = store_unique_avx2(low, ~static_cast<std::uint32_t>(_mm256_cvtsi256_si32(low)), out);
+            std::uint32_t last = last_lane_avx2(low);
+
+            // the next vector taken from the set with the smaller next element - the lower half of the merge is
+            // not greater than any element to come
+            while (i + 8 <= a_size && j + 8 <= b_size)
+            {
+                __m256i next;
+                if (a[i] <= b[j])
+                {
+                    next = load_avx2(a + i);
+                    i += 8;
+                }
+                else
+                {
+                    next = load_avx2(b + j);
+                    j += 8;
+                }
+
+                merge_avx2(next, high, low, high);
+                count += store_unique_avx2(low, last, out + count);
+                last = last_lane_avx2(low);
+            }
+
+            alignas(32) std::uint32_t pending[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(pending), high);
+            return count + unite_tail(pending, a + i, a_size - i, b + j, b_size - j, out + count, last);
+        }
+
+        template <typename T>
+        SetKernel<T> select_kernel(SetKernel<T> avx2, SetKernel<T> scalar) noexcept
+        {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? avx2 : scalar;
+        }
+
+        template <typename T>
+        inline const SetKernel<T> intersect_kernel = select_kernel<T>(&intersect_avx2<T>, &intersect_scalar<T>);
+
+        template <typename T>
+        inline const SetKernel<T> subtract_kernel = select_kernel<T>(&subtract_avx2<T>, &subtract_scalar<T>);
+
+        // no unsigned 64-bit min/max in AVX2 - the 64-bit union is scalar
+        template <typename T>
+        SetKernel<T> select_unite_kernel() noexcept
+        {
+            if constexpr (sizeof(T) == 4)
+                return select_kernel<T>(&unite_avx2, &unite_scalar<T>);
+            else
+                return &unite_scalar<T>;
+        }
+
+        template <typename T>
+        inline const SetKernel<T> unite_kernel = select_unite_kernel<T>();
+#else
+        template <typename T>
+        inline constexpr SetKernel<T> intersect_kernel = &intersect_scalar<T>;
+
+        template <typename T>
+        inline constexpr SetKernel<T> subtract_kernel = &subtract_scalar<T>;
+
+        template <typename T>
+        inline constexpr SetKernel<T> unite_kernel = &unite_scalar<T>;
+#endif
+
+        inline bool skewed(std::size_t small_size, std::size_t large_size) noexcept
+        {
+            return large_size / galloping_ratio >= small_size;
+        }
+    } // namespace Detail
+
+    // the elements of both a & b stored to the front of output (output.size() >= min(a.size(), b.size()));
+    // returns the number of them
+    template <SetElement T>
+    std::size_t set_intersection(std::span<const T> a, std::span<const T> b, std::span<T> output) noexcept
+    {
+        if (a.size() > b.size())
+            std::swap(a, b);
+        assert(output.size() >= a.size());
+
+        if (a.empty())
+            return 0;
+        if (Detail::skewed(a.size(), b.size()))
+            return Detail::intersect_galloping(a.data(), a.size(), b.data(), b.size(), output.data());
+        return Detail::intersect_kernel<T>(a.data(), a.size(), b.data(), b.size(), output.data());
+    }
+
+    // the elements of a or b (output.size() >= a.size() + b.size())
+    template <SetElement T>
+    std::size_t set_union(std::span<const T> a, std::span<const T> b, std::span<T> output) noexcept
+    {
+        assert(output.size() >= a.size() + b.size());
+
+        if (Detail::skewed(a.size(), b.size()))
+            return Detail::unite_galloping(a.data(), a.size(), b.data(), b.size(), output.data());
+        if (Detail::skewed(b.size(), a.size()))
+            return Detail::unite_galloping(b.data(), b.size(), a.data(), a.size(), output.data());
+        return Detail::unite_kernel<T>(a.data(), a.size(), b.data(), b.size(), output.data());
+    }
+
+    // the elements of a that are not in b (output.size() >= a.size())
+    template <SetElement T>
+    std::size_t set_difference(std::span<const T> a, std::span<const T> b, std::span<T> output) noexcept
+    {
+        assert(output.size() >= a.size());
+
+        if (Detail::skewed(a.size(), b.size()))
+            return Detail::subtract_large_from_small(a.data(), a.size(), b.data(), b.size(), output.data());
+        if (Detail::skewed(b.size(), a.size()))
+            return Detail::subtract_small_from_large(a.data(), a.size(), b.data(), b.size(), output.data());
+        return Detail::subtract_kernel<T>(a.data(), a.size(), b.data(), b.size(), output.data());
+    }
+
+    // the results appended to output (room for the largest result is made first)
+    template <SetElement T>
+    void set_intersection(std::span<const T> a, std::span<const T> b, std::vector<T>& output)
+    {
+        const std::size_t offset = output.size();
+        output.resize(offset + std::min(a.size(), b.size()));
+        output.resize(offset + set_intersection(a, b, std::span{output}.subspan(offset)));
+    }
+
+    template <SetElement T>
+    void set_union(std::span<const T> a, std::span<const T> b, std::vector<T>& output)
+    {
+        const std::size_t offset = output.size();
+        output.resize(offset + a.size() + b.size());
+        output.resize(offset + set_union(a, b, std::span{output}.subspan(offset)));
+    }
+
+    template <SetElement T>
+    void set_difference(std::span<const T> a, std::span<const T> b, std::vector<T>& output)
+    {
+        const std::size_t offset = output.size();
+        output.resize(offset + a.size());
+        output.resize(offset + set_difference(a, b, std::span{output}.subspan(offset)));
+    }
+} // namespace Simd
+
+#endif
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random.hpp>
+#include <span>
+#include <vector>
+
+#include "stream_compaction.hpp"
+
+namespace
+{
+    template <typename T>
+    std::vector<T> random_values(helpers::random::PCG& rnd, std::size_t size)
+    {
+        std::vector<T> values(size);
+        for (T& value : values)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                value = static_cast<T>(static_cast<std::int32_t>(rnd()) % 1000) / 10;
+            else
+                value = static_cast<T>((std::uint64_t{rnd()} << 32) | rnd());
+        }
+        return values;
+    }
+
+    // NaNs compare equal to each other
+    template <typename T>
+    bool same_values(const std::vector<T>& lhs, const std::vector<T>& rhs)
+    {
+        return std::ranges::equal(lhs, rhs, [](T x, T y) { return x == y || (x != x && y != y); });
+    }
+
+    template <typename T, Simd::Comparison Op>
+    std::vector<T> copy_if_with_std(const std::vector<T>& input, Simd::CompareWith<T, Op> pred)
+    {
+        std::vector<T> result;
+        std::ranges::copy_if(input, std::back_inserter(result), pred);
+        return result;
+    }
+
+    // every kernel the CPU can run gives the result of std::ranges::copy_if
+    template <typename T, Simd::Comparison Op>
+    void check_kernels(const std::vector<T>& input, Simd::CompareWith<T, Op> pred)
+    {
+        const std::vector<T> expected = copy_if_with_std(input, pred);
+
+        std::vector<Simd::Detail::CopyIfKernel<T, Op>> kernels{&Simd::Detail::copy_if_scalar<T, Op>};
+#ifdef STREAM_COMPACTION_X86
+        if (__builtin_cpu_supports("avx2"))
+            kernels.push_back(&Simd::Detail::copy_if_avx2<T, Op>);
+        if constexpr (sizeof(T) == 4 || sizeof(T) == 8)
+        {
+            if (__builtin_cpu_supports("avx512f"))
+                kernels.push_back(&Simd::Detail::copy_if_avx512<T, Op>);
+        }
+#endif
+
+        for (auto kernel : kernels)
+        {
+            std::vector<T> output(input.size());
+            output.resize(kernel(input.data(), input.size(), output.data(), pred.value));
+            CHECK(same_values(output, expected));
+        }
+
+        std::vector<T> appended;
+        Simd::copy_if(std::span{input}, appended, pred);
+        CHECK(same_values(appended, expected));
+    }
+
+    template <typename T>
+    void check_all_comparisons(const std::vector<T>& input, T value)
+    {
+        check_kernels(input, Simd::less_than(value));
+        check_kernels(input, Simd::less_equal(value));
+        check_kernels(input, Simd::greater_than(value));
+        check_kernels(input, Simd::greater_equal(value));
+        check_kernels(input, Simd::equal_to(value));
+        check_kernels(input, Simd::not_equal_to(value));
+    }
+
+    template <typename T>
+    void check_type()
+    {
+        helpers::random::PCG rnd{static_cast<std::uint64_t>(sizeof(T) * 7 + std::is_signed_v<T>)};
+
+        for (std::size_t size : {0, 1, 7, 8, 15, 16, 17, 31, 33, 64, 100, 1000})
+        {
+            std::vector<T> input = random_values<T>(rnd, size);
+            const T pivot = size > 0 ? input[size / 2] : T{};
+            check_all_comparisons(input, pivot); // the value occurs in the input - == & != select something
+            check_all_comparisons(input, T{});
+            check_all_comparisons(input, std::numeric_limits<T>::max());
+            check_all_comparisons(input, std::numeric_limits<T>::lowest());
+        }
+    }
+} // namespace
+
+TEST_CASE("stream compaction - copy_if with comparison to a constant")
+{
+    SECTION("integers")
+    {
+        check_type<std::int8_t>();
+        check_type<std::uint8_t>();
+        check_type<char>();
+        check_type<std::int16_t>();
+        check_type<std::uint16_t>();
+        check_type<std::int32_t>();
+        check_type<std::uint32_t>();
+        check_type<std::int64_t>();
+        check_type<std::uint64_t>();
+    }
+
+    SECTION("floating point")
+    {
+        check_type<float>();
+        check_type<double>();
+    }
+
+    SECTION("NaN is selected only by !=")
+    {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        std::vector<float> input(37, 1.0f);
+        for (std::size_t i = 0; i < input.size(); i += 3)
+            input[i] = nan;
+
+        check_all_comparisons(input, 1.0f);
+
+        std::vector<float> output(input.size());
+        CHECK(Simd::copy_if(std::span<const float>{input}, std::span{output}, Simd::not_equal_to(1.0f)) == 13);
+        CHECK(Simd::copy_if(std::span<const float>{input}, std::span{output}, Simd::greater_equal(0.0f)) == 24);
+    }
+
+    SECTION("unsigned values are compared as unsigned")
+    {
+        const std::vector<std::uint32_t> input = {0, 1, 0x7FFF'FFFF, 0x8000'0000, 0xFFFF'FFFF, 2, 3, 4, 5};
+        std::vector<std::uint32_t> output(input.size());
+
+        const std::size_t count = Simd::copy_if(std::span{input}, std::span{output}, Simd::greater_than(0x7FFF'FFFFu));
+        output.resize(count);
+        CHECK(output == std::vector<std::uint32_t>{0x8000'0000, 0xFFFF'FFFF});
+    }
+
+    SECTION("appends to a vector")
+    {
+        std::vector<int> output = {-1, -2};
+        const std::vector<int> input = {1, 5, 2, 6, 3, 7};
+        Simd::copy_if(std::span{input}, output, Simd::greater_than(4));
+        CHECK(output == std::vector{-1, -2, 5, 6, 7});
+    }
+}
+
+TEST_CASE("stream compaction - benchmarks", "[.][benchmark]")
+{
+    helpers::random::PCG rnd{2024};
+    const std::vector<std::int32_t> numbers = random_values<std::int32_t>(rnd, 1'000'000); // > 0 for half of them
+    const std::vector<std::int8_t> bytes = random_values<std::int8_t>(rnd, 1'000'000);
+    const std::vector<float> floats = random_values<float>(rnd, 1'000'000);
+
+    std::vector<std::int32_t> numbers_out(numbers.size());
+    std::vector<std::int8_t> bytes_out(bytes.size());
+    std::vector<float> floats_out(floats.size());
+
+    // a branch per element - mispredicted for half of them
+    auto copy_if_branchy = [](const auto& input, auto& output, auto value) {
+        std::size_t count = 0;
+        for (auto x : input)
+            if (x > value)
+                output[count++] = x;
+        return count;
+    };
+
+    BENCHMARK("int32 - std::ranges::copy_if to back_inserter")
+    {
+        std::vector<std::int32_t> output;
+        output.reserve(numbers.size());
+        std::ranges::copy_if(numbers, std::back_inserter(output), [](std::int32_t x) { return x > 0; });
+        return output.size();
+    };
+
+    BENCHMARK("int32 - branchy loop")
+    {
+        return copy_if_branchy(numbers, numbers_out, 0);
+    };
+
+    BENCHMARK("int32 - branchless scalar")
+    {
+        return Simd::Detail::copy_if_scalar<std::int32_t, Simd::Comparison::greater>(numbers.data(), numbers.size(), numbers_out.data(), 0);
+    };
+
+    BENCHMARK("int32 - Simd::copy_if")
+    {
+        return Simd::copy_if(std::span{numbers}, std::span{numbers_out}, Simd::greater_than(0));
+    };
+
+    BENCHMARK("int8 - branchy loop")
+    {
+        return copy_if_branchy(bytes, bytes_out, std::int8_t{0});
+    };
+
+    BENCHMARK("int8 - Simd::copy_if")
+    {
+        return Simd::copy_if(std::span{bytes}, std::span{bytes_out}, Simd::greater_than(std::int8_t{0}));
+    };
+
+    BENCHMARK("float - branchy loop")
+    {
+        return copy_if_branchy(floats, floats_out, 0.0f);
+    };
+
+    BENCHMARK("float - Simd::copy_if")
+    {
+        return Simd::copy_if(std::span{floats}, std::span{floats_out}, Simd::greater_than(0.0f));
+    };
+}
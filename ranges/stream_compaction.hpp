@@ -0,0 +1,450 @@
+#ifndef STREAM_COMPACTION_HPP
+#define STREAM_COMPACTION_HPP
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define STREAM_COMPACTION_X86 1
+#endif
+
+// Stream compaction - copy_if for contiguous ranges of 8/16/32/64-bit integers & floats with a predicate
+// comparing each element with a constant (Simd::greater_than(0), Simd::equal_to(x), ...):
+//   * AVX-512 - vpcompress (32/64-bit elements)
+//   * AVX2    - a whole vector compared at once, the selected elements moved to the front with a shuffle
+//               taken from a lookup table indexed by the comparison mask, the vector stored as a whole
+//   * scalar  - every element stored, the output position advanced by the result of the comparison
+// No path branches on the data, so a 50/50 predicate costs no branch misses. The whole vectors are stored
+// past the last selected element - the output must have room for all of the input elements.
+namespace Simd
+{
+    enum class Comparison
+    {
+        less,
+        less_equal,
+        greater,
+        greater_equal,
+        equal,
+        not_equal
+    };
+
+    template <typename T>
+    concept Compactable = (std::integral<T> && !std::same_as<T, bool> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8))
+        || std::same_as<T, float> || std::same_as<T, double>;
+
+    template <Compactable T, Comparison Op>
+    struct CompareWith
+    {
+        T value;
+
+        constexpr bool operator()(T x) const noexcept
+        {
+            if constexpr (Op == Comparison::less)
+                return x < value;
+            else if constexpr (Op == Comparison::less_equal)
+                return x <= value;
+            else if constexpr (Op == Comparison::greater)
+                return x > value;
+            else if constexpr (Op == Comparison::greater_equal)
+                return x >= value;
+            else if constexpr (Op == Comparison::equal)
+                return x == value;
+            else
+                return x != value;
+        }
+    };
+
+    template <Compactable T>
+    constexpr CompareWith<T, Comparison::less> less_than(T value) noexcept { return {value}; }
+
+    template <Compactable T>
+    constexpr CompareWith<T, Comparison::less_equal> less_equal(T value) noexcept { return {value}; }
+
+    template <Compactable T>
+    constexpr CompareWith<T, Comparison::greater> greater_than(T value) noexcept { return {value}; }
+
+    template <Compactable T>
+    constexpr CompareWith<T, Comparison::greater_equal> greater_equal(T value) noexcept { return {value}; }
+
+    template <Compactable T>
+    constexpr CompareWith<T, Comparison::equal> equal_to(T value) noexcept { return {value}; }
+
+    template <Compactable T>
+    constexpr CompareWith<T, Comparison::not_equal> not_equal_to(T value) noexcept { return {value}; }
+
+    namespace Detail
+    {
+        template <typename T, Comparison Op>
+        using CopyIfKernel = std::size_t (*)(const T*, std::size_t, T*, T) noexcept;
+
+        template <typename T, Comparison Op>
+        std::size_t copy_if_scalar(const T* in, std::size_t size, T* out, T value) noexcept
+        {
+            const CompareWith<T, Op> pred{value};
+
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out[count] = in[i];
+                count += pred(in[i]);
+            }
+            return count;
+        }
+
+#ifdef STREAM_COMPACTION_X86
+        //////////////////////////////////////////////////////////////////////
+        // lookup tables: for every comparison mask the indexes of the selected lanes, in order
+
+        // vpermd indexes - 8 x 32-bit lanes
+        inline constexpr auto permutation_32 = [] {
+            std::array<std::array<std::int32_t, 8>, 256> lut{};
+            for (unsigned mask = 0; mask < 256; ++mask)
+            {
+                unsigned selected = 0;
+                for (int lane = 0; lane < 8; ++lane)
+                    if (mask & (1u << lane))
+                        lut[mask][selected++] = lane;
+            }
+            return lut;
+        }();
+
+        // vpermd indexes - 4 x 64-bit lanes (as pairs of 32-bit ones)
+        inline constexpr auto permutation_64 = [] {
+            std::array<std::array<std::int32_t, 8>, 16> lut{};
+            for (unsigned mask = 0; mask < 16; ++mask)
+            {
+                unsigned selected = 0;
+                for (int lane = 0; lane < 4; ++lane)
+                    if (mask & (1u << lane))
+                    {
+                        lut[mask][2 * selected] = 2 * lane;
+                        lut[mask][2 * selected + 1] = 2 * lane + 1;
+                        ++selected;
+                    }
+            }
+            return lut;
+        }();
+
+        // pshufb indexes - 8 x 8-bit lanes
+        inline constexpr auto shuffle_8 = [] {
+            std::array<std::array<std::uint8_t, 8>, 256> lut{};
+            for (unsigned mask = 0; mask < 256; ++mask)
+            {
+                unsigned selected = 0;
+                for (std::uint8_t lane = 0; lane < 8; ++lane)
+                    if (mask & (1u << lane))
+                        lut[mask][selected++] = lane;
+            }
+            return lut;
+        }();
+
+        // pshufb indexes - 8 x 16-bit lanes
+        inline constexpr auto shuffle_16 = [] {
+            std::array<std::array<std::uint8_t, 16>, 256> lut{};
+            for (unsigned mask = 0; mask < 256; ++mask)
+            {
+                unsigned selected = 0;
+                for (std::uint8_t lane = 0; lane < 8; ++lane)
+                    if (mask & (1u << lane))
+                    {
+                        lut[mask][2 * selected] = 2 * lane;
+                        lut[mask][2 * selected + 1] = 2 * lane + 1;
+                        ++selected;
+                    }
+            }
+            return lut;
+        }();
+
+        //////////////////////////////////////////////////////////////////////
+        // AVX2 - comparison masks (a bit per lane)
+
+        // signed integer compares only - unsigned values are compared with their sign bits flipped
+        template <typename T>
+        constexpr T sign_bit() noexcept
+        {
+            return static_cast<T>(std::make_unsigned_t<T>{1} << (8 * sizeof(T) - 1));
+        }
+
+        template <typename T>
+        __attribute__((target("avx2"))) inline __m256i broadcast_avx2(T value) noexcept
+        {
+            if constexpr (std::is_unsigned_v<T>)
+                value ^= sign_bit<T>();
+
+            if constexpr (sizeof(T) == 1)
+                return _mm256_set1_epi8(static_cast<char>(value));
+            else if constexpr (sizeof(T) == 2)
+                return _mm256_set1_epi16(static_cast<short>(value));
+            else if constexpr (sizeof(T) == 4)
+                return _mm256_set1_epi32(static_cast<int>(value));
+            else
+                return _mm256_set1_epi64x(static_cast<long long>(value));
+        }
+
+        template <typename T>
+        __attribute__((target("avx2"))) inline __m256i greater_avx2(__m256i a, __m256i b) noexcept
+        {
+            if constexpr (sizeof(T) == 1)
+                return _mm256_cmpgt_epi8(a, b);
+            else if constexpr (sizeof(T) == 2)
+                return _mm256_cmpgt_epi16(a, b);
+            else if constexpr (sizeof(T) == 4)
+                return _mm256_cmpgt_epi32(a, b);
+            else
+                return _mm256_cmpgt_epi64(a, b);
+        }
+
+        template <typename T>
+        __attribute__((target("avx2"))) inline __m256i equal_avx2(__m256i a, __m256i b) noexcept
+        {
+            if constexpr (sizeof(T) == 1)
+                return _mm256_cmpeq_epi8(a, b);
+            else if constexpr (sizeof(T) == 2)
+                return _mm256_cmpeq_epi16(a, b);
+            else if constexpr (sizeof(T) == 4)
+                return _mm256_cmpeq_epi32(a, b);
+            else
+                return _mm256_cmpeq_epi64(a, b);
+        }
+
+        // all bits set in the lanes that satisfy `x Op value`
+        template <typename T, Comparison Op>
+        __attribute__((target("avx2"))) inline __m256i compare_avx2(__m256i x, __m256i value) noexcept
+        {
+            if constexpr (std::is_unsigned_v<T>)
+                x = _mm256_xor_si256(x, broadcast_avx2<T>(0)); // 0 ^ sign bit == sign bit
+
+            const __m256i all_ones = _mm256_set1_epi32(-1);
+
+            if constexpr (Op == Comparison::less)
+                return greater_avx2<T>(value, x);
+            else if constexpr (Op == Comparison::less_equal)
+                return _mm256_xor_si256(greater_avx2<T>(x, value), all_ones);
+            else if constexpr (Op == Comparison::greater)
+                return greater_avx2<T>(x, value);
+            else if constexpr (Op == Comparison::greater_equal)
+                return _mm256_xor_si256(greater_avx2<T>(value, x), all_ones);
+            else if constexpr (Op == Comparison::equal)
+                return equal_avx2<T>(x, value);
+            else
+                return _mm256_xor_si256(equal_avx2<T>(x, value), all_ones);
+        }
+
+        // _CMP_* predicates with the semantics of the C++ operators (an unordered comparison only for !=)
+        template <Comparison Op>
+        inline constexpr int float_predicate = Op == Comparison::less ? _CMP_LT_OQ
+            : Op == Comparison::less_equal                            ? _CMP_LE_OQ
+            : Op == Comparison::greater                               ? _CMP_GT_OQ
+            : Op == Comparison::greater_equal                         ? _CMP_GE_OQ
+            : Op == Comparison::equal                                 ? _CMP_EQ_OQ
+                                                                      : _CMP_NEQ_UQ;
+
+        //////////////////////////////////////////////////////////////////////
+        // AVX2 kernels
+
+        template <typename T, Comparison Op>
+        __attribute__((target("avx2"))) std::size_t copy_if_avx2(const T* in, std::size_t size, T* out, T value) noexcept
+        {
+            constexpr std::size_t lanes = sizeof(T) == 2 ? 8 : 32 / sizeof(T); // 16-bit elements - 128-bit steps
+
+            std::size_t count = 0;
+            std::size_t i = 0;
+
+            if constexpr (std::same_as<T, float>)
+            {
+                const __m256 values = _mm256_set1_ps(value);
+                for (; i + lanes <= size; i += lanes)
+                {
+                    const __m256 x = _mm256_loadu_ps(in + i);
+                    const auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(x, values, float_predicate<Op>)));
+                    const __m256i permutation = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(permutation_32[mask].data()));
+                    _mm256_storeu_ps(out + count, _mm256_permutevar8x32_ps(x, permutation));
+                    count += std::popcount(mask);
+                }
+            }
+            else if constexpr (std::same_as<T, double>)
+            {
+                const __m256d values = _mm256_set1_pd(value);
+                for (; i + lanes <= size; i += lanes)
+                {
+                    const __m256d x = _mm256_loadu_pd(in + i);
+                    const auto mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(x, values, float_predicate<Op>)));
+                    const __m256i permutation = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(permutation_64[mask].data()));
+                    _mm256_storeu_pd(out + count, _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(x), permutation)));
+                    count += std::popcount(mask);
+                }
+            }
+            else if constexpr (sizeof(T) == 1)
+            {
+                const __m256i values = broadcast_avx2(value);
+                for (; i + lanes <= size; i += lanes)
+                {
+                    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                    const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(compare_avx2<T, Op>(x, values)));
+
+                    for (unsigned group = 0; group < 4; ++group) // 8 bytes at a time - the table would be too big for more
+                    {
+                        const unsigned group_mask = (mask >> (8 * group)) & 0xFF;
+                        const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i + 8 * group));
+                        const __m128i shuffle = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(shuffle_8[group_mask].data()));
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + count), _mm_shuffle_epi8(bytes, shuffle));
+                        count += std::popcount(group_mask);
+                    }
+                }
+            }
+            else if constexpr (sizeof(T) == 2)
+            {
+                const __m128i values = _mm256_castsi256_si128(broadcast_avx2(value));
+                for (; i + lanes <= size; i += lanes)
+                {
+                    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                    const __m128i selected = _mm256_castsi256_si128(compare_avx2<T, Op>(_mm256_castsi128_si256(x), _mm256_castsi128_si256(values)));
+                    const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_packs_epi16(selected, _mm_setzero_si128())));
+                    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle_16[mask].data()));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), _mm_shuffle_epi8(x, shuffle));
+                    count += std::popcount(mask);
+                }
+            }
+            else
+            {
+                const __m256i values = broadcast_avx2(value);
+                for (; i + lanes <= size; i += lanes)
+                {
+                    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                    const __m256i selected = compare_avx2<T, Op>(x, values);
+
+                    unsigned mask;
+                    __m256i permutation;
+                    if constexpr (sizeof(T) == 4)
+                    {
+                        mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(selected)));
+                        permutation = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(permutation_32[mask].data()));
+                    }
+                    else
+                    {
+                        mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(selected)));
+                        permutation = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(permutation_64[mask].data()));
+                    }
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count), _mm256_permutevar8x32_epi32(x, permutation));
+                    count += std::popcount(mask);
+                }
+            }
+
+            return count + copy_if_scalar<T, Op>(in + i, size - i, out + count, value);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // AVX-512 kernels (32/64-bit elements - the 8/16-bit compress needs VBMI2)
+
+        template <Comparison Op>
+        inline constexpr int int_predicate = Op == Comparison::less ? _MM_CMPINT_LT
+            : Op == Comparison::less_equal                          ? _MM_CMPINT_LE
+            : Op == Comparison::greater                             ? _MM_CMPINT_NLE
+            : Op == Comparison::greater_equal                       ? _MM_CMPINT_NLT
+            : Op == Comparison::equal                               ? _MM_CMPINT_EQ
+                                                                    : _MM_CMPINT_NE;
+
+        template <typename T, Comparison Op>
+        __attribute__((target("avx512f"))) std::size_t copy_if_avx512(const T* in, std::size_t size, T* out, T value) noexcept
+        {
+            static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+            constexpr std::size_t lanes = 64 / sizeof(T);
+
+            std::size_t count = 0;
+            std::size_t i = 0;
+            for (; i + lanes <= size; i += lanes)
+            {
+                if constexpr (std::same_as<T, float>)
+                {
+                    const __m512 x = _mm512_loadu_ps(in + i);
+                    const __mmask16 mask = _mm512_cmp_ps_mask(x, _mm512_set1_ps(value), float_predicate<Op>);
+                    _mm512_storeu_ps(out + count, _mm512_maskz_compress_ps(mask, x));
+                    count += std::popcount(static_cast<unsigned>(mask));
+                }
+                else if constexpr (std::same_as<T, double>)
+                {
+                    const __m512d x = _mm512_loadu_pd(in + i);
+                    const __mmask8 mask = _mm512_cmp_pd_mask(x, _mm512_set1_pd(value), float_predicate<Op>);
+                    _mm512_storeu_pd(out + count, _mm512_maskz_compress_pd(mask, x));
+                    count += std::popcount(static_cast<unsigned>(mask));
+                }
+                else if constexpr (sizeof(T) == 4)
+                {
+                    const __m512i x = _mm512_loadu_si512(in + i);
+                    const __m512i values = _mm512_set1_epi32(static_cast<int>(value));
+                    __mmask16 mask;
+                    if constexpr (std::is_signed_v<T>)
+                        mask = _mm512_cmp_epi32_mask(x, values, int_predicate<Op>);
+                    else
+                        mask = _mm512_cmp_epu32_mask(x, values, int_predicate<Op>);
+                    _mm512_storeu_si512(out + count, _mm512_maskz_compress_epi32(mask, x));
+                    count += std::popcount(static_cast<unsigned>(mask));
+                }
+                else
+                {
+                    const __m512i x = _mm512_loadu_si512(in + i);
+                    const __m512i values = _mm512_set1_epi64(static_cast<long long>(value));
+                    __mmask8 mask;
+                    if constexpr (std::is_signed_v<T>)
+                        mask = _mm512_cmp_epi64_mask(x, values, int_predicate<Op>);
+                    else
+                        mask = _mm512_cmp_epu64_mask(x, values, int_predicate<Op>);
+                    _mm512_storeu_si512(out + count, _mm512_maskz_compress_epi64(mask, x));
+                    count += std::popcount(static_cast<unsigned>(mask));
+                }
+            }
+
+            return count + copy_if_scalar<T, Op>(in + i, size - i, out + count, value);
+        }
+
+        template <typename T, Comparison Op>
+        CopyIfKernel<T, Op> select_copy_if() noexcept
+        {
+            __builtin_cpu_init();
+            if constexpr (sizeof(T) == 4 || sizeof(T) == 8)
+            {
+                if (__builtin_cpu_supports("avx512f"))
+                    return &copy_if_avx512<T, Op>;
+            }
+            if (__builtin_cpu_supports("avx2"))
+                return &copy_if_avx2<T, Op>;
+            return &copy_if_scalar<T, Op>;
+        }
+
+        template <typename T, Comparison Op>
+        inline const CopyIfKernel<T, Op> copy_if_kernel = select_copy_if<T, Op>();
+#else
+        template <typename T, Comparison Op>
+        inline constexpr CopyIfKernel<T, Op> copy_if_kernel = &copy_if_scalar<T, Op>;
+#endif
+    } // namespace Detail
+
+    // copies the elements satisfying pred to the front of output (output.size() >= input.size() - the vectors
+    // are stored whole); returns the number of the copied elements
+    template <Compactable T, Comparison Op>
+    std::size_t copy_if(std::span<const T> input, std::span<T> output, CompareWith<T, Op> pred) noexcept
+    {
+        assert(output.size() >= input.size());
+        return Detail::copy_if_kernel<T, Op>(input.data(), input.size(), output.data(), pred.value);
+    }
+
+    // appends the elements satisfying pred to output (room for all of the input is made first)
+    template <Compactable T, Comparison Op>
+    void copy_if(std::span<const T> input, std::vector<T>& output, CompareWith<T, Op> pred)
+    {
+        const std::size_t offset = output.size();
+        output.resize(offset + input.size());
+        output.resize(offset + copy_if(input, std::span{output}.subspan(offset), pred));
+    }
+} // namespace Simd
+
+#endif
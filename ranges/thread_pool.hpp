@@ -0,0 +1,209 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Work-stealing thread pool for fork-join parallelism:
+//  * every worker has its own deque - it pushes & pops at the back (the most recent task, still in cache),
+//    idle workers steal from the front of the other deques (the oldest, usually the biggest piece of work)
+//  * a thread waiting for a TaskGroup runs pending tasks instead of blocking, so nested groups cannot deadlock
+namespace par
+{
+    class ThreadPool
+    {
+    public:
+        using Task = std::move_only_function<void()>;
+
+        explicit ThreadPool(std::size_t threads_count = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            queues_.reserve(threads_count);
+            for (std::size_t i = 0; i < threads_count; ++i)
+                queues_.push_back(std::make_unique<WorkQueue>());
+
+            workers_.reserve(threads_count);
+            for (std::size_t i = 0; i < threads_count; ++i)
+                workers_.emplace_back([this, i](std::stop_token stop) { run_worker(stop, i); });
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool()
+        {
+            for (std::jthread& worker : workers_)
+                worker.request_stop();
+            {
+                std::lock_guard lk{mtx_sleep_};
+            }
+            cv_sleep_.notify_all();
+        }
+
+        // the pool shared by the par:: algorithms
+        static ThreadPool& global()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        std::size_t size() const noexcept { return workers_.size(); }
+
+        void submit(Task task)
+        {
+            // a worker keeps the tasks it spawns - the others steal them if they are idle
+            const std::size_t index = current_pool_ == this ? current_index_ : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+            {
+                std::lock_guard lk{queues_[index]->mtx};
+                queues_[index]->tasks.push_back(std::move(task));
+            }
+
+            if (pending_.fetch_add(1, std::memory_order_release) < workers_.size())
+            {
+                std::lock_guard lk{mtx_sleep_}; // no wake-up is lost between a worker's check and its wait
+                cv_sleep_.notify_one();
+            }
+        }
+
+        // runs one pending task (own queue first, then stolen) - false if there was none
+        bool try_run_one()
+        {
+            Task task;
+            if (!pop_task(task))
+                return false;
+
+            task();
+            return true;
+        }
+
+    private:
+        struct WorkQueue
+        {
+            std::mutex mtx;
+            std::deque<Task> tasks;
+        };
+
+        bool pop_task(Task& task)
+        {
+            if (pending_.load(std::memory_order_acquire) == 0)
+                return false;
+
+            const bool is_worker = current_pool_ == this;
+            const std::size_t start = is_worker ? current_index_ : next_queue_.load(std::memory_order_relaxed);
+
+            for (std::size_t i = 0; i < queues_.size(); ++i)
+            {
+                WorkQueue& queue = *queues_[(start + i) % queues_.size()];
+                std::lock_guard lk{queue.mtx};
+                if (queue.tasks.empty())
+                    continue;
+
+                if (is_worker && i == 0)
+                {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else
+                {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            return false;
+        }
+
+        void run_worker(std::stop_token stop, std::size_t index)
+        {
+            current_pool_ = this;
+            current_index_ = index;
+
+            while (!stop.stop_requested())
+            {
+                if (try_run_one())
+                    continue;
+
+                std::unique_lock lk{mtx_sleep_};
+                cv_sleep_.wait(lk, [&] { return stop.stop_requested() || pending_.load(std::memory_order_acquire) > 0; });
+            }
+        }
+
+        inline static thread_local ThreadPool* current_pool_ = nullptr;
+        inline static thread_local std::size_t current_index_ = 0;
+
+        std::vector<std::unique_ptr<WorkQueue>> queues_;
+        std::atomic<std::size_t> pending_{0};
+        std::atomic<std::size_t> next_queue_{0};
+        std::mutex mtx_sleep_;
+        std::condition_variable cv_sleep_;
+        std::vector<std::jthread> workers_; // the last member - the threads are joined before the queues are gone
+    };
+
+    // fork-join: run() spawns tasks, wait() helps to execute them and rethrows the first exception
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(ThreadPool& pool = ThreadPool::global()) noexcept
+            : pool_{pool}
+        { }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        ~TaskGroup() { join(); } // the tasks may refer to the caller's locals - even if an exception is on the way
+
+        template <typename TFunction>
+        void run(TFunction&& function)
+        {
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            pool_.submit([this, function = std::forward<TFunction>(function)]() mutable {
+                try
+                {
+                    function();
+                }
+                catch (...)
+                {
+                    std::lock_guard lk{mtx_error_};
+                    if (!error_)
+                        error_ = std::current_exception();
+                }
+                pending_.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        void wait()
+        {
+            join();
+            if (error_)
+                std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+
+    private:
+        void join() noexcept
+        {
+            while (pending_.load(std::memory_order_acquire) != 0)
+            {
+                if (!pool_.try_run_one())
+                    std::this_thread::yield();
+            }
+        }
+
+        ThreadPool& pool_;
+        std::atomic<std::size_t> pending_{0};
+        std::mutex mtx_error_;
+        std::exception_ptr error_;
+    };
+} // namespace par
+
+#endif
@@ -0,0 +1,187 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <memory_resource>
+#include <random.hpp>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tokenizer.hpp"
+
+using namespace std::literals;
+using Text::CompactToken;
+
+namespace
+{
+    std::vector<std::string_view> split_with_std(std::string_view text, std::string_view separator)
+    {
+        std::vector<std::string_view> tokens;
+        for (auto&& rng : text | std::views::split(separator))
+            tokens.emplace_back(rng.begin(), rng.end());
+        return tokens;
+    }
+
+    // the text fed in chunks of random sizes
+    std::vector<std::string> tokenize_stream(std::string_view text, std::string_view separator, helpers::random::PCG& rnd, std::size_t max_chunk)
+    {
+        Text::StreamTokenizer tokenizer{separator};
+        std::vector<std::string> tokens;
+        auto on_token = [&](std::string_view token) { tokens.emplace_back(token); };
+
+        while (!text.empty())
+        {
+            const std::size_t chunk_size = std::min<std::size_t>(text.size(), rnd() % (max_chunk + 1));
+            tokenizer.feed(text.substr(0, chunk_size), on_token);
+            text.remove_prefix(chunk_size);
+        }
+        tokenizer.finish(on_token);
+
+        return tokens;
+    }
+} // namespace
+
+TEST_CASE("tokenize_into - caller-supplied buffer")
+{
+    const std::string_view text = "abc,de,,f";
+
+    SECTION("string_view tokens")
+    {
+        std::array<std::string_view, 8> buffer;
+        const std::size_t count = Text::tokenize_into(text, ",", std::span{buffer});
+
+        REQUIRE(count == 4);
+        CHECK(std::ranges::equal(std::span{buffer}.first(count), std::vector{"abc"sv, "de"sv, ""sv, "f"sv}));
+    }
+
+    SECTION("compact tokens")
+    {
+        static_assert(sizeof(CompactToken) == 8);
+
+        std::array<CompactToken, 8> buffer;
+        const std::size_t count = Text::tokenize_into(text, ",", std::span{buffer});
+
+        REQUIRE(count == 4);
+        CHECK(std::ranges::equal(std::span{buffer}.first(count), std::vector<CompactToken>{{0, 3}, {4, 2}, {7, 0}, {8, 1}}));
+        CHECK(buffer[1].in(text) == "de");
+    }
+
+    SECTION("buffer too small - the tokens are counted")
+    {
+        std::array<std::string_view, 2> buffer;
+
+        CHECK(Text::tokenize_into(text, ",", std::span{buffer}) == 4);
+        CHECK(buffer == std::array{"abc"sv, "de"sv});
+    }
+}
+
+TEST_CASE("tokenize - pmr arena")
+{
+    std::array<std::byte, 1024> arena;
+    std::pmr::monotonic_buffer_resource resource{arena.data(), arena.size(), std::pmr::null_memory_resource()};
+
+    const std::string_view text = "GET | /index.html | 200";
+
+    std::pmr::vector<std::string_view> tokens = Text::tokenize(text, " | ", &resource);
+    CHECK(tokens == std::pmr::vector<std::string_view>{"GET"sv, "/index.html"sv, "200"sv});
+
+    std::pmr::vector<CompactToken> compact_tokens = Text::tokenize<CompactToken>(text, " | ", &resource);
+    REQUIRE(compact_tokens.size() == 3);
+    CHECK(compact_tokens[1].in(text) == "/index.html");
+}
+
+TEST_CASE("stream tokenizer")
+{
+    SECTION("separator split by chunk boundaries")
+    {
+        Text::StreamTokenizer tokenizer{"\r\n"};
+        std::vector<std::string> lines;
+        auto on_line = [&](std::string_view line) { lines.emplace_back(line); };
+
+        for (std::string_view chunk : {"first li"sv, "ne\r"sv, "\nsecond\r\n"sv, "\r"sv, "\nlast"sv})
+            tokenizer.feed(chunk, on_line);
+        CHECK(lines == std::vector<std::string>{"first line", "second", ""});
+
+        tokenizer.finish(on_line);
+        CHECK(lines == std::vector<std::string>{"first line", "second", "", "last"});
+    }
+
+    SECTION("the same tokens as std::views::split")
+    {
+        helpers::random::PCG rnd{665};
+
+        for (std::string_view separator : {"a"sv, "ab"sv, "aba"sv, "<=>"sv, "abcabcab"sv})
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                std::string text(rnd() % 300, ' ');
+                for (char& c : text)
+                    c = "abc<=>"[rnd() % 6];
+
+                const auto expected = split_with_std(text, separator);
+                const auto tokens = tokenize_stream(text, separator, rnd, 1 + i % 20);
+                CHECK(std::ranges::equal(tokens, expected));
+            }
+        }
+    }
+
+    SECTION("tokenizer is reusable after finish")
+    {
+        Text::StreamTokenizer tokenizer{","};
+        std::vector<std::string> tokens;
+        auto on_token = [&](std::string_view token) { tokens.emplace_back(token); };
+
+        tokenizer.feed("a,b", on_token);
+        tokenizer.finish(on_token);
+        tokenizer.finish(on_token); // nothing fed - no tokens
+        tokenizer.feed("c,", on_token);
+        tokenizer.finish(on_token);
+
+        CHECK(tokens == std::vector<std::string>{"a", "b", "c", ""});
+    }
+}
+
+TEST_CASE("tokenizer - benchmarks", "[.][benchmark]")
+{
+    helpers::random::PCG rnd{42};
+    std::string csv;
+    for (int i = 0; i < 100'000; ++i)
+        csv += std::to_string(rnd() % 100'000) + (i % 10 == 9 ? "\n" : ",");
+
+    BENCHMARK("std::vector<std::string_view> from std::views::split")
+    {
+        return split_with_std(csv, ",").size();
+    };
+
+    std::vector<std::string_view> views(200'000);
+    BENCHMARK("tokenize_into - string_view")
+    {
+        return Text::tokenize_into(csv, ",", std::span{views});
+    };
+
+    std::vector<CompactToken> compact(200'000);
+    BENCHMARK("tokenize_into - CompactToken")
+    {
+        return Text::tokenize_into(csv, ",", std::span{compact});
+    };
+
+    std::vector<std::byte> arena(4'000'000);
+    BENCHMARK("tokenize<CompactToken> - monotonic arena")
+    {
+        std::pmr::monotonic_buffer_resource resource{arena.data(), arena.size()};
+        return Text::tokenize<CompactToken>(csv, ",", &resource).size();
+    };
+
+    BENCHMARK("StreamTokenizer - 4 KB chunks")
+    {
+        Text::StreamTokenizer tokenizer{","};
+        std::size_t count = 0;
+        auto on_token = [&](std::string_view token) { count += 1 + token.size(); };
+
+        for (std::size_t pos = 0; pos < csv.size(); pos += 4096)
+            tokenizer.feed(std::string_view{csv}.substr(pos, 4096), on_token);
+        tokenizer.finish(on_token);
+        return count;
+    };
+}
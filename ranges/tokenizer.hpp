@@ -0,0 +1,191 @@
+#ifndef TOKENIZER_HPP
+#define TOKENIZER_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fast_split.hpp"
+
+// Tokenizers that do not allocate per token:
+//  * tokenize_into(text, sep, span)     - tokens written to a caller-supplied buffer
+//  * tokenize(text, sep, resource)      - std::pmr::vector of tokens (e.g. from a monotonic arena)
+//  * StreamTokenizer                    - text fed in chunks, a token split by a chunk boundary is carried over
+// A token is a std::string_view (16 bytes) or a CompactToken (8 bytes - offset & length in the text).
+// The tokens are the same as for std::views::split.
+namespace Text
+{
+    struct CompactToken
+    {
+        std::uint32_t offset;
+        std::uint32_t length;
+
+        std::string_view in(std::string_view text) const noexcept { return text.substr(offset, length); }
+
+        bool operator==(const CompactToken&) const = default;
+    };
+
+    template <typename TToken>
+    concept Token = std::same_as<TToken, std::string_view> || std::same_as<TToken, CompactToken>;
+
+    namespace Detail
+    {
+        inline void check_compact_offsets(std::string_view text)
+        {
+            if (text.size() > std::numeric_limits<std::uint32_t>::max())
+                throw std::length_error("text too long for 32-bit token offsets");
+        }
+
+        template <Token TToken>
+        TToken make_token(std::string_view text, std::string_view token) noexcept
+        {
+            if constexpr (std::same_as<TToken, CompactToken>)
+                return {static_cast<std::uint32_t>(token.data() - text.data()), static_cast<std::uint32_t>(token.size())};
+            else
+                return token;
+        }
+    } // namespace Detail
+
+    // writes up to out.size() tokens; returns the number of all the tokens (more than out.size() - the buffer was too small)
+    template <Token TToken, std::size_t Extent>
+    std::size_t tokenize_into(std::string_view text, std::string_view separator, std::span<TToken, Extent> out)
+    {
+        if constexpr (std::same_as<TToken, CompactToken>)
+            Detail::check_compact_offsets(text);
+
+        std::size_t count = 0;
+        for (std::string_view token : fast_split(text, separator))
+        {
+            if (count < out.size())
+                out[count] = Detail::make_token<TToken>(text, token);
+            ++count;
+        }
+        return count;
+    }
+
+    template <Token TToken = std::string_view>
+    std::pmr::vector<TToken> tokenize(std::string_view text, std::string_view separator,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    {
+        if constexpr (std::same_as<TToken, CompactToken>)
+            Detail::check_compact_offsets(text);
+
+        std::pmr::vector<TToken> tokens{resource};
+        for (std::string_view token : fast_split(text, separator))
+            tokens.push_back(Detail::make_token<TToken>(text, token));
+        return tokens;
+    }
+
+    // Tokenizer for text arriving in chunks (socket, file reads):
+    //   tokenizer.feed(chunk, on_token); ... tokenizer.finish(on_token);
+    // on_token(std::string_view) is called for every complete token - the view points into the chunk or into
+    // the carry-over buffer and is valid only during the call. Once the carry-over buffer has grown to the longest
+    // token split by a chunk boundary, no more allocations are made.
+    class StreamTokenizer
+    {
+    public:
+        explicit StreamTokenizer(std::string_view separator, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : separator_{separator, resource}
+            , carry_{resource}
+            , window_{resource}
+        {
+            assert(!separator_.empty());
+            searcher_ = Searcher{separator_};
+        }
+
+        StreamTokenizer(const StreamTokenizer&) = delete;
+        StreamTokenizer& operator=(const StreamTokenizer&) = delete;
+
+        template <typename TOnToken>
+        void feed(std::string_view chunk, TOnToken&& on_token)
+        {
+            if (chunk.empty())
+                return;
+            started_ = true;
+
+            std::size_t pos = 0;
+            if (!carry_.empty())
+            {
+                const std::size_t token_end = complete_carried_token(chunk, pos);
+                if (token_end == Detail::npos)
+                    return;
+                on_token(std::string_view{carry_}.substr(0, token_end));
+                carry_.clear();
+            }
+
+            // every token but the last one is complete - the last one is carried over to the next chunk
+            std::string_view last;
+            bool first = true;
+            for (std::string_view token : fast_split(chunk.substr(pos), separator_))
+            {
+                if (!std::exchange(first, false))
+                    on_token(last);
+                last = token;
+            }
+
+            carry_.append(last);
+        }
+
+        // emits the last token (the empty one after a trailing separator too) and resets the tokenizer
+        template <typename TOnToken>
+        void finish(TOnToken&& on_token)
+        {
+            if (started_)
+                on_token(std::string_view{carry_});
+            carry_.clear();
+            started_ = false;
+        }
+
+    private:
+        // a separator may start in the carried bytes and end in the chunk - returns the end of the carried token
+        // (npos if the whole chunk belongs to it), pos is set to the first byte of the chunk after the separator
+        std::size_t complete_carried_token(std::string_view chunk, std::size_t& pos)
+        {
+            const std::size_t overlap = separator_.size() - 1;
+            const std::size_t tail = std::min(overlap, carry_.size());
+
+            if (overlap > 0)
+            {
+                window_.assign(carry_, carry_.size() - tail, tail);
+                window_.append(chunk.substr(0, overlap));
+
+                // the carried bytes contain no whole separator, so a match starting in them spans the boundary
+                const std::size_t found = searcher_.find(window_);
+                if (found < tail)
+                {
+                    pos = found + separator_.size() - tail;
+                    return carry_.size() - tail + found;
+                }
+            }
+
+            const std::size_t found = searcher_.find(chunk);
+            if (found == Detail::npos)
+            {
+                carry_.append(chunk);
+                return Detail::npos;
+            }
+
+            carry_.append(chunk.substr(0, found));
+            pos = found + separator_.size();
+            return carry_.size();
+        }
+
+        std::pmr::string separator_;
+        Searcher searcher_;
+        std::pmr::string carry_;  // bytes of the unfinished token
+        std::pmr::string window_; // the chunk boundary checked for a split separator
+        bool started_ = false;
+    };
+} // namespace Text
+
+#endif
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <forward_list>
+#include <functional>
+#include <numeric>
+#include <random.hpp>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "top_k.hpp"
+
+using namespace std::literals;
+using Algorithms::TopKStrategy;
+
+namespace
+{
+    std::vector<int> create_values(std::size_t count, std::uint32_t seed, std::uint32_t range = 1'000'000)
+    {
+        helpers::random::PCG rnd{seed};
+        std::vector<int> values(count);
+        for (int& value : values)
+            value = static_cast<int>(rnd() % range);
+        return values;
+    }
+
+    template <typename TComp = std::ranges::less, typename TProj = std::identity>
+    std::vector<int> top_k_by_sort(std::vector<int> values, std::size_t k, TComp comp = {}, TProj proj = {})
+    {
+        std::ranges::stable_sort(values, comp, proj);
+        values.resize(std::min(k, values.size()));
+        return values;
+    }
+
+    // the elements may differ for ties - their projections must be the same
+    template <typename TProj = std::identity>
+    bool same_keys(const std::vector<int>& result, const std::vector<int>& expected, TProj proj = {})
+    {
+        return std::ranges::equal(result, expected, {}, proj, proj);
+    }
+
+    struct Product
+    {
+        std::string name;
+        double rating;
+    };
+} // namespace
+
+TEST_CASE("top_k - the k first elements, sorted")
+{
+    const std::vector<int> values = {7, 3, 9, 1, 3, 8, 2, 6};
+
+    for (auto strategy : {TopKStrategy::automatic, TopKStrategy::heap, TopKStrategy::quickselect})
+    {
+        CHECK(Algorithms::top_k(values, 3, {}, {}, strategy) == std::vector{1, 2, 3});
+        CHECK(Algorithms::top_k(values, 3, std::greater{}, {}, strategy) == std::vector{9, 8, 7});
+        CHECK(Algorithms::top_k(values, 0, {}, {}, strategy).empty());
+        CHECK(Algorithms::top_k(values, 100, {}, {}, strategy) == std::vector{1, 2, 3, 3, 6, 7, 8, 9});
+        CHECK(Algorithms::top_k(std::vector<int>{}, 5, {}, {}, strategy).empty());
+    }
+
+    SECTION("projections")
+    {
+        const std::vector<Product> products = {{"pen", 4.1}, {"book", 4.8}, {"mug", 3.2}, {"lamp", 4.5}};
+
+        auto best = Algorithms::top_k(products, 2, std::greater{}, &Product::rating);
+        CHECK(std::ranges::equal(best, std::vector{"book"s, "lamp"s}, {}, &Product::name));
+
+        auto shortest = Algorithms::top_k(products, 2, {}, [](const Product& p) { return p.name.size(); }, TopKStrategy::heap);
+        CHECK(std::ranges::equal(shortest, std::vector{"pen"s, "mug"s}, {}, &Product::name));
+    }
+
+    SECTION("single-pass input")
+    {
+        std::istringstream numbers{"5 17 -3 8 12 0 42"};
+        CHECK(Algorithms::top_k(std::views::istream<int>(numbers), 2, std::greater{}) == std::vector{42, 17});
+
+        const std::forward_list<int> list = {4, 1, 5, 9, 2, 6};
+        CHECK(Algorithms::top_k(list | std::views::filter([](int x) { return x % 2 == 0; }), 2) == std::vector{2, 4});
+    }
+}
+
+TEST_CASE("top_k - as sorting all of the input")
+{
+    for (std::uint32_t seed : {1, 2, 3})
+    {
+        const std::vector<int> values = create_values(10'000, seed, seed == 3 ? 50 : 1'000'000); // seed 3 - many ties
+
+        for (std::size_t k : {1, 2, 63, 64, 65, 100, 1000, 9999, 10'000})
+        {
+            const auto expected = top_k_by_sort(values, k);
+            CHECK(Algorithms::top_k(values, k, {}, {}, TopKStrategy::heap) == expected);
+            CHECK(Algorithms::top_k(values, k, {}, {}, TopKStrategy::quickselect) == expected);
+
+            auto by_last_digit = [](int x) { return x % 10; };
+            const auto expected_by_digit = top_k_by_sort(values, k, std::greater{}, by_last_digit);
+            CHECK(same_keys(Algorithms::top_k(values, k, std::greater{}, by_last_digit, TopKStrategy::heap), expected_by_digit, by_last_digit));
+            CHECK(same_keys(Algorithms::top_k(values, k, std::greater{}, by_last_digit, TopKStrategy::quickselect), expected_by_digit, by_last_digit));
+        }
+    }
+
+    SECTION("sorted input - every element a candidate")
+    {
+        std::vector<int> ascending(5000);
+        std::iota(ascending.begin(), ascending.end(), 0);
+
+        CHECK(Algorithms::top_k(ascending, 10, std::greater{}, {}, TopKStrategy::heap) == top_k_by_sort(ascending, 10, std::greater{}));
+        CHECK(Algorithms::top_k(ascending, 10, std::greater{}, {}, TopKStrategy::quickselect) == top_k_by_sort(ascending, 10, std::greater{}));
+    }
+}
+
+TEST_CASE("TopK - streaming")
+{
+    Algorithms::TopK<int, std::greater<>> top3{3};
+
+    top3.push_range(std::vector{4, 8, 1});
+    CHECK(top3.result() == std::vector{8, 4, 1});
+
+    // an unbounded source - the memory stays O(k)
+    helpers::random::PCG rnd{5};
+    int max_value = 0;
+    for (int i = 0; i < 100'000; ++i)
+    {
+        const int value = static_cast<int>(rnd() % 1'000'000);
+        max_value = std::max(max_value, value);
+        top3.push(value);
+    }
+    CHECK(top3.result().front() == max_value);
+    CHECK(top3.result().size() == 3);
+    CHECK(std::ranges::is_sorted(top3.result(), std::greater{}));
+
+    SECTION("a copy streams on independently")
+    {
+        const std::vector<int> values = create_values(10'000, 11);
+
+        Algorithms::TopK<int> smallest{3};
+        smallest.push_range(values);
+        Algorithms::TopK<int> copy = smallest; // the buffer of the copy holds only its candidates
+        copy.push_range(values);
+        copy.push_range(std::vector{-2, -1});
+        CHECK(copy.result() == std::vector{-2, -1, top_k_by_sort(values, 1).front()});
+
+        Algorithms::TopK<int> assigned{3};
+        assigned = smallest;
+        assigned.push_range(std::vector{-5});
+        CHECK(assigned.result() == std::vector{-5, top_k_by_sort(values, 2)[0], top_k_by_sort(values, 2)[1]});
+        CHECK(smallest.result() == top_k_by_sort(values, 3));
+    }
+
+    Algorithms::TopK<std::string, std::ranges::less, std::size_t (std::string::*)() const noexcept> shortest{2, {}, &std::string::size};
+    for (std::string word : {"alpha"s, "be"s, "gamma"s, "pi"s, "omega"s})
+        shortest.push(std::move(word));
+    CHECK(std::ranges::equal(std::move(shortest).result(), std::vector{2, 2}, {}, &std::string::size));
+}
+
+TEST_CASE("par::top_k - a selection per thread, merged")
+{
+    const std::vector<int> values = create_values(500'000, 7);
+
+    for (std::size_t k : {0, 1, 100, 5000})
+    {
+        CHECK(par::top_k(values, k) == top_k_by_sort(values, k));
+        CHECK(par::top_k(values, k, {}, {}, TopKStrategy::heap) == top_k_by_sort(values, k));
+    }
+
+    auto negated = [](int x) { return -x; };
+    CHECK(par::top_k(values.begin(), values.end(), 10, std::less{}, negated) == top_k_by_sort(values, 10, std::greater{}));
+    CHECK(par::top_k(values | std::views::take(1000), 10) == top_k_by_sort({values.begin(), values.begin() + 1000}, 10));
+}
+
+TEST_CASE("top_k - benchmarks", "[.][benchmark]")
+{
+    const std::vector<int> values = create_values(10'000'000, 42, 1'000'000'000);
+    std::vector<int> ascending(values);
+    std::ranges::sort(ascending);
+
+    BENCHMARK("copy & std::ranges::sort - top 100 of 10M")
+    {
+        std::vector<int> sorted(values);
+        std::ranges::sort(sorted);
+        return sorted[99];
+    };
+
+    BENCHMARK("std::ranges::partial_sort_copy - top 100 of 10M")
+    {
+        std::vector<int> top(100);
+        std::ranges::partial_sort_copy(values, top);
+        return top.front();
+    };
+
+    for (std::size_t k : {100, 10'000})
+    {
+        const std::string label = " - top " + std::to_string(k) + " of 10M";
+
+        BENCHMARK("top_k - heap" + label)
+        {
+            return Algorithms::top_k(values, k, {}, {}, TopKStrategy::heap).front();
+        };
+
+        BENCHMARK("top_k - quickselect" + label)
+        {
+            return Algorithms::top_k(values, k, {}, {}, TopKStrategy::quickselect).front();
+        };
+
+        BENCHMARK("par::top_k" + label)
+        {
+            return par::top_k(values, k).front();
+        };
+    }
+
+    BENCHMARK("top_k - heap - top 100 of 10M, sorted in reverse")
+    {
+        return Algorithms::top_k(ascending, 100, std::greater{}, {}, TopKStrategy::heap).front();
+    };
+
+    BENCHMARK("top_k - quickselect - top 100 of 10M, sorted in reverse")
+    {
+        return Algorithms::top_k(ascending, 100, std::greater{}, {}, TopKStrategy::quickselect).front();
+    };
+}
@@ -0,0 +1,294 @@
+#ifndef TOP_K_HPP
+#define TOP_K_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "parallel_algorithms.hpp"
+
+// Top-k selection - the k first elements in the order of comp (the k smallest by default), sorted;
+// a partial order of the input instead of sorting all of it:
+//
+//   std::vector best = Algorithms::top_k(products, 100, std::greater{}, &Product::rating);
+//
+//  * TopKStrategy::heap - a heap of the k best elements so far; a candidate is compared with the worst
+//    of them (the top) and replaces it if better: O(n log k) in the worst case
+//  * TopKStrategy::quickselect - the candidates better than a threshold are appended to a buffer of ~2k elements;
+//    when it is full, nth_element keeps the k best ones and the worst of them becomes the threshold: O(n) on average
+//  * Algorithms::TopK - the streaming variant (quickselect): push() the elements of an unbounded input in O(k) memory
+//  * par::top_k - the chunks of a random-access range are selected in parallel (one per thread),
+//    the results of the threads (k elements each) are selected once more
+// Any input range (a single pass) with O(k) memory; the input is not modified.
+// Of equal elements any may be chosen - the selection is not stable.
+namespace Algorithms
+{
+    enum class TopKStrategy
+    {
+        automatic,
+        heap,
+        quickselect
+    };
+
+    namespace Detail
+    {
+        inline constexpr std::size_t min_quickselect_slack = 64; // the buffer holds at least that many candidates above k
+
+        // the top of a max-heap (in the order of comp) replaced by item, which is sifted down -
+        // one pass instead of std::ranges::pop_heap & push_heap
+        template <typename T, typename TComp, typename TProj>
+        void replace_heap_top(std::vector<T>& heap, T item, TComp& comp, TProj& proj)
+        {
+            const std::size_t size = heap.size();
+
+            std::size_t hole = 0;
+            for (std::size_t child = 1; child < size; child = 2 * hole + 1)
+            {
+                if (child + 1 < size && std::invoke(comp, std::invoke(proj, heap[child]), std::invoke(proj, heap[child + 1])))
+                    ++child;
+                if (!std::invoke(comp, std::invoke(proj, item), std::invoke(proj, heap[child])))
+                    break;
+                heap[hole] = std::move(heap[child]);
+                hole = child;
+            }
+            heap[hole] = std::move(item);
+        }
+
+        template <typename TIter, typename TSentinel, typename TComp, typename TProj>
+        auto top_k_heap(TIter first, TSentinel last, std::size_t k, TComp& comp, TProj& proj)
+        {
+            std::vector<std::iter_value_t<TIter>> heap;
+            if (k == 0)
+                return heap;
+
+            if constexpr (std::sized_sentinel_for<TSentinel, TIter>)
+                heap.reserve(std::min(k, static_cast<std::size_t>(last - first)));
+
+            for (; first != last && heap.size() < k; ++first)
+                heap.push_back(*first);
+            std::ranges::make_heap(heap, std::ref(comp), std::ref(proj));
+
+            // the projection of the worst element is computed once for all the candidates it rejects
+            while (first != last)
+            {
+                auto&& worst = std::invoke(proj, std::as_const(heap.front()));
+                for (; first != last; ++first)
+                {
+                    if (std::invoke(comp, std::invoke(proj, *first), worst))
+                    {
+                        replace_heap_top(heap, std::iter_value_t<TIter>(*first), comp, proj);
+                        ++first;
+                        break;
+                    }
+                }
+            }
+
+            std::ranges::sort_heap(heap, std::ref(comp), std::ref(proj));
+            return heap;
+        }
+    } // namespace Detail
+
+    //////////////////////////////////////////////////////////////////////
+    // TopK - the k best elements of a stream: push() the elements, result() - the best so far, sorted
+
+    template <std::copyable T, typename TComp = std::ranges::less, typename TProj = std::identity>
+        requires std::sortable<typename std::vector<T>::iterator, TComp, TProj>
+    class TopK
+    {
+    public:
+        explicit TopK(std::size_t k, TComp comp = {}, TProj proj = {})
+            : k_{k}
+            , capacity_{k < std::numeric_limits<std::size_t>::max() / 2 ? k + std::max(k, Detail::min_quickselect_slack) : std::numeric_limits<std::size_t>::max()}
+            , comp_{std::move(comp)}
+            , proj_{std::move(proj)}
+        { }
+
+        std::size_t k() const noexcept
+        {
+            return k_;
+        }
+
+        void push(const T& item)
+        {
+            if (is_candidate(item))
+                add(item);
+        }
+
+        void push(T&& item)
+        {
+            if (is_candidate(item))
+                add(std::move(item));
+        }
+
+        template <std::input_iterator TIter, std::sentinel_for<TIter> TSentinel>
+            requires std::constructible_from<T, std::iter_reference_t<TIter>>
+        void push_range(TIter first, TSentinel last)
+        {
+            if (k_ == 0)
+                return;
+
+            for (; first != last && !has_threshold_; ++first)
+                add(*first);
+
+            // the projection of the threshold is computed once until the next shrink() -
+            // the kept candidates do not move while the buffer fills up (no reallocation below capacity_;
+            // a copy of a TopK may have a smaller buffer - it is grown first)
+            if (first != last)
+                candidates_.reserve(capacity_);
+
+            while (first != last)
+            {
+                auto&& threshold = std::invoke(proj_, std::as_const(candidates_[k_ - 1]));
+                for (; first != last; ++first)
+                {
+                    if (std::invoke(comp_, std::invoke(proj_, *first), threshold))
+                    {
+                        candidates_.emplace_back(*first);
+                        if (candidates_.size() == capacity_)
+                        {
+                            ++first;
+                            shrink();
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        template <std::ranges::input_range TRange>
+            requires std::constructible_from<T, std::ranges::range_reference_t<TRange>>
+        void push_range(TRange&& rng)
+        {
+            push_range(std::ranges::begin(rng), std::ranges::end(rng));
+        }
+
+        std::vector<T> result() const&
+        {
+            return TopK{*this}.result();
+        }
+
+        std::vector<T> result() &&
+        {
+            if (candidates_.size() > k_)
+                shrink();
+            std::ranges::sort(candidates_, std::ref(comp_), std::ref(proj_));
+            has_threshold_ = false; // the candidates are moved out
+            return std::move(candidates_);
+        }
+
+    private:
+        bool is_candidate(const T& item)
+        {
+            return !has_threshold_ || std::invoke(comp_, std::invoke(proj_, item), std::invoke(proj_, candidates_[k_ - 1]));
+        }
+
+        template <typename U>
+        void add(U&& item)
+        {
+            candidates_.emplace_back(std::forward<U>(item));
+            if (candidates_.size() == capacity_)
+                shrink();
+        }
+
+        // the k best candidates moved to the front - the last of them (the k-th best) is the threshold
+        void shrink()
+        {
+            if (k_ == 0)
+            {
+                candidates_.clear();
+                has_threshold_ = false;
+                return;
+            }
+
+            std::ranges::nth_element(candidates_, candidates_.begin() + (k_ - 1), std::ref(comp_), std::ref(proj_));
+            candidates_.erase(candidates_.begin() + k_, candidates_.end());
+            has_threshold_ = true;
+        }
+
+        std::size_t k_;
+        std::size_t capacity_;
+        [[no_unique_address]] TComp comp_;
+        [[no_unique_address]] TProj proj_;
+        std::vector<T> candidates_;
+        bool has_threshold_ = false;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    // top_k - the k first elements (or all of them if there are fewer) in the order of comp, sorted
+
+    template <std::input_iterator TIter, std::sentinel_for<TIter> TSentinel, typename TComp = std::ranges::less,
+        typename TProj = std::identity>
+        requires std::copyable<std::iter_value_t<TIter>> && std::sortable<typename std::vector<std::iter_value_t<TIter>>::iterator, TComp, TProj>
+    std::vector<std::iter_value_t<TIter>> top_k(TIter first, TSentinel last, std::size_t k, TComp comp = {}, TProj proj = {},
+        TopKStrategy strategy = TopKStrategy::automatic)
+    {
+        if (strategy == TopKStrategy::automatic)
+            strategy = TopKStrategy::quickselect;
+
+        if (strategy == TopKStrategy::heap)
+            return Detail::top_k_heap(std::move(first), std::move(last), k, comp, proj);
+
+        if constexpr (std::sized_sentinel_for<TSentinel, TIter>)
+            k = std::min(k, static_cast<std::size_t>(last - first)); // no buffer of 2k for a smaller input
+
+        TopK<std::iter_value_t<TIter>, std::reference_wrapper<TComp>, std::reference_wrapper<TProj>> selection{k, comp, proj};
+        selection.push_range(std::move(first), std::move(last));
+        return std::move(selection).result();
+    }
+
+    template <std::ranges::input_range TRange, typename TComp = std::ranges::less, typename TProj = std::identity>
+        requires std::copyable<std::ranges::range_value_t<TRange>>
+              && std::sortable<typename std::vector<std::ranges::range_value_t<TRange>>::iterator, TComp, TProj>
+    std::vector<std::ranges::range_value_t<TRange>> top_k(TRange&& rng, std::size_t k, TComp comp = {}, TProj proj = {},
+        TopKStrategy strategy = TopKStrategy::automatic)
+    {
+        return Algorithms::top_k(std::ranges::begin(rng), std::ranges::end(rng), k, std::move(comp), std::move(proj), strategy);
+    }
+} // namespace Algorithms
+
+namespace par
+{
+    //////////////////////////////////////////////////////////////////////
+    // top_k - a selection per thread (a heap or quickselect - the strategy as in Algorithms::top_k),
+    // the k best of every thread selected once more (serially); one chunk per thread, not more -
+    // every chunk costs a selection of k elements
+
+    template <std::random_access_iterator TIter, std::sentinel_for<TIter> TSentinel, typename TComp = std::ranges::less,
+        typename TProj = std::identity>
+        requires std::copyable<std::iter_value_t<TIter>> && std::sortable<typename std::vector<std::iter_value_t<TIter>>::iterator, TComp, TProj>
+    std::vector<std::iter_value_t<TIter>> top_k(TIter first, TSentinel last, std::size_t k, TComp comp = {}, TProj proj = {},
+        Algorithms::TopKStrategy strategy = Algorithms::TopKStrategy::automatic)
+    {
+        const TIter end = std::ranges::next(first, last);
+        const auto threads = static_cast<std::ptrdiff_t>(ThreadPool::global().size() + 1); // + the calling thread
+        const std::ptrdiff_t chunks = std::min(Detail::chunk_count(end - first), threads);
+
+        if (chunks == 1 || k == 0)
+            return Algorithms::top_k(first, end, k, std::ref(comp), std::ref(proj), strategy);
+
+        std::vector<std::vector<std::iter_value_t<TIter>>> partials(chunks);
+        auto body = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t index) {
+            partials[index] = Algorithms::top_k(first + begin, first + end, k, std::ref(comp), std::ref(proj), strategy);
+        };
+        Detail::for_chunks(end - first, chunks, body);
+
+        return Algorithms::top_k(partials | std::views::join, k, std::ref(comp), std::ref(proj));
+    }
+
+    template <std::ranges::random_access_range TRange, typename TComp = std::ranges::less, typename TProj = std::identity>
+        requires std::copyable<std::ranges::range_value_t<TRange>>
+              && std::sortable<typename std::vector<std::ranges::range_value_t<TRange>>::iterator, TComp, TProj>
+    std::vector<std::ranges::range_value_t<TRange>> top_k(TRange&& rng, std::size_t k, TComp comp = {}, TProj proj = {},
+        Algorithms::TopKStrategy strategy = Algorithms::TopKStrategy::automatic)
+    {
+        return par::top_k(std::ranges::begin(rng), std::ranges::end(rng), k, std::move(comp), std::move(proj), strategy);
+    }
+} // namespace par
+
+#endif
@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random.hpp>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "sentinels.hpp"
+#include "unrolled_list.hpp"
+
+using namespace std::literals;
+
+namespace
+{
+    // small nodes - a few dozen elements take many of them
+    template <typename T>
+    using SmallNodeList = Containers::UnrolledList<T, 4>;
+
+    template <typename TList, typename T>
+    void check_same(const TList& lst, const std::list<T>& expected)
+    {
+        REQUIRE(lst.size() == expected.size());
+        CHECK(std::ranges::equal(lst, expected));
+        CHECK(std::ranges::equal(lst | std::views::reverse, expected | std::views::reverse));
+    }
+
+    // push, pop, insert & erase at random positions - the splits & merges of the nodes
+    template <std::size_t Capacity>
+    void check_random_operations()
+    {
+        Containers::UnrolledList<std::unique_ptr<int>, Capacity> lst;
+        std::list<int> expected;
+        helpers::random::PCG rnd{42};
+
+        auto values = [](const auto& items) {
+            return items | std::views::transform([](const std::unique_ptr<int>& item) { return *item; });
+        };
+
+        for (int step = 0; step < 20'000; ++step)
+        {
+            const int value = static_cast<int>(rnd() % 1000);
+            const std::size_t offset = expected.empty() ? 0 : rnd() % (expected.size() + 1);
+
+            switch (rnd() % 8)
+            {
+            case 0:
+                lst.push_back(std::make_unique<int>(value));
+                expected.push_back(value);
+                break;
+            case 1:
+                lst.emplace_front(std::make_unique<int>(value));
+                expected.push_front(value);
+                break;
+            case 2:
+            case 3:
+            {
+                auto it = lst.emplace(std::ranges::next(lst.begin(), offset), std::make_unique<int>(value));
+                auto expected_it = expected.insert(std::ranges::next(expected.begin(), offset), value);
+                CHECK(**it == *expected_it);
+                break;
+            }
+            case 4:
+            case 5:
+                if (offset < expected.size())
+                {
+                    auto it = lst.erase(std::ranges::next(lst.begin(), offset));
+                    auto expected_it = expected.erase(std::ranges::next(expected.begin(), offset));
+                    CHECK((it == lst.end()) == (expected_it == expected.end()));
+                    if (it != lst.end())
+                        CHECK(**it == *expected_it);
+                }
+                break;
+            case 6:
+            {
+                const std::size_t count = std::min<std::size_t>(rnd() % 12, expected.size() - std::min(offset, expected.size()));
+                auto first = std::ranges::next(lst.begin(), offset);
+                auto it = lst.erase(first, std::ranges::next(first, count));
+                auto expected_first = std::ranges::next(expected.begin(), offset);
+                auto expected_it = expected.erase(expected_first, std::ranges::next(expected_first, count));
+                CHECK(std::ranges::distance(lst.begin(), it) == std::ranges::distance(expected.begin(), expected_it));
+                break;
+            }
+            default:
+                if (!expected.empty())
+                {
+                    if (value % 2)
+                    {
+                        lst.pop_back();
+                        expected.pop_back();
+                    }
+                    else
+                    {
+                        lst.pop_front();
+                        expected.pop_front();
+                    }
+                }
+                break;
+            }
+
+            if (step % 1000 == 0)
+            {
+                REQUIRE(lst.size() == expected.size());
+                CHECK(std::ranges::equal(values(lst), expected));
+                CHECK(std::ranges::equal(values(lst) | std::views::reverse, expected | std::views::reverse));
+            }
+        }
+
+        REQUIRE(lst.size() == expected.size());
+        CHECK(std::ranges::equal(values(lst), expected));
+
+        CHECK(lst.nodes() <= lst.size()); // no empty nodes
+
+        CHECK(lst.remove_if([](const std::unique_ptr<int>& item) { return *item < 500; }) == std::erase_if(expected, [](int x) { return x < 500; }));
+        CHECK(std::ranges::equal(values(lst), expected));
+
+        lst.erase(lst.begin(), lst.end());
+        CHECK(lst.empty());
+        CHECK(lst.nodes() == 0);
+    }
+} // namespace
+
+TEST_CASE("UnrolledList - the API of std::list")
+{
+    Containers::UnrolledList<int> lst = {1, 2, 3, 4, 5};
+
+    static_assert(std::ranges::bidirectional_range<decltype(lst)>);
+    static_assert(std::ranges::bidirectional_range<const decltype(lst)>);
+    static_assert(std::ranges::sized_range<decltype(lst)>);
+
+    SECTION("both ends")
+    {
+        lst.push_front(0);
+        lst.push_back(6);
+        lst.emplace_back(7);
+        CHECK(lst.front() == 0);
+        CHECK(lst.back() == 7);
+
+        lst.pop_front();
+        lst.pop_back();
+        CHECK(std::ranges::equal(lst, std::vector{1, 2, 3, 4, 5, 6}));
+    }
+
+    SECTION("insert & erase in the middle")
+    {
+        auto pos = lst.insert(std::ranges::find(lst, 3), 42);
+        CHECK(*pos == 42);
+        CHECK(*std::next(pos) == 3);
+
+        pos = lst.erase(std::ranges::find(lst, 2));
+        CHECK(*pos == 42);
+        CHECK(std::ranges::equal(lst, std::vector{1, 42, 3, 4, 5}));
+
+        CHECK(lst.erase(std::next(lst.begin()), lst.end()) == lst.end());
+        CHECK(std::ranges::equal(lst, std::vector{1}));
+    }
+
+    SECTION("remove_if")
+    {
+        CHECK(lst.remove_if([](int x) { return x % 2 == 1; }) == 3);
+        CHECK(std::ranges::equal(lst, std::vector{2, 4}));
+    }
+
+    SECTION("copy, move & comparison")
+    {
+        auto copy = lst;
+        CHECK(copy == lst);
+        copy.back() = 0;
+        CHECK(copy < lst);
+
+        auto moved = std::move(copy);
+        CHECK(moved.back() == 0);
+        CHECK(copy.empty());
+        CHECK(copy.begin() == copy.end());
+
+        swap(moved, lst);
+        CHECK(lst.back() == 0);
+        CHECK(moved.back() == 5);
+        CHECK(std::ranges::equal(std::as_const(moved) | std::views::reverse, std::vector{5, 4, 3, 2, 1}));
+    }
+}
+
+TEST_CASE("UnrolledList - the views of ranges_and_views.cpp")
+{
+    using Sentinels::EndValue;
+
+    Containers::UnrolledList<int> lst = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    SECTION("subrange")
+    {
+        auto sublst = std::ranges::subrange{lst.begin(), EndValue<5>{}};
+        std::ranges::fill(sublst, 0);
+        CHECK(std::ranges::equal(lst, std::vector{0, 0, 0, 0, 5, 6, 7, 8, 9, 10}));
+    }
+
+    SECTION("all")
+    {
+        auto all_items = std::views::all(lst);
+        static_assert(std::ranges::view<decltype(all_items)>);
+        CHECK(std::ranges::equal(all_items, std::views::iota(1, 11)));
+    }
+
+    SECTION("counted")
+    {
+        auto first_half = std::views::counted(lst.begin(), lst.size() / 2);
+
+        for (auto& item : first_half)
+            item *= 2;
+
+        CHECK(std::ranges::equal(lst, std::vector{2, 4, 6, 8, 10, 6, 7, 8, 9, 10}));
+    }
+
+    SECTION("piping with |")
+    {
+        auto data = lst
+            | std::views::filter([](int x) { return x % 2 == 0; })
+            | std::views::transform([](int x) { return x * x; })
+            | std::views::reverse;
+
+        CHECK(std::ranges::equal(data, std::vector{100, 64, 36, 16, 4}));
+    }
+}
+
+TEST_CASE("UnrolledList - iterators stepping as in std::list")
+{
+    Containers::UnrolledList<int> lst = {1, 2, 3};
+
+    auto last = std::prev(lst.end());
+    lst.push_back(4);
+    CHECK(*++last == 4);
+
+    auto second = std::next(lst.begin());
+    lst.pop_back();
+    lst.pop_back();
+    CHECK(++second == lst.end());
+}
+
+TEST_CASE("UnrolledList - iterator stability")
+{
+    SmallNodeList<std::string> lst;
+    for (int i = 0; i < 10; ++i)
+        lst.push_back(std::to_string(i));
+
+    std::string& first = lst.front();
+    std::string& fifth = *std::ranges::next(lst.begin(), 5);
+    auto last = std::prev(lst.end());
+    const auto end = lst.end();
+
+    SECTION("both ends - nothing moves")
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            lst.push_front("front"s);
+            lst.push_back("back"s);
+        }
+        lst.pop_front();
+        lst.pop_back();
+
+        CHECK(&first == &*std::ranges::next(lst.begin(), 99));
+        CHECK(fifth == "5");
+        CHECK(*last == "9");
+        CHECK(lst.end() == end);
+    }
+
+    SECTION("push_back & pop_back - stepping over the moved end of the last node")
+    {
+        auto eighth = std::ranges::next(lst.begin(), 8);
+        auto seventh = std::prev(eighth);
+
+        lst.push_back("10"s); // into the node [8 9]
+        CHECK(*std::next(last) == "10");
+
+        lst.pop_back();
+        lst.pop_back();
+        CHECK(std::next(eighth) == lst.end());
+
+        lst.pop_back(); // the node [8] removed
+        CHECK(std::next(seventh) == lst.end());
+        CHECK(std::prev(lst.end()) == seventh);
+
+        lst.push_back("8"s);
+        CHECK(*std::next(seventh) == "8");
+    }
+
+    SECTION("emplace - appended to the previous node")
+    {
+        // the nodes: [0 1 2 3] [4 5 6] [8 9]
+        lst.erase(std::ranges::find(lst, "7"s));
+        auto sixth = std::ranges::find(lst, "6"s);
+
+        lst.emplace(std::ranges::find(lst, "8"s), "7"s);
+        CHECK(*std::next(sixth) == "7");
+        CHECK(*std::ranges::next(sixth, 2) == "8");
+    }
+
+    SECTION("the middle - only the node of the position")
+    {
+        // the nodes: [0 1 2 3] [4 5 6 7] [8 9]
+        lst.insert(std::ranges::next(lst.begin(), 9), "8.5"s);
+        lst.erase(std::ranges::next(lst.begin(), 8));
+        lst.insert(std::ranges::next(lst.begin(), 2), "1.5"s);
+
+        CHECK(fifth == "5");
+        CHECK(&fifth == &*std::ranges::find(lst, "5"s));
+        CHECK(lst.end() == end);
+        CHECK(std::ranges::equal(lst, std::vector{"0"s, "1"s, "1.5"s, "2"s, "3"s, "4"s, "5"s, "6"s, "7"s, "8.5"s, "9"s}));
+    }
+}
+
+TEST_CASE("UnrolledList - random operations against std::list")
+{
+    check_random_operations<4>();
+    check_random_operations<16>();
+}
+
+TEST_CASE("UnrolledList - random inserts into the default nodes")
+{
+    Containers::UnrolledList<int> lst;
+    std::list<int> expected;
+    helpers::random::PCG rnd{7};
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        const std::size_t offset = rnd() % (expected.size() + 1);
+        lst.insert(std::ranges::next(lst.begin(), offset), i);
+        expected.insert(std::ranges::next(expected.begin(), offset), i);
+    }
+
+    check_same(lst, expected);
+    // split nodes are at least half full
+    CHECK(lst.nodes() <= 2 * lst.size() / decltype(lst)::node_capacity + 1);
+}
+
+TEST_CASE("UnrolledList - benchmarks", "[.][benchmark]")
+{
+    constexpr int count = 10'000'000;
+
+    // one after the other - the nodes of the two lists are not interleaved in memory
+    std::list<int> std_list;
+    for (int i = 0; i < count; ++i)
+        std_list.push_back(i);
+    Containers::UnrolledList<int> unrolled_list;
+    for (int i = 0; i < count; ++i)
+        unrolled_list.push_back(i);
+
+    std::cout << "memory: std::list<int> ~ " << count * (2 * sizeof(void*) + 2 * sizeof(int)) / (1 << 20) << " MB (+ the allocator's overhead), "
+              << "UnrolledList<int> ~ " << unrolled_list.nodes() * (sizeof(int) * decltype(unrolled_list)::node_capacity + 2 * sizeof(void*) + 8) / (1 << 20)
+              << " MB\n";
+
+    BENCHMARK("std::list - sum of 10M")
+    {
+        long long sum = 0;
+        for (int item : std_list)
+            sum += item;
+        return sum;
+    };
+
+    BENCHMARK("UnrolledList - sum of 10M")
+    {
+        long long sum = 0;
+        for (int item : unrolled_list)
+            sum += item;
+        return sum;
+    };
+
+    BENCHMARK("std::list - std::ranges::fill")
+    {
+        std::ranges::fill(std_list, 1);
+        return std_list.back();
+    };
+
+    BENCHMARK("UnrolledList - std::ranges::fill")
+    {
+        std::ranges::fill(unrolled_list, 1);
+        return unrolled_list.back();
+    };
+
+    // a list built by inserts at random positions - the std::list nodes scattered over the heap
+    // (the layout of an UnrolledList does not depend on the order of the inserts - the same sequence is appended)
+    std::list<int> std_shuffled;
+    helpers::random::PCG rnd{1};
+    std::vector<std::list<int>::iterator> std_positions;
+    for (int i = 0; i < 1'000'000; ++i)
+        std_positions.push_back(std_shuffled.insert(std_positions.empty() ? std_shuffled.end() : std_positions[rnd() % std_positions.size()], i));
+    Containers::UnrolledList<int> unrolled_shuffled(std_shuffled.begin(), std_shuffled.end());
+
+    BENCHMARK("std::list - sum of 1M inserted at random positions")
+    {
+        long long sum = 0;
+        for (int item : std_shuffled)
+            sum += item;
+        return sum;
+    };
+
+    BENCHMARK("UnrolledList - sum of 1M inserted at random positions")
+    {
+        long long sum = 0;
+        for (int item : unrolled_shuffled)
+            sum += item;
+        return sum;
+    };
+}
@@ -0,0 +1,631 @@
+#ifndef UNROLLED_LIST_HPP
+#define UNROLLED_LIST_HPP
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+// Containers::UnrolledList<T> - the std::list API (push & pop at both ends, insert & erase in the middle,
+// bidirectional iterators, O(1) size) in a doubly linked list of chunks:
+//  * a node holds up to Capacity elements (256 bytes of them by default) in a contiguous run [begin, end) of its slots -
+//    traversal walks arrays, one allocation & one cache miss per node instead of one per element
+//  * a few bytes of bookkeeping per node instead of two pointers per element (& the allocator's overhead)
+//  * insert & erase in the middle shift at most half of a node; a full node is split in two, a node a quarter full
+//    after an erasure is merged with a neighbour half full at most
+// Iterator stability - as in std::list wherever no element has to move:
+//  * push_back, push_front, emplace_back, emplace_front, pop_back, pop_front - the iterators & references
+//    to the other elements stay valid
+//  * insert, emplace, erase - the iterators & references to the elements of the node of the position (and of the node
+//    split off it or merged with it) are invalidated, those of all the other nodes stay valid
+//  * remove_if - the iterators & references to the elements of the nodes an element was removed from are invalidated
+//    (the kept elements are compacted in place)
+//  * end() is never invalidated (except by swap & move)
+namespace Containers
+{
+    namespace Detail
+    {
+        // 256 bytes of elements
+        template <typename T>
+        inline constexpr std::size_t default_chunk_capacity = std::max<std::size_t>(4, 256 / sizeof(T));
+    } // namespace Detail
+
+    template <typename T, std::size_t Capacity = Detail::default_chunk_capacity<T>>
+    class UnrolledList
+    {
+        static_assert(Capacity >= 4 && Capacity <= std::uint32_t{1} << 31);
+
+        // the header of the list (the position of end()) is Links with no elements - begin == end == 0
+        struct Links
+        {
+            Links* prev;
+            Links* next;
+            std::uint32_t begin; // the elements are in the slots [begin, end)
+            std::uint32_t end;
+        };
+
+        struct Node : Links
+        {
+            Node() noexcept
+                : Links{}
+            { }
+
+            ~Node() { }
+
+            union
+            {
+                T items[Capacity];
+            };
+        };
+
+        static std::uint32_t count(const Links* links) noexcept { return links->end - links->begin; }
+
+        // the slots of a node (not of the header)
+        static T* slots(Links* links) noexcept { return static_cast<Node*>(links)->items; }
+
+        template <bool Const>
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::bidirectional_iterator_tag;
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using reference = std::conditional_t<Const, const T&, T&>;
+            using pointer = std::conditional_t<Const, const T*, T*>;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+
+            Iterator(Links* links, std::uint32_t index) noexcept { point_to(links, index); }
+
+            Iterator(const Iterator<!Const>& other) noexcept requires Const
+                : links_{other.links_}
+                , item_{other.item_}
+            { }
+
+            reference operator*() const noexcept { return *item_; }
+
+            pointer operator->() const noexcept { return item_; }
+
+            // past the last element of a node - the first one of the next node (or the header: end());
+            // within a node a pointer is incremented & compared with the current end of the node
+            // (not one cached by the iterator - push_back & pop_back move the end of the last node)
+            Iterator& operator++() noexcept
+            {
+                if (++item_ == slots(links_) + links_->end)
+                    point_to(links_->next, links_->next->begin);
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept
+            {
+                Iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            Iterator& operator--() noexcept
+            {
+                if (!item_ || item_ == slots(links_) + links_->begin)
+                {
+                    links_ = links_->prev;
+                    item_ = slots(links_) + links_->end;
+                }
+                --item_;
+                return *this;
+            }
+
+            Iterator operator--(int) noexcept
+            {
+                Iterator it = *this;
+                --*this;
+                return it;
+            }
+
+            bool operator==(const Iterator& other) const noexcept { return item_ == other.item_; }
+
+        private:
+            friend UnrolledList;
+            friend Iterator<!Const>;
+
+            // the header (index == end == 0) - no element: end()
+            void point_to(Links* links, std::uint32_t index) noexcept
+            {
+                links_ = links;
+                item_ = index < links->end ? slots(links) + index : nullptr;
+            }
+
+            std::uint32_t index() const noexcept { return item_ ? static_cast<std::uint32_t>(item_ - slots(links_)) : 0; }
+
+            Links* links_ = nullptr;
+            T* item_ = nullptr;
+        };
+
+    public:
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr std::size_t node_capacity = Capacity;
+
+        UnrolledList() = default;
+
+        explicit UnrolledList(size_type count, const T& value = T{})
+        {
+            for (; count > 0; --count)
+                push_back(value);
+        }
+
+        template <std::input_iterator TIterator, std::sentinel_for<TIterator> TSentinel>
+        UnrolledList(TIterator first, TSentinel last)
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        UnrolledList(std::initializer_list<T> items)
+            : UnrolledList(items.begin(), items.end())
+        { }
+
+        UnrolledList(const UnrolledList& other)
+            : UnrolledList(other.begin(), other.end())
+        { }
+
+        UnrolledList(UnrolledList&& other) noexcept { take(other); }
+
+        UnrolledList& operator=(const UnrolledList& other)
+        {
+            if (this != &other)
+            {
+                UnrolledList temp{other};
+                swap(temp);
+            }
+            return *this;
+        }
+
+        UnrolledList& operator=(UnrolledList&& other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                take(other);
+            }
+            return *this;
+        }
+
+        ~UnrolledList() { clear(); }
+
+        // the nodes link to the header inside the object - they are relinked
+        void swap(UnrolledList& other) noexcept
+        {
+            UnrolledList temp;
+            temp.take(*this);
+            take(other);
+            other.take(temp);
+        }
+
+        friend void swap(UnrolledList& lhs, UnrolledList& rhs) noexcept { lhs.swap(rhs); }
+
+        size_type size() const noexcept { return size_; }
+
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+        // the number of the nodes - each takes Capacity * sizeof(T) bytes & 24 bytes of links
+        size_type nodes() const noexcept { return nodes_; }
+
+        iterator begin() noexcept { return {header_.next, header_.next->begin}; }
+
+        iterator end() noexcept { return {&header_, 0}; }
+
+        const_iterator begin() const noexcept { return {header_.next, header_.next->begin}; }
+
+        const_iterator end() const noexcept { return {const_cast<Links*>(&header_), 0}; }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+
+        reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+
+        T& front() noexcept { return *begin(); }
+
+        const T& front() const noexcept { return *begin(); }
+
+        T& back() noexcept { return *std::prev(end()); }
+
+        const T& back() const noexcept { return *std::prev(end()); }
+
+        //////////////////////////////////////////////////////////////////////
+        // both ends - nothing moves
+
+        template <typename... TArgs>
+        T& emplace_back(TArgs&&... args)
+        {
+            Links* last = header_.prev;
+            if (last == &header_ || last->end == Capacity)
+                return construct_in_new_node(&header_, 0, std::forward<TArgs>(args)...);
+
+            T& item = *std::construct_at(&static_cast<Node*>(last)->items[last->end], std::forward<TArgs>(args)...);
+            ++last->end;
+            ++size_;
+            return item;
+        }
+
+        void push_back(const T& item) { emplace_back(item); }
+
+        void push_back(T&& item) { emplace_back(std::move(item)); }
+
+        template <typename... TArgs>
+        T& emplace_front(TArgs&&... args)
+        {
+            Links* first = header_.next;
+            if (first == &header_ || first->begin == 0)
+                return construct_in_new_node(first, Capacity, std::forward<TArgs>(args)...);
+
+            T& item = *std::construct_at(&static_cast<Node*>(first)->items[first->begin - 1], std::forward<TArgs>(args)...);
+            --first->begin;
+            ++size_;
+            return item;
+        }
+
+        void push_front(const T& item) { emplace_front(item); }
+
+        void push_front(T&& item) { emplace_front(std::move(item)); }
+
+        void pop_back() noexcept
+        {
+            Node* last = static_cast<Node*>(header_.prev);
+            std::destroy_at(&last->items[--last->end]);
+            --size_;
+            if (last->begin == last->end)
+                unlink_node(last);
+        }
+
+        void pop_front() noexcept
+        {
+            Node* first = static_cast<Node*>(header_.next);
+            std::destroy_at(&first->items[first->begin++]);
+            --size_;
+            if (first->begin == first->end)
+                unlink_node(first);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // the middle
+
+        template <typename... TArgs>
+        iterator emplace(const_iterator pos, TArgs&&... args)
+        {
+            if (pos.links_ == &header_)
+            {
+                emplace_back(std::forward<TArgs>(args)...);
+                return std::prev(end());
+            }
+
+            Node* node = static_cast<Node*>(pos.links_);
+            std::uint32_t index = pos.index();
+
+            // before the first element of a node - appended to the previous node if it has room (nothing moves)
+            if (index == node->begin && node->begin == 0 && node->prev != &header_ && node->prev->end < Capacity)
+            {
+                Links* prev = node->prev;
+                std::construct_at(&static_cast<Node*>(prev)->items[prev->end], std::forward<TArgs>(args)...);
+                ++size_;
+                return {prev, prev->end++};
+            }
+
+            T item(std::forward<TArgs>(args)...); // the arguments may refer to the elements that are about to move
+
+            if (count(node) == Capacity)
+            {
+                // the upper half moved to a new node
+                constexpr std::uint32_t half = Capacity / 2;
+                Node* upper = link_node(node->next, 0);
+                std::uninitialized_move(node->items + half, node->items + Capacity, upper->items);
+                std::destroy(node->items + half, node->items + Capacity);
+                upper->end = Capacity - half;
+                node->end = half;
+
+                if (index >= half)
+                {
+                    node = upper;
+                    index -= half;
+                }
+            }
+
+            // the elements on the shorter side shifted - to the room after or before them (index is before end)
+            const std::uint32_t before = index - node->begin;
+            const std::uint32_t after = node->end - index;
+            if (node->end < Capacity && (after <= before || node->begin == 0))
+            {
+                std::construct_at(node->items + node->end, std::move(node->items[node->end - 1]));
+                std::move_backward(node->items + index, node->items + node->end - 1, node->items + node->end);
+                node->items[index] = std::move(item);
+                ++node->end;
+            }
+            else
+            {
+                if (index == node->begin)
+                    std::construct_at(node->items + index - 1, std::move(item));
+                else
+                {
+                    std::construct_at(node->items + node->begin - 1, std::move(node->items[node->begin]));
+                    std::move(node->items + node->begin + 1, node->items + index, node->items + node->begin);
+                    node->items[index - 1] = std::move(item);
+                }
+                --node->begin;
+                --index;
+            }
+
+            ++size_;
+            return {node, index};
+        }
+
+        iterator insert(const_iterator pos, const T& item) { return emplace(pos, item); }
+
+        iterator insert(const_iterator pos, T&& item) { return emplace(pos, std::move(item)); }
+
+        // returns the iterator after the erased element
+        iterator erase(const_iterator pos)
+        {
+            Node* node = static_cast<Node*>(pos.links_);
+            std::uint32_t index = pos.index();
+
+            if (index - node->begin < node->end - index - 1)
+            {
+                std::move_backward(node->items + node->begin, node->items + index, node->items + index + 1);
+                std::destroy_at(node->items + node->begin);
+                ++node->begin;
+                ++index;
+            }
+            else
+            {
+                std::move(node->items + index + 1, node->items + node->end, node->items + index);
+                std::destroy_at(node->items + node->end - 1);
+                --node->end;
+            }
+            --size_;
+
+            if (node->begin == node->end)
+            {
+                Links* next = node->next;
+                unlink_node(node);
+                return {next, next->begin};
+            }
+            return merge_sparse(node, index);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            if (first == last)
+                return {first.links_, first.index()};
+
+            auto remaining = static_cast<std::size_t>(std::ranges::distance(first, last));
+            Links* links = first.links_;
+            std::uint32_t index = first.index();
+
+            for (;;)
+            {
+                // the rest of the node (or a part of it) at once
+                Node* node = static_cast<Node*>(links);
+                const auto erased = static_cast<std::uint32_t>(std::min<std::size_t>(remaining, node->end - index));
+                std::move(node->items + index + erased, node->items + node->end, node->items + index);
+                std::destroy(node->items + node->end - erased, node->items + node->end);
+                node->end -= erased;
+                size_ -= erased;
+                remaining -= erased;
+
+                if (node->begin == node->end)
+                {
+                    links = node->next;
+                    index = links->begin;
+                    unlink_node(node);
+                    if (remaining == 0)
+                        return {links, index};
+                }
+                else if (remaining == 0)
+                    return merge_sparse(node, index);
+                else
+                {
+                    links = node->next;
+                    index = links->begin;
+                }
+            }
+        }
+
+        // the elements of every node compacted in place - no node is merged
+        template <typename TPredicate>
+        size_type remove_if(TPredicate pred)
+        {
+            size_type removed = 0;
+            for (Links* links = header_.next; links != &header_;)
+            {
+                Node* node = static_cast<Node*>(links);
+                links = node->next;
+
+                std::uint32_t kept = node->begin;
+                for (std::uint32_t i = node->begin; i < node->end; ++i)
+                {
+                    if (!std::invoke(pred, std::as_const(node->items[i])))
+                    {
+                        if (kept != i)
+                            node->items[kept] = std::move(node->items[i]);
+                        ++kept;
+                    }
+                }
+
+                removed += node->end - kept;
+                size_ -= node->end - kept;
+                std::destroy(node->items + kept, node->items + node->end);
+                node->end = kept;
+                if (node->begin == node->end)
+                    unlink_node(node);
+            }
+            return removed;
+        }
+
+        void clear() noexcept
+        {
+            for (Links* links = header_.next; links != &header_;)
+            {
+                Node* node = static_cast<Node*>(links);
+                links = node->next;
+                std::destroy(node->items + node->begin, node->items + node->end);
+                delete node;
+            }
+            reset();
+        }
+
+        friend bool operator==(const UnrolledList& lhs, const UnrolledList& rhs)
+        {
+            return lhs.size() == rhs.size() && std::ranges::equal(lhs, rhs);
+        }
+
+        friend auto operator<=>(const UnrolledList& lhs, const UnrolledList& rhs) requires std::three_way_comparable<T>
+        {
+            return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+    private:
+        // an empty node linked before next - its elements will start at slot start
+        Node* link_node(Links* next, std::uint32_t start)
+        {
+            Node* node = new Node;
+            node->begin = node->end = start;
+            node->next = next;
+            node->prev = next->prev;
+            next->prev->next = node;
+            next->prev = node;
+            ++nodes_;
+            return node;
+        }
+
+        void unlink_node(Node* node) noexcept
+        {
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+            delete node;
+            --nodes_;
+        }
+
+        // the element at the end (start == 0) or at the front (start == Capacity) of a new node
+        template <typename... TArgs>
+        T& construct_in_new_node(Links* next, std::uint32_t start, TArgs&&... args)
+        {
+            Node* node = link_node(next, start);
+            const std::uint32_t index = start == 0 ? 0 : start - 1;
+            try
+            {
+                std::construct_at(node->items + index, std::forward<TArgs>(args)...);
+            }
+            catch (...)
+            {
+                unlink_node(node);
+                throw;
+            }
+            node->begin = index;
+            node->end = index + 1;
+            ++size_;
+            return node->items[index];
+        }
+
+        // the elements of right appended to left (moved to the front of its slots first if needed)
+        void merge_nodes(Node* left, Node* right)
+        {
+            if (left->end + count(right) > Capacity)
+            {
+                const std::uint32_t size = count(left);
+                for (std::uint32_t i = 0; i < size; ++i) // the slot i is either free or moved from & destroyed already
+                {
+                    std::construct_at(left->items + i, std::move(left->items[left->begin + i]));
+                    std::destroy_at(left->items + left->begin + i);
+                }
+                left->begin = 0;
+                left->end = size;
+            }
+
+            std::uninitialized_move(right->items + right->begin, right->items + right->end, left->items + left->end);
+            std::destroy(right->items + right->begin, right->items + right->end);
+            left->end += count(right);
+            unlink_node(right);
+        }
+
+        // after an erasure: a node a quarter full is merged with a neighbour half full at most;
+        // returns the position of the element that was at index (or the one after the node)
+        iterator merge_sparse(Node* node, std::uint32_t index)
+        {
+            if (count(node) <= Capacity / 4)
+            {
+                if (node->next != &header_ && count(node->next) <= Capacity / 2)
+                {
+                    const std::uint32_t offset = index - node->begin;
+                    merge_nodes(node, static_cast<Node*>(node->next));
+                    index = node->begin + offset;
+                }
+                else if (node->prev != &header_ && count(node->prev) <= Capacity / 2)
+                {
+                    Node* prev = static_cast<Node*>(node->prev);
+                    const std::uint32_t offset = count(prev) + (index - node->begin);
+                    const bool past_node = index == node->end;
+                    Links* next = node->next;
+                    merge_nodes(prev, node);
+                    if (past_node)
+                        return {next, next->begin};
+                    node = prev;
+                    index = prev->begin + offset;
+                }
+            }
+
+            if (index == node->end)
+                return {node->next, node->next->begin};
+            return {node, index};
+        }
+
+        void reset() noexcept
+        {
+            header_.prev = header_.next = &header_;
+            size_ = 0;
+            nodes_ = 0;
+        }
+
+        // this list must be empty
+        void take(UnrolledList& other) noexcept
+        {
+            if (other.empty())
+                return;
+
+            header_.next = other.header_.next;
+            header_.prev = other.header_.prev;
+            header_.next->prev = &header_;
+            header_.prev->next = &header_;
+            size_ = other.size_;
+            nodes_ = other.nodes_;
+            other.reset();
+        }
+
+        Links header_{&header_, &header_, 0, 0};
+        size_type size_ = 0;
+        size_type nodes_ = 0;
+    };
+} // namespace Containers
+
+#endif